@@ -103,6 +103,8 @@ NB_MODULE(_benchmark, m) {
       .def("use_real_time", &Benchmark::UseRealTime, nb::rv_policy::reference)
       .def("use_manual_time", &Benchmark::UseManualTime,
            nb::rv_policy::reference)
+      .def("record_latency_distribution",
+           &Benchmark::RecordLatencyDistribution, nb::rv_policy::reference)
       .def(
           "complexity",
           (Benchmark * (Benchmark::*)(benchmark::BigO)) & Benchmark::Complexity,
@@ -21,6 +21,7 @@
 #endif
 
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -71,10 +72,18 @@ BENCHMARK_EXPORT size_t
 RunSpecifiedBenchmarks(BenchmarkReporter* display_reporter,
                        BenchmarkReporter* file_reporter, std::string spec);
 
+// Returns the number of benchmarks of the last RunSpecifiedBenchmarks() that
+// were significantly slower than the --benchmark_baseline.
+BENCHMARK_EXPORT size_t GetNumBaselineRegressions();
+
 BENCHMARK_EXPORT TimeUnit GetDefaultTimeUnit();
 
 BENCHMARK_EXPORT void SetDefaultTimeUnit(TimeUnit unit);
 
+BENCHMARK_EXPORT ThreadAffinityPolicy GetDefaultThreadAffinity();
+
+BENCHMARK_EXPORT void SetDefaultThreadAffinity(ThreadAffinityPolicy policy);
+
 BENCHMARK_EXPORT
 void AddCustomContext(std::string key, std::string value);
 
@@ -109,6 +118,10 @@ class BENCHMARK_EXPORT Benchmark {
   }
   Benchmark* Ranges(const std::vector<std::pair<int64_t, int64_t>>& ranges);
   Benchmark* ArgsProduct(const std::vector<std::vector<int64_t>>& arglists);
+  // Runs the benchmark with numbers of elements of `bytes_per_element` bytes
+  // that make working sets below, at and above the capacity of each data
+  // cache level and the TLB reach of this machine.
+  Benchmark* CacheSweep(int64_t bytes_per_element);
   Benchmark* ArgName(const std::string& name);
   Benchmark* ArgNames(const std::vector<std::string>& names);
   Benchmark* RangePair(int64_t lo1, int64_t hi1, int64_t lo2, int64_t hi2) {
@@ -132,6 +145,8 @@ class BENCHMARK_EXPORT Benchmark {
   Benchmark* MeasureProcessCPUTime();
   Benchmark* UseRealTime();
   Benchmark* UseManualTime();
+  Benchmark* UseCycleClock();
+  Benchmark* RecordLatencyDistribution();
   Benchmark* Complexity(BigO complexity = benchmark::oAuto);
   Benchmark* Complexity(BigOFunc* complexity);
   Benchmark* ComputeStatistics(const std::string& name,
@@ -142,10 +157,13 @@ class BENCHMARK_EXPORT Benchmark {
   Benchmark* DenseThreadRange(int min_threads, int max_threads, int stride = 1);
   Benchmark* ThreadPerCpu();
   Benchmark* ThreadRunner(threadrunner_factory&& factory);
+  Benchmark* ThreadAffinity(ThreadAffinityPolicy policy);
+  Benchmark* MemoryPolicy(NumaPolicy policy);
 
   virtual void Run(State& state) = 0;
 
   TimeUnit GetTimeUnit() const;
+  ThreadAffinityPolicy GetThreadAffinity() const;
 
  protected:
   explicit Benchmark(const std::string& name);
@@ -160,10 +178,21 @@ class BENCHMARK_EXPORT Benchmark {
   friend class internal::BenchmarkFamilies;
   friend class internal::BenchmarkInstance;
 
+  void ExpandCacheSweeps();
+
   std::string name_;
   internal::AggregationReportMode aggregation_report_mode_;
   std::vector<std::string> arg_names_;
   std::vector<std::vector<int64_t>> args_;
+  // The names of the working sets added by CacheSweep() and the cache levels
+  // they fit in, by index in args_.
+  std::map<size_t, std::string> working_set_names_;
+  std::map<size_t, std::string> working_set_descriptions_;
+  // The CacheSweep() calls that are not expanded yet, as the index in args_
+  // to insert the working sets at and the bytes per element. The cache sizes
+  // are only looked up once the benchmarks are listed, not during static
+  // initialization.
+  std::vector<std::pair<size_t, int64_t>> cache_sweeps_;
 
   TimeUnit time_unit_;
   bool use_default_time_unit_;
@@ -176,10 +205,15 @@ class BENCHMARK_EXPORT Benchmark {
   bool measure_process_cpu_time_;
   bool use_real_time_;
   bool use_manual_time_;
+  bool use_cycle_clock_;
+  bool record_latency_distribution_;
   BigO complexity_;
   BigOFunc* complexity_lambda_;
   std::vector<internal::Statistics> statistics_;
   std::vector<int> thread_counts_;
+  ThreadAffinityPolicy thread_affinity_;
+  bool use_default_thread_affinity_;
+  NumaPolicy memory_policy_;
 
   callback_function setup_;
   callback_function teardown_;
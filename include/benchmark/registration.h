@@ -251,7 +251,7 @@ BENCHMARK_RESTORE_COUNTER_WARNING
     if (::benchmark::ReportUnrecognizedArguments(argc, argv)) return 1; \
     ::benchmark::RunSpecifiedBenchmarks();                              \
     ::benchmark::Shutdown();                                            \
-    return 0;                                                           \
+    return ::benchmark::GetNumBaselineRegressions() > 0 ? 1 : 0;        \
   }                                                                     \
   int main(int, char**)
 
@@ -22,7 +22,9 @@
 #endif
 
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -55,10 +57,31 @@ struct BENCHMARK_EXPORT BenchmarkName {
 
 class BENCHMARK_EXPORT BenchmarkReporter {
  public:
+  // How much the timing primitives add to the times measured by a benchmark,
+  // in seconds. See --benchmark_timer_overhead.
+  struct TimerOverhead {
+    // Of every iteration of an empty `for (auto _ : state)` loop.
+    double real_time_per_iteration = 0;
+    double cpu_time_per_iteration = 0;
+    // Of every PauseTiming()/ResumeTiming() pair.
+    double real_time_per_pause = 0;
+    double cpu_time_per_pause = 0;
+  };
+
   struct Context {
     CPUInfo const& cpu_info;
     SystemInfo const& sys_info;
     size_t name_field_width = 0;
+    // The timer overhead of each way of timing: "thread_cpu_time" (the
+    // default), "process_cpu_time" (MeasureProcessCPUTime()) and
+    // "cycle_clock" (UseCycleClock()). Empty unless it was measured.
+    std::map<std::string, TimerOverhead> timer_overhead;
+    // Whether timer_overhead was subtracted from the results.
+    bool timer_overhead_subtracted = false;
+    // The performance ceilings of the machine measured by the
+    // benchmark_machine_profile tool, such as "triad_bandwidth" in bytes per
+    // second. Empty unless --benchmark_machine_profile was given.
+    std::map<std::string, double> machine_profile;
     static const char* executable_name;
     Context();
   };
@@ -87,6 +110,10 @@ class BENCHMARK_EXPORT BenchmarkReporter {
           allocs_per_iter(0.0) {}
 
     std::string benchmark_name() const;
+    // "memory" or "compute", whichever roof of the machine the run is closer
+    // to, if its bytes and flops per second were both compared with them.
+    // Empty otherwise, and for aggregates other than the mean and median.
+    std::string roofline_bound() const;
     BenchmarkName run_name;
     int64_t family_index;
     int64_t per_family_instance_index;
@@ -136,6 +163,14 @@ class BENCHMARK_EXPORT BenchmarkReporter {
   virtual void ReportRuns(const std::vector<Run>& report) = 0;
   virtual void Finalize() {}
 
+  // Called with every repetition of a benchmark as soon as it is available,
+  // before the repetitions and aggregates of that benchmark are passed to
+  // ReportRuns(). This allows following long runs live, and keeping what was
+  // measured if the process dies before a benchmark completes. Repetitions are
+  // passed here regardless of the aggregates-only settings. The default
+  // implementation does nothing.
+  virtual void ReportRepetition(const Run& /*run*/) {}
+
   // Called instead of running the benchmarks when `--benchmark_list_tests`
   // is specified, with the benchmarks that were selected to run. The default
   // implementation prints one benchmark name per line without any markup.
@@ -193,11 +228,68 @@ class BENCHMARK_EXPORT JSONReporter : public BenchmarkReporter {
   void List(
       const std::vector<internal::BenchmarkInstance>& benchmarks) override;
 
+ protected:
+  void PrintContextData(std::ostream& out, const Context& context);
+  void PrintRunData(std::ostream& out, const Run& run);
+
  private:
-  void PrintRunData(const Run& run);
   bool first_report_;
 };
 
+// Writes one JSON object per line (NDJSON): first the context, then every
+// repetition as soon as it is done, then the aggregates of each benchmark. The
+// objects have the same fields as in the JSON output, plus a "type" of either
+// "context" or "run".
+class BENCHMARK_EXPORT NDJSONReporter : public JSONReporter {
+ public:
+  bool ReportContext(const Context& context) override;
+  void ReportRepetition(const Run& run) override;
+  void ReportRuns(const std::vector<Run>& reports) override;
+  void Finalize() override {}
+  void List(
+      const std::vector<internal::BenchmarkInstance>& benchmarks) override;
+
+ private:
+  void PrintRecord(const char* type, const std::string& pretty_fields);
+};
+
+// Writes the runs in a compact binary columnar format, which is much faster
+// to write and read than JSON for very large numbers of runs. The runs are
+// written in batches, each describing its own columns; the columns have the
+// names of the fields of the JSON output. Strings are dictionary encoded. The
+// context is stored as JSON. See docs/user_guide.md for the layout, and
+// tools/gbench/util.py for a reader.
+class BENCHMARK_EXPORT ColumnarReporter : public JSONReporter {
+ public:
+  ColumnarReporter() : num_rows_(0) {}
+  bool ReportContext(const Context& context) override;
+  void ReportRuns(const std::vector<Run>& reports) override;
+  void Finalize() override;
+
+ private:
+  struct Column {
+    std::string name;
+    char type;
+    std::string validity;  // One bit per row, set if the row has a value.
+    std::string values;    // Fixed width, little-endian.
+  };
+
+  void AddRow(const Run& run);
+  Column& GetColumn(const std::string& name, char type);
+  void SetValue(const std::string& name, char type, uint64_t bits);
+  void SetInt(const std::string& name, int64_t value);
+  void SetDouble(const std::string& name, double value);
+  void SetBool(const std::string& name, bool value);
+  void SetString(const std::string& name, const std::string& value);
+  void WriteBatch();
+
+  std::vector<Column> columns_;
+  std::map<std::string, size_t> column_indices_;
+  size_t num_rows_;
+  std::map<std::string, uint32_t> dictionary_;
+  std::vector<std::string> new_dictionary_entries_;
+};
+
 class BENCHMARK_EXPORT BENCHMARK_DEPRECATED_MSG(
     "The CSV Reporter will be removed in a future release") CSVReporter
     : public BenchmarkReporter {
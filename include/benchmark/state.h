@@ -79,6 +79,21 @@ class BENCHMARK_EXPORT BENCHMARK_INTERNAL_CACHELINE_ALIGNED State {
     return 0;
   }
 
+  // Sets the floating point operations processed, reported as a rate and
+  // compared with the peak of the machine, see --benchmark_peak_flops.
+  BENCHMARK_ALWAYS_INLINE
+  void SetFlopsProcessed(int64_t flops) {
+    counters["flops_per_second"] =
+        Counter(static_cast<double>(flops), Counter::kIsRate);
+  }
+
+  BENCHMARK_ALWAYS_INLINE
+  int64_t flops_processed() const {
+    if (counters.find("flops_per_second") != counters.end())
+      return static_cast<int64_t>(counters.at("flops_per_second"));
+    return 0;
+  }
+
   BENCHMARK_ALWAYS_INLINE
   void SetComplexityN(ComplexityN complexity_n) {
     complexity_n_ = complexity_n;
@@ -125,7 +140,8 @@ class BENCHMARK_EXPORT BENCHMARK_INTERNAL_CACHELINE_ALIGNED State {
     if (BENCHMARK_BUILTIN_EXPECT(!started_, false)) {
       return 0;
     }
-    return max_iterations - total_iterations_ + batch_leftover_;
+    return max_iterations - total_iterations_ - latency_iterations_left_ +
+           batch_leftover_;
   }
 
   BENCHMARK_ALWAYS_INLINE
@@ -144,6 +160,9 @@ class BENCHMARK_EXPORT BENCHMARK_INTERNAL_CACHELINE_ALIGNED State {
  private:
   bool started_;
   bool finished_;
+  // Set when the latency of every iteration is recorded, in which case the
+  // iteration loop leaves its inlined fast path once per iteration (or batch).
+  const bool record_latency_;
   internal::Skipped skipped_;
 
   std::vector<int64_t> range_;
@@ -162,6 +181,7 @@ class BENCHMARK_EXPORT BENCHMARK_INTERNAL_CACHELINE_ALIGNED State {
 
   void StartKeepRunning();
   inline bool KeepRunningInternal(IterationCount n, bool is_batch);
+  bool KeepRunningRecordLatency(IterationCount n, bool is_batch);
   void FinishKeepRunning();
 
   const std::string name_;
@@ -173,6 +193,11 @@ class BENCHMARK_EXPORT BENCHMARK_INTERNAL_CACHELINE_ALIGNED State {
   internal::PerfCountersMeasurement* const perf_counters_measurement_;
   ProfilerManager* const profiler_manager_;
 
+  // Only used when record_latency_ is set: the iterations that are yet to be
+  // handed out, and the size of the slice that is currently running.
+  IterationCount latency_iterations_left_;
+  IterationCount latency_slice_;
+
   friend class internal::BenchmarkInstance;
 };
 
@@ -199,6 +224,10 @@ inline BENCHMARK_ALWAYS_INLINE bool State::KeepRunningInternal(IterationCount n,
       return true;
     }
   }
+  if (BENCHMARK_BUILTIN_EXPECT(record_latency_, false) &&
+      KeepRunningRecordLatency(n, is_batch)) {
+    return true;
+  }
   if (is_batch && total_iterations_ != 0) {
     batch_leftover_ = n - total_iterations_;
     total_iterations_ = 0;
@@ -223,7 +252,9 @@ struct State::StateIterator {
 
   BENCHMARK_ALWAYS_INLINE
   explicit StateIterator(State* st)
-      : cached_(st->skipped() ? 0 : st->max_iterations), parent_(st) {}
+      : cached_((st->skipped() || st->record_latency_) ? 0
+                                                       : st->max_iterations),
+        parent_(st) {}
 
  public:
   BENCHMARK_ALWAYS_INLINE
@@ -239,12 +270,19 @@ struct State::StateIterator {
   BENCHMARK_ALWAYS_INLINE
   bool operator!=(StateIterator const&) const {
     if (BENCHMARK_BUILTIN_EXPECT(cached_ != 0, true)) return true;
+    if (BENCHMARK_BUILTIN_EXPECT(parent_->record_latency_, false) &&
+        parent_->KeepRunningRecordLatency(1, /*is_batch=*/false)) {
+      cached_ = 1;
+      return true;
+    }
     parent_->FinishKeepRunning();
     return false;
   }
 
  private:
-  IterationCount cached_;
+  // Mutable so that operator!= can hand out the iterations of a latency
+  // recording run one at a time.
+  mutable IterationCount cached_;
   State* const parent_;
 };
 
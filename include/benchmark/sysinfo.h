@@ -20,9 +20,11 @@
 #pragma warning(disable : 4251)
 #endif
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
+#include "benchmark/export.h"
 #include "benchmark/macros.h"
 
 namespace benchmark {
@@ -35,13 +37,32 @@ struct BENCHMARK_EXPORT CPUInfo {
     int num_sharing;
   };
 
+  // Where a logical CPU sits in the machine. The ids are only meaningful for
+  // comparing CPUs with each other.
+  struct LogicalCPU {
+    int cpu;        // As used in affinity masks.
+    int core;       // Shared by SMT siblings.
+    int package;
+    int l2_domain;  // Shared by CPUs sharing an L2 cache, -1 if unknown.
+    int numa_node;  // -1 if unknown.
+  };
+
   enum Scaling { UNKNOWN, ENABLED, DISABLED };
 
   int num_cpus;
   Scaling scaling;
   double cycles_per_second;
   std::vector<CacheInfo> caches;
+  // The bytes of 4 KiB pages that the largest data TLB maps, 0 if unknown.
+  int64_t tlb_reach;
   std::vector<double> load_avg;
+  // The online CPUs, in increasing order. Empty where the topology cannot be
+  // queried (currently everywhere but Linux).
+  std::vector<LogicalCPU> topology;
+  // numa_distances[a][b] is the relative cost of accessing memory of NUMA
+  // node b from node a as reported by the firmware, where 10 means local. -1
+  // for nodes that do not exist. Empty where this is unknown.
+  std::vector<std::vector<int>> numa_distances;
 
   static const CPUInfo& Get();
 
@@ -45,6 +45,48 @@ using callback_function = std::function<void(const benchmark::State&)>;
 
 enum TimeUnit { kNanosecond, kMicrosecond, kMillisecond, kSecond };
 
+// How the threads of a benchmark are pinned to CPUs.
+enum ThreadAffinityPolicy {
+  // Leave the placement to the operating system.
+  kAffinityNone,
+  // Fill up the SMT siblings of a core, then the cores of a package, before
+  // moving on to the next one.
+  kAffinityCompact,
+  // Spread out over the packages first, then over the cores, and only then
+  // use SMT siblings.
+  kAffinityScatter,
+  // At most one thread per physical core.
+  kAffinityPhysicalCore,
+  // At most one thread per NUMA node.
+  kAffinityNumaNode
+};
+
+// Where the memory a benchmark allocates is placed on NUMA machines.
+struct NumaPolicy {
+  enum Mode {
+    // Whatever the process uses otherwise.
+    kDefault,
+    // On the node of the CPU that allocates it.
+    kLocal,
+    // Page by page round-robin over all nodes the process may use.
+    kInterleave,
+    // On `node` only.
+    kNode
+  };
+
+  NumaPolicy() : mode(kDefault), node(-1) {}
+
+  static NumaPolicy Local() { return NumaPolicy(kLocal, -1); }
+  static NumaPolicy Interleave() { return NumaPolicy(kInterleave, -1); }
+  static NumaPolicy Node(int n) { return NumaPolicy(kNode, n); }
+
+  Mode mode;
+  int node;  // Only used for kNode.
+
+ private:
+  NumaPolicy(Mode m, int n) : mode(m), node(n) {}
+};
+
 }  // namespace benchmark
 
 #endif  // BENCHMARK_TYPES_H_
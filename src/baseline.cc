@@ -0,0 +1,292 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "baseline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include "json_reader.h"
+#include "statistics.h"
+#include "string_util.h"
+
+namespace benchmark {
+namespace internal {
+
+namespace {
+
+// Up to this many values in the smaller sample, and without ties, the
+// distribution of U is computed exactly. Same as scipy.
+constexpr size_t kMaxExactSampleSize = 8;
+
+// Returns P(U >= u) for samples of `m` and `n` values without ties. The number
+// of orderings with a given U are the coefficients of the Gaussian binomial
+// coefficient [m + n choose m](q), which is built up as the product of
+// (1 - q^(n + k)) / (1 - q^k) for k = 1..m.
+double ExactUSurvival(size_t m, size_t n, double u) {
+  std::vector<double> counts(m * n + 1, 0.0);
+  counts[0] = 1.0;
+  for (size_t k = 1; k <= m; ++k) {
+    for (size_t i = counts.size() - 1; i >= n + k; --i) {
+      counts[i] -= counts[i - n - k];
+    }
+    for (size_t i = k; i < counts.size(); ++i) {
+      counts[i] += counts[i - k];
+    }
+  }
+  double total = 0.0;
+  double at_least_u = 0.0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    total += counts[i];
+    if (static_cast<double>(i) >= u) {
+      at_least_u += counts[i];
+    }
+  }
+  return at_least_u / total;
+}
+
+double Median(const std::vector<double>& values) {
+  return values.empty() ? 0.0 : StatisticsMedian(values);
+}
+
+double RelativeChange(const std::vector<double>& old_values,
+                      const std::vector<double>& new_values) {
+  const double old_median = Median(old_values);
+  if (old_median <= 0.0) {
+    return 0.0;
+  }
+  return (Median(new_values) - old_median) / old_median;
+}
+
+double TimeUnitToSeconds(const std::string& unit) {
+  if (unit == "s") {
+    return 1.0;
+  }
+  if (unit == "ms") {
+    return 1e-3;
+  }
+  if (unit == "us") {
+    return 1e-6;
+  }
+  if (unit == "ns") {
+    return 1e-9;
+  }
+  return 0.0;
+}
+
+const char* VerdictName(BaselineComparison::Verdict verdict) {
+  switch (verdict) {
+    case BaselineComparison::kAmbiguous:
+      return "inconclusive";
+    case BaselineComparison::kNoChange:
+      return "no significant change";
+    case BaselineComparison::kImprovement:
+      return "improvement";
+    case BaselineComparison::kRegression:
+      return "regression";
+  }
+  BENCHMARK_UNREACHABLE();
+}
+
+}  // namespace
+
+double MannWhitneyUTest(const std::vector<double>& x,
+                        const std::vector<double>& y) {
+  const size_t n1 = x.size();
+  const size_t n2 = y.size();
+  if (n1 == 0 || n2 == 0) {
+    return 1.0;
+  }
+
+  // Rank all values together, giving tied values their average rank.
+  std::vector<std::pair<double, size_t>> values;
+  values.reserve(n1 + n2);
+  for (size_t i = 0; i < n1; ++i) {
+    values.emplace_back(x[i], 0);
+  }
+  for (size_t i = 0; i < n2; ++i) {
+    values.emplace_back(y[i], 1);
+  }
+  std::sort(values.begin(), values.end());
+  double rank_sum_x = 0.0;
+  double tie_term = 0.0;
+  bool has_ties = false;
+  for (size_t i = 0; i < values.size();) {
+    size_t j = i + 1;
+    while (j < values.size() && !(values[i].first < values[j].first)) {
+      ++j;
+    }
+    has_ties |= j - i > 1;
+    const double tied = static_cast<double>(j - i);
+    const double rank = static_cast<double>(i + j + 1) / 2.0;
+    for (size_t k = i; k < j; ++k) {
+      if (values[k].second == 0) {
+        rank_sum_x += rank;
+      }
+    }
+    tie_term += tied * tied * tied - tied;
+    i = j;
+  }
+
+  const double n1d = static_cast<double>(n1);
+  const double n2d = static_cast<double>(n2);
+  const double u1 = rank_sum_x - n1d * (n1d + 1.0) / 2.0;
+  const double u = std::max(u1, n1d * n2d - u1);
+
+  double p_value = 0.0;
+  if (std::min(n1, n2) <= kMaxExactSampleSize && !has_ties) {
+    p_value = 2.0 * ExactUSurvival(std::min(n1, n2), std::max(n1, n2), u);
+  } else {
+    const double n = n1d + n2d;
+    const double sigma = std::sqrt(n1d * n2d / 12.0 *
+                                   ((n + 1.0) - tie_term / (n * (n - 1.0))));
+    const double z = (u - n1d * n2d / 2.0 - 0.5) / sigma;
+    p_value = std::erfc(z / std::sqrt(2.0));
+  }
+  return std::min(std::max(p_value, 0.0), 1.0);
+}
+
+BaselineTimes GetBaselineTimes(
+    const std::vector<BenchmarkReporter::Run>& runs) {
+  BaselineTimes times;
+  for (const BenchmarkReporter::Run& run : runs) {
+    if (run.run_type != BenchmarkReporter::Run::RT_Iteration ||
+        run.skipped != 0u || run.iterations <= 0) {
+      continue;
+    }
+    const double iterations = static_cast<double>(run.iterations);
+    times.real_time.push_back(run.real_accumulated_time / iterations);
+    times.cpu_time.push_back(run.cpu_accumulated_time / iterations);
+  }
+  return times;
+}
+
+bool Baseline::Load(const std::string& path, std::string* error) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    *error = "cannot open file";
+    return false;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return Parse(contents.str(), error);
+}
+
+bool Baseline::Parse(const std::string& json, std::string* error) {
+  JsonValue document;
+  if (!ParseJson(json, &document, error)) {
+    return false;
+  }
+  const JsonValue* benchmarks = document.Find("benchmarks");
+  if (benchmarks == nullptr || benchmarks->type != JsonValue::kArray) {
+    *error = "no \"benchmarks\" array";
+    return false;
+  }
+  times_.clear();
+  for (const JsonValue& benchmark : benchmarks->array) {
+    const JsonValue* name = benchmark.Find("name");
+    const JsonValue* run_type = benchmark.Find("run_type");
+    const JsonValue* error_occurred = benchmark.Find("error_occurred");
+    const JsonValue* skipped = benchmark.Find("skipped");
+    const JsonValue* real_time = benchmark.Find("real_time");
+    const JsonValue* cpu_time = benchmark.Find("cpu_time");
+    const JsonValue* time_unit = benchmark.Find("time_unit");
+    if (name == nullptr || name->type != JsonValue::kString ||
+        (run_type != nullptr && run_type->string == "aggregate") ||
+        (error_occurred != nullptr && error_occurred->boolean) ||
+        (skipped != nullptr && skipped->boolean) || real_time == nullptr ||
+        real_time->type != JsonValue::kNumber || cpu_time == nullptr ||
+        cpu_time->type != JsonValue::kNumber || time_unit == nullptr) {
+      continue;
+    }
+    const double multiplier = TimeUnitToSeconds(time_unit->string);
+    if (multiplier <= 0.0) {
+      continue;
+    }
+    BaselineTimes& times = times_[name->string];
+    times.real_time.push_back(real_time->number * multiplier);
+    times.cpu_time.push_back(cpu_time->number * multiplier);
+  }
+  return true;
+}
+
+const BaselineTimes* Baseline::Find(const std::string& name) const {
+  auto it = times_.find(name);
+  return it == times_.end() ? nullptr : &it->second;
+}
+
+BaselineComparison CompareToBaseline(const BaselineTimes& baseline,
+                                     const BaselineTimes& times,
+                                     bool use_real_time, double alpha) {
+  BaselineComparison comparison;
+  comparison.baseline_repetitions = baseline.real_time.size();
+  comparison.repetitions = times.real_time.size();
+  comparison.real_time_change =
+      RelativeChange(baseline.real_time, times.real_time);
+  comparison.cpu_time_change =
+      RelativeChange(baseline.cpu_time, times.cpu_time);
+  if (std::min(comparison.baseline_repetitions, comparison.repetitions) <
+      kUTestMinRepetitions) {
+    return comparison;
+  }
+
+  const std::vector<double>& old_values =
+      use_real_time ? baseline.real_time : baseline.cpu_time;
+  const std::vector<double>& new_values =
+      use_real_time ? times.real_time : times.cpu_time;
+  comparison.p_value = MannWhitneyUTest(old_values, new_values);
+  if (comparison.p_value < alpha) {
+    const double change = use_real_time ? comparison.real_time_change
+                                        : comparison.cpu_time_change;
+    comparison.verdict = change > 0 ? BaselineComparison::kRegression
+                                    : BaselineComparison::kImprovement;
+  } else if (comparison.repetitions >= kUTestOptimalRepetitions &&
+             comparison.p_value >= 4 * alpha) {
+    comparison.verdict = BaselineComparison::kNoChange;
+  }
+  return comparison;
+}
+
+BenchmarkReporter::Run CreateBaselineReport(
+    const std::vector<BenchmarkReporter::Run>& runs,
+    const BaselineComparison& comparison) {
+  BenchmarkReporter::Run report;
+  if (!runs.empty()) {
+    const BenchmarkReporter::Run& first = runs.front();
+    report.run_name = first.run_name;
+    report.family_index = first.family_index;
+    report.per_family_instance_index = first.per_family_instance_index;
+    report.threads = first.threads;
+    report.repetitions = first.repetitions;
+    report.time_unit = first.time_unit;
+  }
+  report.run_type = BenchmarkReporter::Run::RT_Aggregate;
+  report.repetition_index = BenchmarkReporter::Run::no_repetition_index;
+  report.aggregate_name = "vs_baseline";
+  report.aggregate_unit = StatisticUnit::kPercentage;
+  report.iterations = static_cast<IterationCount>(comparison.repetitions);
+  report.real_accumulated_time = comparison.real_time_change;
+  report.cpu_accumulated_time = comparison.cpu_time_change;
+  report.report_label =
+      StrFormat("%s, p=%.4f, %zu vs %zu repetitions",
+                VerdictName(comparison.verdict), comparison.p_value,
+                comparison.baseline_repetitions, comparison.repetitions);
+  return report;
+}
+
+}  // namespace internal
+}  // namespace benchmark
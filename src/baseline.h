@@ -0,0 +1,110 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_BASELINE_H_
+#define BENCHMARK_BASELINE_H_
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark/export.h"
+#include "benchmark/reporter.h"
+
+namespace benchmark {
+namespace internal {
+
+// The same limits as tools/gbench/report.py uses for its U test.
+constexpr size_t kUTestMinRepetitions = 2;
+constexpr size_t kUTestOptimalRepetitions = 9;
+
+// Returns the two-sided p-value of the Mann-Whitney U test of `x` and `y`,
+// computed like scipy.stats.mannwhitneyu(x, y, alternative="two-sided") which
+// tools/compare.py uses: exactly if one sample has at most 8 values and there
+// are no ties, and with the tie-corrected normal approximation with continuity
+// correction otherwise.
+BENCHMARK_EXPORT
+double MannWhitneyUTest(const std::vector<double>& x,
+                        const std::vector<double>& y);
+
+// The times of the successful repetitions of a benchmark, in seconds per
+// iteration.
+struct BaselineTimes {
+  std::vector<double> real_time;
+  std::vector<double> cpu_time;
+};
+
+// Returns the times of the successful repetitions in `runs`. Aggregates are
+// skipped.
+BENCHMARK_EXPORT
+BaselineTimes GetBaselineTimes(const std::vector<BenchmarkReporter::Run>& runs);
+
+// The repetitions of each benchmark in the JSON output of an earlier run.
+class BENCHMARK_EXPORT Baseline {
+ public:
+  // Reads the JSON output in `path`. On failure, returns false and describes
+  // the problem in `error`.
+  bool Load(const std::string& path, std::string* error);
+
+  // Like Load(), but from the contents of a file.
+  bool Parse(const std::string& json, std::string* error);
+
+  // Returns the times recorded for the benchmark `name`, or null if there are
+  // none.
+  const BaselineTimes* Find(const std::string& name) const;
+
+ private:
+  std::map<std::string, BaselineTimes> times_;
+};
+
+struct BaselineComparison {
+  enum Verdict {
+    // More repetitions could still change the verdict.
+    kAmbiguous,
+    kNoChange,
+    kImprovement,
+    kRegression
+  };
+
+  Verdict verdict = kAmbiguous;
+  // Of the time the benchmark is measured by, real or CPU time.
+  double p_value = 1.0;
+  // The relative change of the median times.
+  double real_time_change = 0.0;
+  double cpu_time_change = 0.0;
+  size_t baseline_repetitions = 0;
+  size_t repetitions = 0;
+};
+
+// Compares `times` with `baseline` using the U test on the real time if
+// `use_real_time`, and on the CPU time otherwise. The change is significant if
+// the p-value is below `alpha`. It is ambiguous if not, but there are fewer
+// than kUTestOptimalRepetitions repetitions or the p-value is still below
+// four times `alpha`.
+BENCHMARK_EXPORT
+BaselineComparison CompareToBaseline(const BaselineTimes& baseline,
+                                     const BaselineTimes& times,
+                                     bool use_real_time, double alpha);
+
+// Returns the aggregate reporting `comparison` for the repetitions in `runs`.
+// Its times are the relative changes, and its label the verdict.
+BenchmarkReporter::Run CreateBaselineReport(
+    const std::vector<BenchmarkReporter::Run>& runs,
+    const BaselineComparison& comparison);
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_BASELINE_H_
@@ -16,6 +16,7 @@
 #include "benchmark/registration.h"
 #include "benchmark/reporter.h"
 #include "benchmark/state.h"
+#include "benchmark/sysinfo.h"
 #include "benchmark/types.h"
 #include "benchmark_api_internal.h"
 #include "benchmark_runner.h"
@@ -26,6 +27,7 @@
     !defined(BENCHMARK_OS_WASI)
 #include <sys/resource.h>
 #endif
+#include <fcntl.h>
 #include <sys/time.h>
 #include <unistd.h>
 #endif
@@ -46,6 +48,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <limits>
 #include <map>
@@ -55,19 +58,27 @@
 #include <thread>
 #include <utility>
 
+#include "baseline.h"
 #include "check.h"
+#include "checkpoint.h"
 #include "colorprint.h"
 #include "commandlineflags.h"
 #include "complexity.h"
 #include "counter.h"
+#include "cpu_affinity.h"
 #include "log.h"
+#include "machine_profile.h"
 #include "mutex.h"
 #include "perf_counters.h"
+#include "perf_metrics.h"
+#include "process_isolation.h"
 #include "re.h"
+#include "roofline.h"
 #include "statistics.h"
 #include "string_util.h"
 #include "thread_manager.h"
 #include "thread_timer.h"
+#include "timer_overhead.h"
 
 namespace benchmark {
 // Print a list of benchmarks. This option overrides all other options.
@@ -101,6 +112,19 @@ BM_DEFINE_string(benchmark_min_time, kDefaultMinTimeStr);
 // reported result.
 BM_DEFINE_double(benchmark_min_warmup_time, 0.0);
 
+// If greater than zero, each repetition is measured as a sequence of short
+// sub-batches, and more sub-batches are run until the 95% confidence interval
+// of the per-iteration time is within this fraction of its mean (e.g. 0.01
+// for +/-1%), or until benchmark_max_time has elapsed. Stable benchmarks then
+// finish well before benchmark_min_time, while noisy ones get more samples.
+// Has no effect on benchmarks with an explicit iteration count. Repetitions
+// after the first run as many sub-batches as the first.
+BM_DEFINE_double(benchmark_target_rel_error, 0.0);
+
+// Upper bound on the number of seconds a single repetition may spend trying to
+// reach benchmark_target_rel_error. Must be positive.
+BM_DEFINE_double(benchmark_max_time, 5.0);
+
 // The number of runs of each benchmark. If greater than 1, the mean and
 // standard deviation of the runs will be reported.
 BM_DEFINE_int32(benchmark_repetitions, 1);
@@ -114,6 +138,17 @@ BM_DEFINE_bool(benchmark_dry_run, false);
 // See http://github.com/google/benchmark/issues/1051 for details.
 BM_DEFINE_bool(benchmark_enable_random_interleaving, false);
 
+// The number of single-threaded benchmark instances to run at the same time.
+// Each one is pinned to its own CPU, chosen such that no two of them share a
+// physical core or an L2 cache. Results are still reported in the usual order.
+BM_DEFINE_int32(benchmark_parallel_instances, 1);
+
+// How benchmark instances are isolated from each other. Valid values are
+// 'none', where all of them run in this process, and 'process', where each
+// instance runs in a freshly forked child process, so that it does not see
+// the heap, caches or static state left behind by the instances before it.
+BM_DEFINE_string(benchmark_isolation, "none");
+
 // Report the result of each benchmark repetitions. When 'true' is specified
 // only the mean, standard deviation, and other statistics are reported for
 // repeated benchmarks. Affects all reporters.
@@ -127,16 +162,47 @@ BM_DEFINE_bool(benchmark_report_aggregates_only, false);
 BM_DEFINE_bool(benchmark_display_aggregates_only, false);
 
 // The format to use for console output.
-// Valid values are 'console', 'json', or 'csv'.
+// Valid values are 'console', 'json', 'ndjson', or 'csv'.
 BM_DEFINE_string(benchmark_format, "console");
 
 // The format to use for file output.
-// Valid values are 'console', 'json', or 'csv'.
+// Valid values are 'console', 'json', 'ndjson', 'columnar', or 'csv'. With
+// 'ndjson', the file is synced to disk after every record.
 BM_DEFINE_string(benchmark_out_format, "json");
 
 // The file to write additional output to.
 BM_DEFINE_string(benchmark_out, "");
 
+// A file recording the runs of completed repetitions as they finish. If it
+// already exists, benchmark instances that an earlier, interrupted invocation
+// completed are not run again, and their recorded runs are reported instead.
+// The file is deleted once all benchmarks have been reported.
+BM_DEFINE_string(benchmark_checkpoint, "");
+
+// The JSON output of an earlier run to compare the repetitions of every
+// benchmark with, using the Mann-Whitney U test as tools/compare.py does. The
+// comparison is reported as a 'vs_baseline' aggregate, and the benchmark
+// binary exits with a nonzero code if any benchmark got significantly slower.
+BM_DEFINE_string(benchmark_baseline, "");
+
+// The machine profile written by the benchmark_machine_profile tool, whose
+// performance ceilings are added to the context of the reports.
+BM_DEFINE_string(benchmark_machine_profile, "");
+
+// The peak memory bandwidth in bytes per second and the peak floating point
+// operations per second of the machine, which the bytes and flops processed by
+// the benchmarks are compared with. If not set, the ceilings in
+// benchmark_machine_profile are used.
+BM_DEFINE_double(benchmark_peak_bandwidth, 0.0);
+BM_DEFINE_double(benchmark_peak_flops, 0.0);
+
+// The significance level of the comparison with benchmark_baseline.
+BM_DEFINE_double(benchmark_baseline_alpha, 0.05);
+
+// While the comparison of a benchmark with benchmark_baseline is inconclusive,
+// more repetitions of it are run, up to this many in total.
+BM_DEFINE_int32(benchmark_baseline_max_repetitions, 30);
+
 // Whether to use colors in the output.  Valid values:
 // 'true'/'yes'/1, 'false'/'no'/0, and 'auto'. 'auto' means to use colors if
 // the output is being sent to a terminal and the TERM environment variable is
@@ -147,10 +213,51 @@ BM_DEFINE_string(benchmark_color, "auto");
 // Valid values: 'true'/'yes'/1, 'false'/'no'/0.  Defaults to false.
 BM_DEFINE_bool(benchmark_counters_tabular, false);
 
+// If enabled, multi-threaded benchmarks report how much later than the first
+// thread the last thread started measuring, in seconds, as a 'release_skew'
+// counter. Any such skew adds to the real time of the benchmark.
+BM_DEFINE_bool(benchmark_report_release_skew, false);
+
+// What to do about the cost of the timing primitives themselves, i.e. of an
+// empty benchmark loop and of a PauseTiming/ResumeTiming pair, which is
+// included in every measurement. Valid values are 'none', 'report', where it
+// is measured at startup and reported in the context, and 'subtract', where it
+// is also subtracted from the real and CPU times of every benchmark.
+BM_DEFINE_string(benchmark_timer_overhead, "none");
+
 // List of additional perf counters to collect, in libpfm format. For more
 // information about libpfm: https://man7.org/linux/man-pages/man3/libpfm.3.html
 BM_DEFINE_string(benchmark_perf_counters, "");
 
+// If enabled, multi-threaded benchmarks also report the perf counters of each
+// thread, per iteration of that thread, as counters named like
+// 'CYCLES/thread:1'.
+BM_DEFINE_bool(benchmark_perf_counters_per_thread, false);
+
+// If enabled, perf counters that the PMU cannot count all at once are split
+// into groups that can, and the repetitions of each benchmark count the groups
+// in turn. Otherwise the kernel multiplexes them, and their counts are scaled
+// from the part of the run they were counting.
+BM_DEFINE_bool(benchmark_perf_counters_rotate, false);
+
+// List of metrics to derive from perf counters, such as 'ipc' or 'tma', or
+// 'all'. The events they need on this CPU are counted in addition to
+// benchmark_perf_counters, but not reported themselves.
+BM_DEFINE_string(benchmark_perf_metrics, "");
+
+// Whether to track the effective clock of the CPU while running each
+// benchmark, which turbo and thermal throttling change, from the CYCLES perf
+// counter. Valid values are 'none', 'report', where it is reported as a
+// 'cpu_frequency' counter, and 'cycles', where the cycles per iteration are
+// also reported, as 'cycles_per_iteration', to compare runs at different
+// clocks.
+BM_DEFINE_string(benchmark_cpu_frequency, "none");
+
+// If enabled, each benchmark is run once more while its call stacks are
+// sampled, and the folded stacks are written next to benchmark_out, to
+// '<benchmark_out>.<benchmark name>.folded'.
+BM_DEFINE_bool(benchmark_sample_profile, false);
+
 // Extra context to include in the output formatted as comma-separated key-value
 // pairs. Kept internal as it's only used for parsing from env/command line.
 BM_DEFINE_kvpairs(benchmark_context, {});
@@ -159,6 +266,10 @@ BM_DEFINE_kvpairs(benchmark_context, {});
 // Valid values are 'ns', 'us', 'ms' or 's'
 BM_DEFINE_string(benchmark_time_unit, "");
 
+// Set the default policy for pinning benchmark threads to CPUs. Valid values
+// are 'none', 'compact', 'scatter', 'physical_core' and 'numa_node'.
+BM_DEFINE_string(benchmark_affinity, "");
+
 // The level of verbose logging to output
 BM_DEFINE_int32(v, 0);
 
@@ -197,6 +308,8 @@ State::State(std::string name, IterationCount max_iters,
       max_iterations(max_iters),
       started_(false),
       finished_(false),
+      record_latency_(timer != nullptr &&
+                      timer->latency_histogram() != nullptr),
       skipped_(internal::NotSkipped),
       range_(ranges),
       complexity_n_(0),
@@ -206,7 +319,9 @@ State::State(std::string name, IterationCount max_iters,
       timer_(timer),
       manager_(manager),
       perf_counters_measurement_(perf_counters_measurement),
-      profiler_manager_(profiler_manager) {
+      profiler_manager_(profiler_manager),
+      latency_iterations_left_(0),
+      latency_slice_(0) {
   BM_CHECK(max_iterations != 0) << "At least one iteration must be run";
   BM_CHECK_LT(thread_index_, threads_)
       << "thread_index must be less than threads";
@@ -289,14 +404,9 @@ void State::ResumeTiming() {
 
 void State::SkipWithMessage(const std::string& msg) {
   skipped_ = internal::SkippedWithMessage;
-  {
-    MutexLock l(manager_->GetBenchmarkMutex());
-    if (internal::NotSkipped == manager_->results.skipped_) {
-      manager_->results.skip_message_ = msg;
-      manager_->results.skipped_ = skipped_;
-    }
-  }
+  manager_->Skip(skipped_, msg);
   total_iterations_ = 0;
+  latency_iterations_left_ = 0;
   if (timer_->running()) {
     timer_->StopTimer();
   }
@@ -304,14 +414,9 @@ void State::SkipWithMessage(const std::string& msg) {
 
 void State::SkipWithError(const std::string& msg) {
   skipped_ = internal::SkippedWithError;
-  {
-    MutexLock l(manager_->GetBenchmarkMutex());
-    if (internal::NotSkipped == manager_->results.skipped_) {
-      manager_->results.skip_message_ = msg;
-      manager_->results.skipped_ = skipped_;
-    }
-  }
+  manager_->Skip(skipped_, msg);
   total_iterations_ = 0;
+  latency_iterations_left_ = 0;
   if (timer_->running()) {
     timer_->StopTimer();
   }
@@ -322,23 +427,50 @@ void State::SetIterationTime(double seconds) {
 }
 
 void State::SetLabel(const std::string& label) {
-  MutexLock l(manager_->GetBenchmarkMutex());
-  manager_->results.report_label_ = label;
+  manager_->SetLabel(thread_index_, label);
 }
 
 void State::StartKeepRunning() {
   BM_CHECK(!started_ && !finished_);
   started_ = true;
   total_iterations_ = skipped() ? 0 : max_iterations;
+  if (record_latency_) {
+    // Keep the inlined fast path from handing out iterations, so that every
+    // iteration (or batch) goes through KeepRunningRecordLatency().
+    latency_iterations_left_ = total_iterations_;
+    total_iterations_ = 0;
+  }
   if (BENCHMARK_BUILTIN_EXPECT(profiler_manager_ != nullptr, false)) {
     profiler_manager_->AfterSetupStart();
   }
-  manager_->StartStopBarrier();
+  manager_->StartBarrier(thread_index_);
   if (!skipped()) {
     ResumeTiming();
   }
 }
 
+bool State::KeepRunningRecordLatency(IterationCount n, bool is_batch) {
+  assert(record_latency_);
+  if (skipped()) {
+    return false;
+  }
+  // Closes the slice handed out by the previous call, if any.
+  timer_->MarkIterations(latency_slice_);
+  latency_slice_ = 0;
+  if (latency_iterations_left_ >= n) {
+    latency_iterations_left_ -= n;
+    latency_slice_ = n;
+    return true;
+  }
+  if (is_batch && latency_iterations_left_ != 0) {
+    batch_leftover_ = n - latency_iterations_left_;
+    latency_iterations_left_ = 0;
+    latency_slice_ = n;
+    return true;
+  }
+  return false;
+}
+
 void State::FinishKeepRunning() {
   BM_CHECK(started_ && (!finished_ || skipped()));
   if (!skipped()) {
@@ -393,9 +525,199 @@ void Report(BenchmarkReporter* display_reporter,
   FlushStreams(file_reporter);
 }
 
+// Returns the CPUs to run benchmark instances on in parallel, or an empty
+// vector if they should be run one after the other.
+std::vector<int> GetParallelInstanceCPUs(bool have_perf_counters) {
+  if (FLAGS_benchmark_parallel_instances <= 1 || FLAGS_benchmark_dry_run) {
+    return {};
+  }
+  // These all measure the whole process or use process-wide state.
+  if (have_perf_counters || memory_manager != nullptr ||
+      profiler_manager != nullptr) {
+    GetErrorLogInstance() << "***WARNING*** --benchmark_parallel_instances "
+                             "is ignored when perf counters, a memory manager "
+                             "or a profiler manager are used.\n";
+    return {};
+  }
+  if (FLAGS_benchmark_enable_random_interleaving ||
+      FLAGS_benchmark_isolation == "process") {
+    GetErrorLogInstance() << "***WARNING*** --benchmark_parallel_instances "
+                             "is ignored with random interleaving or process "
+                             "isolation.\n";
+    return {};
+  }
+  const size_t requested =
+      static_cast<size_t>(FLAGS_benchmark_parallel_instances);
+  std::vector<int> cpus =
+      PickIsolatedCPUs(CPUInfo::Get().topology, GetAllowedCPUs(), requested);
+  if (cpus.size() < 2) {
+    GetErrorLogInstance() << "***WARNING*** Not enough isolated CPUs for "
+                             "--benchmark_parallel_instances, running "
+                             "benchmarks one at a time.\n";
+    return {};
+  }
+  if (cpus.size() < requested) {
+    GetErrorLogInstance() << "***WARNING*** Only " << cpus.size()
+                          << " CPUs not sharing a core or L2 cache are "
+                             "available, running that many benchmarks at a "
+                             "time.\n";
+  }
+  return cpus;
+}
+
+bool UseProcessIsolation() {
+  if (FLAGS_benchmark_isolation != "process") {
+    return false;
+  }
+  if (!ProcessIsolationSupported()) {
+    GetErrorLogInstance() << "***WARNING*** --benchmark_isolation=process is "
+                             "not supported on this platform.\n";
+    return false;
+  }
+  if (FLAGS_benchmark_enable_random_interleaving) {
+    GetErrorLogInstance() << "***WARNING*** Random interleaving is ignored "
+                             "with --benchmark_isolation=process.\n";
+  }
+  return true;
+}
+
+// Only single-threaded benchmarks can be run next to each other. Complexity
+// families are excluded too, as their runners share the per-family reports,
+// and so is the process CPU time, which would include the other instances.
+bool CanRunInParallel(const BenchmarkInstance& b) {
+  return b.threads() == 1 && b.complexity() == oNone &&
+         !b.GetUserThreadRunnerFactory() && b.affinity_cpus().empty() &&
+         !b.measure_process_cpu_time();
+}
+
+// Runs all repetitions of the runners on one worker thread per CPU in `cpus`,
+// each pinned to its CPU. Runners that cannot share the machine are run on
+// their own once all runners before them are done. `report` is called on the
+// calling thread for each runner, in order, as soon as the runner and all
+// runners before it are done.
+void RunInstancesInParallel(
+    std::vector<BenchmarkRunner>& runners, const std::vector<int>& cpus,
+    const std::function<void(BenchmarkRunner&)>& report) {
+  size_t first = 0;
+  while (first < runners.size()) {
+    if (!CanRunInParallel(runners[first].GetBenchmarkInstance())) {
+      BenchmarkRunner& runner = runners[first++];
+      while (runner.HasRepeatsRemaining()) {
+        runner.DoOneRepetition();
+      }
+      report(runner);
+      continue;
+    }
+    size_t last = first;
+    while (last < runners.size() &&
+           CanRunInParallel(runners[last].GetBenchmarkInstance())) {
+      ++last;
+    }
+
+    Mutex mu;
+    Condition done_cv;
+    size_t next = first;
+    std::vector<bool> done(last - first, false);
+    auto worker = [&](int cpu) {
+      if (!PinCurrentThreadToCPU(cpu)) {
+        BM_VLOG(1) << "Failed to pin worker to CPU " << cpu << "\n";
+      }
+      for (;;) {
+        size_t index = 0;
+        {
+          MutexLock l(mu);
+          if (next == last) {
+            return;
+          }
+          index = next++;
+        }
+        BenchmarkRunner& runner = runners[index];
+        while (runner.HasRepeatsRemaining()) {
+          runner.DoOneRepetition();
+        }
+        {
+          MutexLock l(mu);
+          done[index - first] = true;
+        }
+        done_cv.notify_all();
+      }
+    };
+
+    std::vector<std::thread> workers;
+    const size_t num_workers = std::min(cpus.size(), last - first);
+    workers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+      workers.emplace_back(worker, cpus[i]);
+    }
+    for (size_t index = first; index < last; ++index) {
+      {
+        MutexLock l(mu);
+        done_cv.wait(l.native_handle(),
+                     [&]() { return done[index - first]; });
+      }
+      report(runners[index]);
+    }
+    for (std::thread& t : workers) {
+      t.join();
+    }
+    first = last;
+  }
+}
+
+// Adds the CPUs that pinned benchmarks run on to the context, one entry per
+// policy and thread count.
+void AddThreadAffinityContext(
+    const std::vector<BenchmarkInstance>& benchmarks) {
+  bool warned_unsupported = false;
+  for (const BenchmarkInstance& benchmark : benchmarks) {
+    if (benchmark.affinity_cpus().empty()) {
+      if (benchmark.thread_affinity() != kAffinityNone &&
+          !benchmark.GetUserThreadRunnerFactory() && !warned_unsupported) {
+        GetErrorLogInstance() << "***WARNING*** Thread affinity is not "
+                                 "supported on this platform, benchmark "
+                                 "threads are not pinned.\n";
+        warned_unsupported = true;
+      }
+      continue;
+    }
+    const std::vector<int>& cpus = benchmark.affinity_cpus();
+    if (static_cast<size_t>(benchmark.threads()) > cpus.size()) {
+      GetErrorLogInstance()
+          << "***WARNING*** " << benchmark.name().str() << " runs "
+          << benchmark.threads() << " threads on only " << cpus.size()
+          << " CPUs picked by the "
+          << ThreadAffinityPolicyName(benchmark.thread_affinity())
+          << " affinity policy.\n";
+    }
+    std::string value;
+    for (int cpu : cpus) {
+      if (!value.empty()) {
+        value += ',';
+      }
+      value += std::to_string(cpu);
+    }
+    if (global_context == nullptr) {
+      global_context = new std::map<std::string, std::string>();
+    }
+    (*global_context)[StrFormat(
+        "thread_affinity/%s/threads:%d",
+        ThreadAffinityPolicyName(benchmark.thread_affinity()),
+        benchmark.threads())] = value;
+  }
+}
+
+// The number of benchmarks of the last run that got significantly slower than
+// the baseline.
+size_t num_baseline_regressions = 0;
+
+// `sync_file_output`, if set, is called after every record written to the
+// file reporter.
 void RunBenchmarks(const std::vector<BenchmarkInstance>& benchmarks,
                    BenchmarkReporter* display_reporter,
-                   BenchmarkReporter* file_reporter) {
+                   BenchmarkReporter* file_reporter,
+                   const std::function<void()>& sync_file_output,
+                   Checkpoint* checkpoint, const Baseline* baseline,
+                   const MachineProfile* machine_profile) {
   // Note the file_reporter can be null.
   BM_CHECK(display_reporter != nullptr);
 
@@ -416,9 +738,19 @@ void RunBenchmarks(const std::vector<BenchmarkInstance>& benchmarks,
     name_field_width += 1 + stat_field_width;
   }
 
+  AddThreadAffinityContext(benchmarks);
+
   // Print header here
   BenchmarkReporter::Context context;
   context.name_field_width = name_field_width;
+  if (FLAGS_benchmark_timer_overhead != "none") {
+    context.timer_overhead = GetTimerOverhead();
+    context.timer_overhead_subtracted =
+        FLAGS_benchmark_timer_overhead == "subtract";
+  }
+  if (machine_profile != nullptr) {
+    context.machine_profile = machine_profile->values();
+  }
 
   // Keep track of running times of all instances of each benchmark family.
   std::map<int /*family_index*/, BenchmarkReporter::PerFamilyRunReports>
@@ -433,25 +765,44 @@ void RunBenchmarks(const std::vector<BenchmarkInstance>& benchmarks,
 
     // This perfcounters object needs to be created before the runners vector
     // below so it outlasts their lifetime.
-    PerfCountersMeasurement perfcounters(
-        StrSplit(FLAGS_benchmark_perf_counters, ','));
+    std::vector<std::string> counter_names =
+        StrSplit(FLAGS_benchmark_perf_counters, ',');
+    std::vector<std::string> metric_names =
+        StrSplit(FLAGS_benchmark_perf_metrics, ',');
+    if (FLAGS_benchmark_cpu_frequency != "none") {
+      metric_names.push_back("frequency");
+    }
+    if (FLAGS_benchmark_cpu_frequency == "cycles") {
+      metric_names.push_back("cycles");
+    }
+    const PerfMetrics perf_metrics =
+        PerfMetrics::Create(metric_names, counter_names,
+                            PerfCounters::IsCounterSupported);
+    counter_names.insert(counter_names.end(), perf_metrics.events().begin(),
+                         perf_metrics.events().end());
+    PerfCountersMeasurement perfcounters(counter_names);
+    if (FLAGS_benchmark_perf_counters_rotate) {
+      perfcounters.SplitIntoGroups();
+    }
+    const Roofline roofline = Roofline::Create(
+        FLAGS_benchmark_peak_bandwidth, FLAGS_benchmark_peak_flops,
+        machine_profile != nullptr ? machine_profile->values()
+                                   : std::map<std::string, double>());
 
     // Vector of benchmarks to run
     std::vector<internal::BenchmarkRunner> runners;
     runners.reserve(benchmarks.size());
 
-    // Count the number of benchmarks with threads to warn the user in case
-    // performance counters are used.
-    int benchmarks_with_threads = 0;
-
     // Loop through all benchmarks
     for (const BenchmarkInstance& benchmark : benchmarks) {
       BenchmarkReporter::PerFamilyRunReports* reports_for_family = nullptr;
       if (benchmark.complexity() != oNone) {
         reports_for_family = &per_family_reports[benchmark.family_index()];
       }
-      benchmarks_with_threads += static_cast<int>(benchmark.threads() > 1);
-      runners.emplace_back(benchmark, &perfcounters, reports_for_family);
+      runners.emplace_back(benchmark, &perfcounters,
+                           perf_metrics.empty() ? nullptr : &perf_metrics,
+                           roofline.empty() ? nullptr : &roofline,
+                           reports_for_family);
       int num_repeats_of_this_instance = runners.back().GetNumRepeats();
       num_repetitions_total +=
           static_cast<size_t>(num_repeats_of_this_instance);
@@ -461,41 +812,149 @@ void RunBenchmarks(const std::vector<BenchmarkInstance>& benchmarks,
     }
     assert(runners.size() == benchmarks.size() && "Unexpected runner count.");
 
-    // The use of performance counters with threads would be unintuitive for
-    // the average user so we need to warn them about this case
-    if ((benchmarks_with_threads > 0) && (perfcounters.num_counters() > 0)) {
-      GetErrorLogInstance()
-          << "***WARNING*** There are " << benchmarks_with_threads
-          << " benchmarks with threads and " << perfcounters.num_counters()
-          << " performance counters were requested. Beware counters will "
-             "reflect the combined usage across all "
-             "threads.\n";
-    }
-
-    std::vector<size_t> repetition_indices;
-    repetition_indices.reserve(num_repetitions_total);
-    for (size_t runner_index = 0, num_runners = runners.size();
-         runner_index != num_runners; ++runner_index) {
-      const internal::BenchmarkRunner& runner = runners[runner_index];
-      std::fill_n(std::back_inserter(repetition_indices),
-                  runner.GetNumRepeats(), runner_index);
+    if (perfcounters.num_groups() > 1) {
+      const int num_groups = static_cast<int>(perfcounters.num_groups());
+      int benchmarks_missing_groups = 0;
+      for (const internal::BenchmarkRunner& runner : runners) {
+        benchmarks_missing_groups +=
+            static_cast<int>(runner.GetNumRepeats() < num_groups);
+      }
+      if (benchmarks_missing_groups > 0) {
+        GetErrorLogInstance()
+            << "***WARNING*** The performance counters are split into "
+            << num_groups << " groups, one per repetition, but "
+            << benchmarks_missing_groups
+            << " benchmarks have fewer repetitions. Some counters will be "
+               "missing from their results.\n";
+      }
     }
-    assert(repetition_indices.size() == num_repetitions_total &&
-           "Unexpected number of repetition indexes.");
 
-    if (FLAGS_benchmark_enable_random_interleaving) {
-      std::random_device rd;
-      std::mt19937 g(rd());
-      std::shuffle(repetition_indices.begin(), repetition_indices.end(), g);
+    // Instances completed by an earlier, interrupted invocation are not run
+    // again.
+    std::vector<bool> restored(runners.size(), false);
+    if (checkpoint != nullptr) {
+      size_t num_restored = 0;
+      for (size_t i = 0; i < runners.size(); ++i) {
+        internal::BenchmarkRunner& runner = runners[i];
+        const BenchmarkInstance& benchmark = runner.GetBenchmarkInstance();
+        std::vector<BenchmarkReporter::Run> runs;
+        if (checkpoint->TakeRuns(benchmark.name().str(),
+                                 benchmark.family_index(),
+                                 benchmark.per_family_instance_index(),
+                                 runner.GetNumRepeats(), &runs)) {
+          runner.AdoptRuns(std::move(runs), "");
+          restored[i] = true;
+          ++num_restored;
+          // It still takes one turn below to be reported.
+          num_repetitions_total -=
+              static_cast<size_t>(runner.GetNumRepeats() - 1);
+        }
+      }
+      if (num_restored > 0) {
+        BM_VLOG(0) << "Resuming from checkpoint '" << checkpoint->path()
+                   << "': " << num_restored << " of " << runners.size()
+                   << " benchmarks are already done\n";
+      }
+      if (!checkpoint->Start()) {
+        GetErrorLogInstance()
+            << "***WARNING*** Failed to write checkpoint '"
+            << checkpoint->path() << "', runs will not be recorded\n";
+        checkpoint = nullptr;
+      }
     }
 
-    for (size_t repetition_index : repetition_indices) {
-      internal::BenchmarkRunner& runner = runners[repetition_index];
-      runner.DoOneRepetition();
-      if (runner.HasRepeatsRemaining()) {
-        continue;
+    // How many runs of each runner were passed to ReportRepetition() so far.
+    std::vector<size_t> num_runs_streamed(runners.size());
+    auto stream_runs = [&](const internal::BenchmarkRunner& runner) {
+      const size_t runner_index = static_cast<size_t>(&runner - runners.data());
+      const std::vector<BenchmarkReporter::Run>& runs = runner.GetRuns();
+      size_t& num_streamed = num_runs_streamed[runner_index];
+      if (num_streamed == runs.size()) {
+        return;
+      }
+      for (; num_streamed < runs.size(); ++num_streamed) {
+        if (checkpoint != nullptr && !restored[runner_index]) {
+          checkpoint->Record(runs[num_streamed]);
+        }
+        display_reporter->ReportRepetition(runs[num_streamed]);
+        if (file_reporter != nullptr) {
+          file_reporter->ReportRepetition(runs[num_streamed]);
+        }
+      }
+      FlushStreams(display_reporter);
+      FlushStreams(file_reporter);
+      if (sync_file_output) {
+        sync_file_output();
       }
-      // FIXME: report each repetition separately, not all of them in bulk.
+    };
+
+    const bool isolate_processes = UseProcessIsolation();
+    const std::vector<int> parallel_cpus =
+        GetParallelInstanceCPUs(perfcounters.num_counters() > 0);
+
+    // Compares the repetitions of `runner` with the baseline, running more of
+    // them while the outcome is inconclusive. In parallel mode other instances
+    // are still running, so no repetitions are added then.
+    std::vector<std::string> regressions;
+    auto compare_to_baseline = [&](internal::BenchmarkRunner& runner,
+                                   BaselineComparison* comparison) {
+      const BenchmarkInstance& benchmark = runner.GetBenchmarkInstance();
+      const BaselineTimes* baseline_times =
+          baseline->Find(benchmark.name().str());
+      if (baseline_times == nullptr) {
+        return false;
+      }
+      const bool use_real_time =
+          benchmark.use_real_time() || benchmark.use_manual_time();
+      for (;;) {
+        const BaselineTimes times = GetBaselineTimes(runner.GetRuns());
+        *comparison =
+            CompareToBaseline(*baseline_times, times, use_real_time,
+                              FLAGS_benchmark_baseline_alpha);
+        const int remaining =
+            FLAGS_benchmark_baseline_max_repetitions - runner.GetNumRepeats();
+        // More repetitions do not help if the baseline is too small or the
+        // benchmark fails.
+        if (comparison->verdict != BaselineComparison::kAmbiguous ||
+            !parallel_cpus.empty() || remaining <= 0 ||
+            baseline_times->real_time.size() < kUTestMinRepetitions ||
+            times.real_time.size() != runner.GetRuns().size()) {
+          break;
+        }
+        // At least double the repetitions, as the p-value of the U test
+        // only changes slowly with more of them.
+        runner.AddRepetitions(std::min(
+            remaining,
+            std::max(runner.GetNumRepeats(),
+                     static_cast<int>(kUTestOptimalRepetitions) -
+                         runner.GetNumRepeats())));
+        if (isolate_processes) {
+          RunInChildProcess(runner, &perfcounters);
+        }
+        while (runner.HasRepeatsRemaining()) {
+          runner.DoOneRepetition();
+          stream_runs(runner);
+        }
+        stream_runs(runner);
+      }
+      if (comparison->verdict == BaselineComparison::kRegression) {
+        regressions.push_back(StrFormat(
+            "%s (%+.2f%% real time, %+.2f%% CPU time)",
+            benchmark.name().str().c_str(),
+            100. * comparison->real_time_change,
+            100. * comparison->cpu_time_change));
+      }
+      return true;
+    };
+
+    auto report_runner = [&](internal::BenchmarkRunner& runner) {
+      // Repetitions that were not run here, e.g. those of a child process,
+      // are only streamed now.
+      stream_runs(runner);
+
+      BaselineComparison comparison;
+      const bool compared =
+          baseline != nullptr && compare_to_baseline(runner, &comparison);
 
       display_reporter->ReportRunsConfig(
           runner.GetMinTime(), runner.HasExplicitIters(), runner.GetIters());
@@ -519,8 +978,70 @@ void RunBenchmarks(const std::vector<BenchmarkInstance>& benchmarks,
         }
       }
 
+      if (compared) {
+        run_results.aggregates_only.push_back(
+            CreateBaselineReport(run_results.non_aggregates, comparison));
+      }
+
       Report(display_reporter, file_reporter, run_results);
+      if (sync_file_output) {
+        sync_file_output();
+      }
+    };
+
+    if (isolate_processes) {
+      for (internal::BenchmarkRunner& runner : runners) {
+        if (runner.HasRepeatsRemaining()) {
+          RunInChildProcess(runner, &perfcounters);
+        }
+        report_runner(runner);
+      }
+    } else if (!parallel_cpus.empty()) {
+      RunInstancesInParallel(runners, parallel_cpus, report_runner);
+    } else {
+      std::vector<size_t> repetition_indices;
+      repetition_indices.reserve(num_repetitions_total);
+      for (size_t runner_index = 0, num_runners = runners.size();
+           runner_index != num_runners; ++runner_index) {
+        const internal::BenchmarkRunner& runner = runners[runner_index];
+        std::fill_n(std::back_inserter(repetition_indices),
+                    restored[runner_index] ? 1 : runner.GetNumRepeats(),
+                    runner_index);
+      }
+      assert(repetition_indices.size() == num_repetitions_total &&
+             "Unexpected number of repetition indexes.");
+
+      if (FLAGS_benchmark_enable_random_interleaving) {
+        std::random_device rd;
+        std::mt19937 g(rd());
+        std::shuffle(repetition_indices.begin(), repetition_indices.end(), g);
+      }
+
+      for (size_t repetition_index : repetition_indices) {
+        internal::BenchmarkRunner& runner = runners[repetition_index];
+        if (runner.HasRepeatsRemaining()) {
+          runner.DoOneRepetition();
+          stream_runs(runner);
+        }
+        if (runner.HasRepeatsRemaining()) {
+          continue;
+        }
+        report_runner(runner);
+      }
+    }
+
+    num_baseline_regressions = regressions.size();
+    if (!regressions.empty()) {
+      GetErrorLogInstance()
+          << "***WARNING*** " << regressions.size()
+          << " benchmarks are significantly slower than the baseline:\n";
+      for (const std::string& regression : regressions) {
+        GetErrorLogInstance() << "  " << regression << "\n";
+      }
     }
+  } else {
+    // Nothing was run, so the runs of the checkpoint are still needed.
+    checkpoint = nullptr;
   }
   display_reporter->Finalize();
   if (file_reporter != nullptr) {
@@ -528,6 +1049,9 @@ void RunBenchmarks(const std::vector<BenchmarkInstance>& benchmarks,
   }
   FlushStreams(display_reporter);
   FlushStreams(file_reporter);
+  if (checkpoint != nullptr) {
+    checkpoint->Remove();
+  }
 }
 
 // Disable deprecated warnings temporarily because we need to reference
@@ -543,6 +1067,12 @@ std::unique_ptr<BenchmarkReporter> CreateReporter(
   if (name == "json") {
     return PtrType(new JSONReporter());
   }
+  if (name == "ndjson") {
+    return PtrType(new NDJSONReporter());
+  }
+  if (name == "columnar") {
+    return PtrType(new ColumnarReporter());
+  }
   if (name == "csv") {
     return PtrType(new CSVReporter());
   }
@@ -590,6 +1120,10 @@ std::unique_ptr<BenchmarkReporter> CreateDefaultDisplayReporter() {
                                   internal::GetOutputOptions());
 }
 
+size_t GetNumBaselineRegressions() {
+  return internal::num_baseline_regressions;
+}
+
 size_t RunSpecifiedBenchmarks() {
   return RunSpecifiedBenchmarks(nullptr, nullptr, FLAGS_benchmark_filter);
 }
@@ -620,6 +1154,7 @@ size_t RunSpecifiedBenchmarks(BenchmarkReporter* display_reporter,
   if (spec.empty() || spec == "all") {
     spec = ".";  // Regexp that matches all benchmarks
   }
+  internal::num_baseline_regressions = 0;
 
   // Setup the reporters
   std::ofstream output_file;
@@ -641,7 +1176,9 @@ size_t RunSpecifiedBenchmarks(BenchmarkReporter* display_reporter,
     std::exit(1);
   }
   if (!fname.empty()) {
-    output_file.open(fname);
+    output_file.open(fname, FLAGS_benchmark_out_format == "columnar"
+                                ? std::ios::out | std::ios::binary
+                                : std::ios::out);
     if (!output_file.is_open()) {
       Err << "invalid file name: '" << fname << "'\n";
       Out.flush();
@@ -676,7 +1213,67 @@ size_t RunSpecifiedBenchmarks(BenchmarkReporter* display_reporter,
   if (FLAGS_benchmark_list_tests) {
     display_reporter->List(benchmarks);
   } else {
-    internal::RunBenchmarks(benchmarks, display_reporter, file_reporter);
+    std::unique_ptr<internal::Checkpoint> checkpoint;
+    if (!FLAGS_benchmark_checkpoint.empty()) {
+      checkpoint.reset(new internal::Checkpoint(FLAGS_benchmark_checkpoint));
+      if (!checkpoint->Load()) {
+        Err << "invalid checkpoint file: '" << FLAGS_benchmark_checkpoint
+            << "'\n";
+        Out.flush();
+        Err.flush();
+        std::exit(1);
+      }
+    }
+
+    std::unique_ptr<internal::Baseline> baseline;
+    if (!FLAGS_benchmark_baseline.empty()) {
+      baseline.reset(new internal::Baseline());
+      std::string error;
+      if (!baseline->Load(FLAGS_benchmark_baseline, &error)) {
+        Err << "invalid baseline file: '" << FLAGS_benchmark_baseline
+            << "': " << error << "\n";
+        Out.flush();
+        Err.flush();
+        std::exit(1);
+      }
+    }
+
+    std::unique_ptr<internal::MachineProfile> machine_profile;
+    if (!FLAGS_benchmark_machine_profile.empty()) {
+      machine_profile.reset(new internal::MachineProfile());
+      std::string error;
+      if (!machine_profile->Load(FLAGS_benchmark_machine_profile, &error)) {
+        Err << "invalid machine profile: '" << FLAGS_benchmark_machine_profile
+            << "': " << error << "\n";
+        Out.flush();
+        Err.flush();
+        std::exit(1);
+      }
+    }
+
+    // NDJSON output is meant to survive a crash of the benchmark, so every
+    // record is synced to disk right away.
+    std::function<void()> sync_file_output;
+#ifndef BENCHMARK_OS_WINDOWS
+    int output_fd = -1;
+    if (!fname.empty() && FLAGS_benchmark_out_format == "ndjson") {
+      output_fd = open(fname.c_str(), O_WRONLY | O_CLOEXEC);
+    }
+    if (output_fd >= 0) {
+      sync_file_output = [&output_file, output_fd]() {
+        output_file.flush();
+        fsync(output_fd);
+      };
+    }
+#endif
+    internal::RunBenchmarks(benchmarks, display_reporter, file_reporter,
+                            sync_file_output, checkpoint.get(),
+                            baseline.get(), machine_profile.get());
+#ifndef BENCHMARK_OS_WINDOWS
+    if (output_fd >= 0) {
+      close(output_fd);
+    }
+#endif
   }
 
   Out.flush();
@@ -693,6 +1290,19 @@ TimeUnit GetDefaultTimeUnit() { return default_time_unit; }
 
 void SetDefaultTimeUnit(TimeUnit unit) { default_time_unit = unit; }
 
+namespace {
+// stores the thread affinity policy benchmarks use by default
+ThreadAffinityPolicy default_thread_affinity = kAffinityNone;
+}  // namespace
+
+ThreadAffinityPolicy GetDefaultThreadAffinity() {
+  return default_thread_affinity;
+}
+
+void SetDefaultThreadAffinity(ThreadAffinityPolicy policy) {
+  default_thread_affinity = policy;
+}
+
 std::string GetBenchmarkFilter() { return FLAGS_benchmark_filter; }
 
 void SetBenchmarkFilter(std::string value) {
@@ -754,6 +1364,17 @@ void SetDefaultTimeUnitFromFlag(const std::string& time_unit_flag) {
   }
 }
 
+void SetDefaultThreadAffinityFromFlag(const std::string& affinity_flag) {
+  if (affinity_flag.empty()) {
+    return;
+  }
+  ThreadAffinityPolicy policy = kAffinityNone;
+  if (!ParseThreadAffinityPolicy(affinity_flag, &policy)) {
+    PrintUsageAndExit();
+  }
+  SetDefaultThreadAffinity(policy);
+}
+
 void ParseCommandLineFlags(int* argc, char** argv) {
   using namespace benchmark;
   BenchmarkReporter::Context::executable_name =
@@ -766,11 +1387,19 @@ void ParseCommandLineFlags(int* argc, char** argv) {
                         &FLAGS_benchmark_min_time) ||
         ParseDoubleFlag(argv[i], "benchmark_min_warmup_time",
                         &FLAGS_benchmark_min_warmup_time) ||
+        ParseDoubleFlag(argv[i], "benchmark_target_rel_error",
+                        &FLAGS_benchmark_target_rel_error) ||
+        ParseDoubleFlag(argv[i], "benchmark_max_time",
+                        &FLAGS_benchmark_max_time) ||
         ParseInt32Flag(argv[i], "benchmark_repetitions",
                        &FLAGS_benchmark_repetitions) ||
         ParseBoolFlag(argv[i], "benchmark_dry_run", &FLAGS_benchmark_dry_run) ||
         ParseBoolFlag(argv[i], "benchmark_enable_random_interleaving",
                       &FLAGS_benchmark_enable_random_interleaving) ||
+        ParseInt32Flag(argv[i], "benchmark_parallel_instances",
+                       &FLAGS_benchmark_parallel_instances) ||
+        ParseStringFlag(argv[i], "benchmark_isolation",
+                        &FLAGS_benchmark_isolation) ||
         ParseBoolFlag(argv[i], "benchmark_report_aggregates_only",
                       &FLAGS_benchmark_report_aggregates_only) ||
         ParseBoolFlag(argv[i], "benchmark_display_aggregates_only",
@@ -779,15 +1408,45 @@ void ParseCommandLineFlags(int* argc, char** argv) {
         ParseStringFlag(argv[i], "benchmark_out", &FLAGS_benchmark_out) ||
         ParseStringFlag(argv[i], "benchmark_out_format",
                         &FLAGS_benchmark_out_format) ||
+        ParseStringFlag(argv[i], "benchmark_checkpoint",
+                        &FLAGS_benchmark_checkpoint) ||
+        ParseStringFlag(argv[i], "benchmark_baseline",
+                        &FLAGS_benchmark_baseline) ||
+        ParseStringFlag(argv[i], "benchmark_machine_profile",
+                        &FLAGS_benchmark_machine_profile) ||
+        ParseDoubleFlag(argv[i], "benchmark_peak_bandwidth",
+                        &FLAGS_benchmark_peak_bandwidth) ||
+        ParseDoubleFlag(argv[i], "benchmark_peak_flops",
+                        &FLAGS_benchmark_peak_flops) ||
+        ParseDoubleFlag(argv[i], "benchmark_baseline_alpha",
+                        &FLAGS_benchmark_baseline_alpha) ||
+        ParseInt32Flag(argv[i], "benchmark_baseline_max_repetitions",
+                       &FLAGS_benchmark_baseline_max_repetitions) ||
         ParseStringFlag(argv[i], "benchmark_color", &FLAGS_benchmark_color) ||
         ParseBoolFlag(argv[i], "benchmark_counters_tabular",
                       &FLAGS_benchmark_counters_tabular) ||
+        ParseBoolFlag(argv[i], "benchmark_report_release_skew",
+                      &FLAGS_benchmark_report_release_skew) ||
+        ParseStringFlag(argv[i], "benchmark_timer_overhead",
+                        &FLAGS_benchmark_timer_overhead) ||
         ParseStringFlag(argv[i], "benchmark_perf_counters",
                         &FLAGS_benchmark_perf_counters) ||
+        ParseBoolFlag(argv[i], "benchmark_perf_counters_per_thread",
+                      &FLAGS_benchmark_perf_counters_per_thread) ||
+        ParseBoolFlag(argv[i], "benchmark_perf_counters_rotate",
+                      &FLAGS_benchmark_perf_counters_rotate) ||
+        ParseStringFlag(argv[i], "benchmark_perf_metrics",
+                        &FLAGS_benchmark_perf_metrics) ||
+        ParseStringFlag(argv[i], "benchmark_cpu_frequency",
+                        &FLAGS_benchmark_cpu_frequency) ||
+        ParseBoolFlag(argv[i], "benchmark_sample_profile",
+                      &FLAGS_benchmark_sample_profile) ||
         ParseKeyValueFlag(argv[i], "benchmark_context",
                           &FLAGS_benchmark_context) ||
         ParseStringFlag(argv[i], "benchmark_time_unit",
                         &FLAGS_benchmark_time_unit) ||
+        ParseStringFlag(argv[i], "benchmark_affinity",
+                        &FLAGS_benchmark_affinity) ||
         ParseInt32Flag(argv[i], "v", &FLAGS_v)) {
       for (int j = i; j != *argc - 1; ++j) {
         argv[j] = argv[j + 1];
@@ -801,11 +1460,37 @@ void ParseCommandLineFlags(int* argc, char** argv) {
   }
   for (auto const* flag :
        {&FLAGS_benchmark_format, &FLAGS_benchmark_out_format}) {
-    if (*flag != "console" && *flag != "json" && *flag != "csv") {
+    if (*flag != "console" && *flag != "json" && *flag != "ndjson" &&
+        *flag != "csv" &&
+        // The binary format is only meant to be written to files.
+        (*flag != "columnar" || flag == &FLAGS_benchmark_format)) {
       PrintUsageAndExit();
     }
   }
+  if (FLAGS_benchmark_isolation != "none" &&
+      FLAGS_benchmark_isolation != "process") {
+    PrintUsageAndExit();
+  }
+  if (FLAGS_benchmark_timer_overhead != "none" &&
+      FLAGS_benchmark_timer_overhead != "report" &&
+      FLAGS_benchmark_timer_overhead != "subtract") {
+    PrintUsageAndExit();
+  }
+  if (FLAGS_benchmark_cpu_frequency != "none" &&
+      FLAGS_benchmark_cpu_frequency != "report" &&
+      FLAGS_benchmark_cpu_frequency != "cycles") {
+    PrintUsageAndExit();
+  }
+  if (!(FLAGS_benchmark_max_time > 0)) {
+    PrintUsageAndExit();
+  }
+  if (!(FLAGS_benchmark_baseline_alpha > 0 &&
+        FLAGS_benchmark_baseline_alpha < 1) ||
+      FLAGS_benchmark_baseline_max_repetitions < 0) {
+    PrintUsageAndExit();
+  }
   SetDefaultTimeUnitFromFlag(FLAGS_benchmark_time_unit);
+  SetDefaultThreadAffinityFromFlag(FLAGS_benchmark_affinity);
   if (FLAGS_benchmark_color.empty()) {
     PrintUsageAndExit();
   }
@@ -970,21 +1655,42 @@ void PrintDefaultHelp() {
           "          [--benchmark_filter=<regex>]\n"
           "          [--benchmark_min_time=`<integer>x` OR `<float>s` ]\n"
           "          [--benchmark_min_warmup_time=<min_warmup_time>]\n"
+          "          [--benchmark_target_rel_error=<rel_error>]\n"
+          "          [--benchmark_max_time=<max_time>]\n"
           "          [--benchmark_repetitions=<num_repetitions>]\n"
           "          [--benchmark_dry_run={true|false}]\n"
           "          [--benchmark_enable_random_interleaving={true|false}]\n"
+          "          [--benchmark_parallel_instances=<num_instances>]\n"
+          "          [--benchmark_isolation=<none|process>]\n"
           "          [--benchmark_report_aggregates_only={true|false}]\n"
           "          [--benchmark_display_aggregates_only={true|false}]\n"
-          "          [--benchmark_format=<console|json|csv>]\n"
+          "          [--benchmark_format=<console|json|ndjson|csv>]\n"
           "          [--benchmark_out=<filename>]\n"
-          "          [--benchmark_out_format=<json|console|csv>]\n"
+          "          [--benchmark_out_format="
+          "<json|ndjson|columnar|console|csv>]\n"
+          "          [--benchmark_checkpoint=<filename>]\n"
+          "          [--benchmark_baseline=<filename>]\n"
+          "          [--benchmark_baseline_alpha=<alpha>]\n"
+          "          [--benchmark_baseline_max_repetitions=<num_repetitions>]\n"
+          "          [--benchmark_machine_profile=<filename>]\n"
+          "          [--benchmark_peak_bandwidth=<bytes_per_second>]\n"
+          "          [--benchmark_peak_flops=<flops_per_second>]\n"
           "          [--benchmark_color={auto|true|false}]\n"
           "          [--benchmark_counters_tabular={true|false}]\n"
+          "          [--benchmark_report_release_skew={true|false}]\n"
+          "          [--benchmark_timer_overhead={none|report|subtract}]\n"
 #if defined HAVE_LIBPFM
           "          [--benchmark_perf_counters=<counter>,...]\n"
+          "          [--benchmark_perf_counters_per_thread={true|false}]\n"
+          "          [--benchmark_perf_counters_rotate={true|false}]\n"
+          "          [--benchmark_perf_metrics=<metric>,...]\n"
+          "          [--benchmark_cpu_frequency={none|report|cycles}]\n"
 #endif
+          "          [--benchmark_sample_profile={true|false}]\n"
           "          [--benchmark_context=<key>=<value>,...]\n"
           "          [--benchmark_time_unit={ns|us|ms|s}]\n"
+          "          [--benchmark_affinity="
+          "{none|compact|scatter|physical_core|numa_node}]\n"
           "          [--v=<verbosity>]\n");
 }
 
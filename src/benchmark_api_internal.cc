@@ -2,6 +2,8 @@
 
 #include <cinttypes>
 
+#include "cpu_affinity.h"
+#include "numa.h"
 #include "string_util.h"
 
 namespace benchmark {
@@ -10,17 +12,18 @@ namespace internal {
 BenchmarkInstance::BenchmarkInstance(benchmark::Benchmark* benchmark,
                                      int family_idx,
                                      int per_family_instance_idx,
-                                     const std::vector<int64_t>& args,
-                                     int thread_count)
+                                     size_t args_index, int thread_count)
     : benchmark_(*benchmark),
       family_index_(family_idx),
       per_family_instance_index_(per_family_instance_idx),
       aggregation_report_mode_(benchmark_.aggregation_report_mode_),
-      args_(args),
+      args_(benchmark_.args_[args_index]),
       time_unit_(benchmark_.GetTimeUnit()),
       measure_process_cpu_time_(benchmark_.measure_process_cpu_time_),
       use_real_time_(benchmark_.use_real_time_),
       use_manual_time_(benchmark_.use_manual_time_),
+      use_cycle_clock_(benchmark_.use_cycle_clock_),
+      record_latency_distribution_(benchmark_.record_latency_distribution_),
       complexity_(benchmark_.complexity_),
       complexity_lambda_(benchmark_.complexity_lambda_),
       statistics_(benchmark_.statistics_),
@@ -29,12 +32,22 @@ BenchmarkInstance::BenchmarkInstance(benchmark::Benchmark* benchmark,
       min_warmup_time_(benchmark_.min_warmup_time_),
       iterations_(benchmark_.iterations_),
       threads_(thread_count),
+      thread_affinity_(benchmark_.GetThreadAffinity()),
+      memory_policy_(benchmark_.memory_policy_),
       setup_(benchmark_.setup_),
       teardown_(benchmark_.teardown_) {
   name_.function_name = benchmark_.name_;
 
+  // Custom thread runners place their threads themselves, and without a
+  // policy there is nothing to pick.
+  if (!benchmark_.threadrunner_ && thread_affinity_ != kAffinityNone) {
+    affinity_cpus_ = PickAffinityCPUs(
+        thread_affinity_, CPUInfo::Get().topology, GetAllowedCPUs(),
+        static_cast<size_t>(threads_));
+  }
+
   size_t arg_i = 0;
-  for (const auto& arg : args) {
+  for (const auto& arg : args_) {
     if (!name_.args.empty()) {
       name_.args += '/';
     }
@@ -50,6 +63,13 @@ BenchmarkInstance::BenchmarkInstance(benchmark::Benchmark* benchmark,
     ++arg_i;
   }
 
+  auto working_set_name = benchmark_.working_set_names_.find(args_index);
+  if (working_set_name != benchmark_.working_set_names_.end()) {
+    name_.args += '/' + working_set_name->second;
+    working_set_description_ =
+        benchmark_.working_set_descriptions_.at(args_index);
+  }
+
   if (!IsZero(benchmark->min_time_)) {
     name_.min_time = StrFormat("min_time:%0.3f", benchmark_.min_time_);
   }
@@ -84,6 +104,13 @@ BenchmarkInstance::BenchmarkInstance(benchmark::Benchmark* benchmark,
     name_.time_type += "real_time";
   }
 
+  if (benchmark_.use_cycle_clock_) {
+    if (!name_.time_type.empty()) {
+      name_.time_type += '/';
+    }
+    name_.time_type += "cycle_clock";
+  }
+
   if (!benchmark_.thread_counts_.empty()) {
     name_.threads = StrFormat("threads:%d", threads_);
   }
@@ -104,6 +131,8 @@ void BenchmarkInstance::Setup() const {
   if (setup_ != nullptr) {
     State st(name_.function_name, /*iters*/ 1, args_, /*thread_id*/ 0, threads_,
              nullptr, nullptr, nullptr, nullptr);
+    // Place whatever the setup allocates like the benchmark itself would.
+    ScopedMemoryPolicy memory_policy(memory_policy_);
     setup_(st);
   }
 }
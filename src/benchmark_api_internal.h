@@ -20,8 +20,8 @@ namespace internal {
 class BenchmarkInstance {
  public:
   BenchmarkInstance(benchmark::Benchmark* benchmark, int family_idx,
-                    int per_family_instance_idx,
-                    const std::vector<int64_t>& args, int thread_count);
+                    int per_family_instance_idx, size_t args_index,
+                    int thread_count);
 
   const BenchmarkName& name() const { return name_; }
   int family_index() const { return family_index_; }
@@ -33,6 +33,10 @@ class BenchmarkInstance {
   bool measure_process_cpu_time() const { return measure_process_cpu_time_; }
   bool use_real_time() const { return use_real_time_; }
   bool use_manual_time() const { return use_manual_time_; }
+  bool use_cycle_clock() const { return use_cycle_clock_; }
+  bool record_latency_distribution() const {
+    return record_latency_distribution_;
+  }
   BigO complexity() const { return complexity_; }
   BigOFunc* complexity_lambda() const { return complexity_lambda_; }
   const std::vector<Statistics>& statistics() const { return statistics_; }
@@ -41,6 +45,16 @@ class BenchmarkInstance {
   double min_warmup_time() const { return min_warmup_time_; }
   IterationCount iterations() const { return iterations_; }
   int threads() const { return threads_; }
+  ThreadAffinityPolicy thread_affinity() const { return thread_affinity_; }
+  // The CPUs the threads are pinned to, see PickAffinityCPUs(). Empty if the
+  // threads are not pinned.
+  const std::vector<int>& affinity_cpus() const { return affinity_cpus_; }
+  const NumaPolicy& memory_policy() const { return memory_policy_; }
+  // The cache level the working set fits in, for the instances generated by
+  // Benchmark::CacheSweep(), empty otherwise.
+  const std::string& working_set_description() const {
+    return working_set_description_;
+  }
   void Setup() const;
   void Teardown() const;
   const auto& GetUserThreadRunnerFactory() const {
@@ -63,6 +77,8 @@ class BenchmarkInstance {
   bool measure_process_cpu_time_;
   bool use_real_time_;
   bool use_manual_time_;
+  bool use_cycle_clock_;
+  bool record_latency_distribution_;
   BigO complexity_;
   BigOFunc* complexity_lambda_;
   UserCounters counters_;
@@ -72,6 +88,10 @@ class BenchmarkInstance {
   double min_warmup_time_;
   IterationCount iterations_;
   int threads_;  // Number of concurrent threads to us
+  ThreadAffinityPolicy thread_affinity_;
+  std::vector<int> affinity_cpus_;
+  NumaPolicy memory_policy_;
+  std::string working_set_description_;
 
   callback_function setup_;
   callback_function teardown_;
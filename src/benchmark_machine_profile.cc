@@ -0,0 +1,556 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the performance ceilings of the machine it runs on, and writes
+// them as a machine profile for --benchmark_machine_profile:
+// - the memory bandwidth of the STREAM copy, scale and triad kernels, on one
+//   thread and on a thread per CPU, and per NUMA node;
+// - the load-to-use latency of each cache level and of memory, by chasing
+//   pointers through a working set in it;
+// - the peak floating point throughput of one thread, with scalar and with
+//   the widest vector instructions the CPU supports.
+//
+// With --core_to_core_out, it instead measures the round-trip latency of a
+// cache line between each pair of CPUs, and writes the matrix along with the
+// topology of the CPUs.
+//
+// Usage: benchmark_machine_profile [--machine_profile_out=<filename>]
+//                                  [--core_to_core_out=<filename>]
+//                                  [benchmark flags]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_register.h"
+#include "cpu_affinity.h"
+#include "machine_profile.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BENCHMARK_HAS_X86_VECTORS
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define BENCHMARK_HAS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace benchmark {
+namespace {
+
+constexpr char kOutFlag[] = "--machine_profile_out=";
+constexpr char kCoreToCoreOutFlag[] = "--core_to_core_out=";
+
+//=============================================================================//
+//                              Memory bandwidth
+//=============================================================================//
+
+// The bytes of each of the three arrays of the STREAM kernels, which must be
+// well beyond the caches.
+int64_t StreamArrayBytes() {
+  int64_t largest_cache = 0;
+  for (const CPUInfo::CacheInfo& cache : CPUInfo::Get().caches) {
+    largest_cache = std::max<int64_t>(largest_cache, cache.size);
+  }
+  return std::max<int64_t>(4 * largest_cache, int64_t{64} << 20);
+}
+
+enum StreamKernel { kCopy, kScale, kTriad };
+
+// Each thread works on its share of the arrays, which it allocates itself so
+// that they are placed by the memory policy of the benchmark.
+void BM_Stream(State& state, StreamKernel kernel) {
+  const size_t size = static_cast<size_t>(
+      StreamArrayBytes() / static_cast<int64_t>(sizeof(double)) /
+      state.threads());
+  std::vector<double> a(size, 1.0);
+  std::vector<double> b(size, 2.0);
+  std::vector<double> c(size, 0.0);
+  const double scalar = 3.0;
+  for (auto _ : state) {
+    switch (kernel) {
+      case kCopy:
+        for (size_t i = 0; i < size; ++i) {
+          c[i] = a[i];
+        }
+        break;
+      case kScale:
+        for (size_t i = 0; i < size; ++i) {
+          b[i] = scalar * c[i];
+        }
+        break;
+      case kTriad:
+        for (size_t i = 0; i < size; ++i) {
+          a[i] = b[i] + scalar * c[i];
+        }
+        break;
+    }
+    ClobberMemory();
+  }
+  // Like STREAM, only the bytes the kernel asks for are counted, not those
+  // of the reads for ownership of the stores.
+  const int64_t arrays = kernel == kTriad ? 3 : 2;
+  state.SetBytesProcessed(state.iterations() * arrays *
+                          static_cast<int64_t>(size * sizeof(double)));
+}
+
+//=============================================================================//
+//                                  Latency
+//=============================================================================//
+
+// A cache line, so that every load of the chase goes to a different one.
+struct alignas(64) ChaseNode {
+  ChaseNode* next;
+};
+
+constexpr int64_t kLoadsPerIteration = 1024;
+
+// Chases pointers through `state.range(0)` bytes in a random cycle, which the
+// hardware prefetchers cannot predict.
+void BM_PointerChase(State& state) {
+  const size_t num_nodes = std::max<size_t>(
+      static_cast<size_t>(state.range(0)) / sizeof(ChaseNode), 2);
+  std::unique_ptr<ChaseNode[]> nodes(new ChaseNode[num_nodes]);
+  // Sattolo's algorithm, which makes a single cycle through all nodes.
+  std::vector<size_t> order(num_nodes);
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::mt19937_64 rng(42);
+  for (size_t i = num_nodes - 1; i > 0; --i) {
+    std::uniform_int_distribution<size_t> pick(0, i - 1);
+    std::swap(order[i], order[pick(rng)]);
+  }
+  for (size_t i = 0; i < num_nodes; ++i) {
+    nodes[order[i]].next = &nodes[order[(i + 1) % num_nodes]];
+  }
+
+  ChaseNode* node = &nodes[0];
+  for (auto _ : state) {
+    for (int64_t i = 0; i < kLoadsPerIteration; ++i) {
+      node = node->next;
+    }
+    DoNotOptimize(node);
+  }
+  state.counters["latency"] =
+      Counter(static_cast<double>(state.iterations() * kLoadsPerIteration),
+              Counter::kIsRate | Counter::kInvert);
+}
+
+//=============================================================================//
+//                                   FLOPs
+//=============================================================================//
+
+// Enough independent chains of multiply-adds to keep all floating point units
+// of a core busy despite their latency.
+constexpr int kChains = 12;
+constexpr int kRepeats = 256;
+
+// Keeps the compiler from combining the independent scalar chains into vector
+// instructions.
+inline void Opaque(double& value) {
+#if defined(BENCHMARK_HAS_X86_VECTORS)
+  asm volatile("" : "+x"(value));
+#elif defined(BENCHMARK_HAS_NEON)
+  asm volatile("" : "+w"(value));
+#else
+  DoNotOptimize(value);
+#endif
+}
+
+// Returns the floating point operations of one iteration.
+int64_t ScalarFlops() {
+  double acc[kChains];
+  for (int c = 0; c < kChains; ++c) {
+    acc[c] = c;
+  }
+  const double mul = 0.999999;
+  const double add = 1e-6;
+  for (int r = 0; r < kRepeats; ++r) {
+#pragma GCC unroll 16
+    for (int c = 0; c < kChains; ++c) {
+      acc[c] = acc[c] * mul + add;
+      Opaque(acc[c]);
+    }
+  }
+  DoNotOptimize(acc);
+  return int64_t{2} * kChains * kRepeats;
+}
+
+#if defined(BENCHMARK_HAS_X86_VECTORS)
+__attribute__((target("avx512f"))) int64_t Avx512Flops() {
+  __m512d acc[kChains];
+  for (int c = 0; c < kChains; ++c) {
+    acc[c] = _mm512_set1_pd(c);
+  }
+  const __m512d mul = _mm512_set1_pd(0.999999);
+  const __m512d add = _mm512_set1_pd(1e-6);
+  for (int r = 0; r < kRepeats; ++r) {
+#pragma GCC unroll 16
+    for (int c = 0; c < kChains; ++c) {
+      acc[c] = _mm512_fmadd_pd(acc[c], mul, add);
+    }
+  }
+  DoNotOptimize(acc);
+  return int64_t{2} * 8 * kChains * kRepeats;
+}
+
+__attribute__((target("avx2,fma"))) int64_t Avx2Flops() {
+  __m256d acc[kChains];
+  for (int c = 0; c < kChains; ++c) {
+    acc[c] = _mm256_set1_pd(c);
+  }
+  const __m256d mul = _mm256_set1_pd(0.999999);
+  const __m256d add = _mm256_set1_pd(1e-6);
+  for (int r = 0; r < kRepeats; ++r) {
+#pragma GCC unroll 16
+    for (int c = 0; c < kChains; ++c) {
+      acc[c] = _mm256_fmadd_pd(acc[c], mul, add);
+    }
+  }
+  DoNotOptimize(acc);
+  return int64_t{2} * 4 * kChains * kRepeats;
+}
+
+__attribute__((target("sse2"))) int64_t Sse2Flops() {
+  __m128d acc[kChains];
+  for (int c = 0; c < kChains; ++c) {
+    acc[c] = _mm_set1_pd(c);
+  }
+  const __m128d mul = _mm_set1_pd(0.999999);
+  const __m128d add = _mm_set1_pd(1e-6);
+  for (int r = 0; r < kRepeats; ++r) {
+#pragma GCC unroll 16
+    for (int c = 0; c < kChains; ++c) {
+      acc[c] = _mm_add_pd(_mm_mul_pd(acc[c], mul), add);
+    }
+  }
+  DoNotOptimize(acc);
+  return int64_t{2} * 2 * kChains * kRepeats;
+}
+#elif defined(BENCHMARK_HAS_NEON)
+int64_t NeonFlops() {
+  float64x2_t acc[kChains];
+  for (int c = 0; c < kChains; ++c) {
+    acc[c] = vdupq_n_f64(c);
+  }
+  const float64x2_t mul = vdupq_n_f64(0.999999);
+  const float64x2_t add = vdupq_n_f64(1e-6);
+  for (int r = 0; r < kRepeats; ++r) {
+#pragma GCC unroll 16
+    for (int c = 0; c < kChains; ++c) {
+      acc[c] = vfmaq_f64(add, acc[c], mul);
+    }
+  }
+  DoNotOptimize(acc);
+  return int64_t{2} * 2 * kChains * kRepeats;
+}
+#endif
+
+// The kernel with the widest vectors the CPU supports, and their name.
+std::pair<int64_t (*)(), const char*> GetSimdKernel() {
+#if defined(BENCHMARK_HAS_X86_VECTORS)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return {Avx512Flops, "avx512"};
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return {Avx2Flops, "avx2"};
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return {Sse2Flops, "sse2"};
+  }
+#elif defined(BENCHMARK_HAS_NEON)
+  return {NeonFlops, "neon"};
+#endif
+  return {ScalarFlops, "scalar"};
+}
+
+void BM_Flops(State& state, int64_t (*kernel)()) {
+  int64_t flops = 0;
+  for (auto _ : state) {
+    flops += kernel();
+  }
+  state.counters["flops"] =
+      Counter(static_cast<double>(flops), Counter::kIsRate);
+}
+
+//=============================================================================//
+//                            Core to core latency
+//=============================================================================//
+
+// The cache line that the two threads pass back and forth. Every run leaves
+// an even sequence number in it.
+struct alignas(64) PingPongLine {
+  std::atomic<uint64_t> sequence{0};
+};
+
+PingPongLine ping_pong_line;
+
+constexpr int64_t kRoundTripsPerIteration = 100;
+
+// Thread 0 makes the sequence number odd, and waits for thread 1 to make it
+// even again, which takes the cache line to the CPU of thread 1 and back.
+void BM_PingPong(State& state) {
+  std::atomic<uint64_t>& sequence = ping_pong_line.sequence;
+  if (state.thread_index() == 0) {
+    for (auto _ : state) {
+      for (int64_t i = 0; i < kRoundTripsPerIteration; ++i) {
+        const uint64_t ping = sequence.load(std::memory_order_relaxed) + 1;
+        sequence.store(ping, std::memory_order_release);
+        while (sequence.load(std::memory_order_acquire) != ping + 1) {
+        }
+      }
+    }
+    state.counters["round_trip"] = Counter(
+        static_cast<double>(state.iterations() * kRoundTripsPerIteration),
+        Counter::kIsRate | Counter::kInvert);
+  } else {
+    for (auto _ : state) {
+      for (int64_t i = 0; i < kRoundTripsPerIteration; ++i) {
+        uint64_t ping;
+        while (((ping = sequence.load(std::memory_order_acquire)) & 1) == 0) {
+        }
+        sequence.store(ping + 1, std::memory_order_release);
+      }
+    }
+  }
+}
+
+// Runs thread 0 of a benchmark on one CPU and thread 1 on another.
+class PairThreadRunner : public ThreadRunnerBase {
+ public:
+  PairThreadRunner(int cpu_a, int cpu_b) : cpus_{cpu_a, cpu_b} {}
+
+  void RunThreads(const std::function<void(int)>& fn) override {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 2; ++i) {
+      threads.emplace_back([this, &fn, i] {
+        internal::PinCurrentThreadToCPU(cpus_[i]);
+        fn(i);
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+
+ private:
+  const int cpus_[2];
+};
+
+// Registers a benchmark for each pair of the CPUs, named after the pair.
+void RegisterCoreToCoreBenchmarks(const std::vector<int>& cpus) {
+  for (size_t a = 0; a < cpus.size(); ++a) {
+    for (size_t b = a + 1; b < cpus.size(); ++b) {
+      const int cpu_a = cpus[a];
+      const int cpu_b = cpus[b];
+      RegisterBenchmark("core_to_core_latency", BM_PingPong)
+          ->Args({cpu_a, cpu_b})
+          ->Threads(2)
+          ->UseRealTime()
+          ->ThreadRunner([cpu_a, cpu_b](int) {
+            return std::make_unique<PairThreadRunner>(cpu_a, cpu_b);
+          });
+    }
+  }
+}
+
+// Shows the results, and keeps the best of the repetitions of each pair in
+// the matrix.
+class CoreToCoreReporter : public ConsoleReporter {
+ public:
+  explicit CoreToCoreReporter(internal::CoreToCoreLatencies* latencies)
+      : latencies_(latencies) {}
+
+  void ReportRuns(const std::vector<Run>& reports) override {
+    ConsoleReporter::ReportRuns(reports);
+    for (const Run& run : reports) {
+      if (run.run_type != Run::RT_Iteration || run.skipped) {
+        continue;
+      }
+      auto it = run.counters.find("round_trip");
+      int cpu_a = 0;
+      int cpu_b = 0;
+      if (it == run.counters.end() ||
+          std::sscanf(run.run_name.args.c_str(), "%d/%d", &cpu_a, &cpu_b) !=
+              2) {
+        continue;
+      }
+      latencies_->Add(cpu_a, cpu_b, it->second);
+    }
+  }
+
+ private:
+  internal::CoreToCoreLatencies* latencies_;
+};
+
+//=============================================================================//
+//                                  Profile
+//=============================================================================//
+
+// Shows the results, and keeps the best of the repetitions of each benchmark
+// in the profile, under the name of the benchmark.
+class ProfileReporter : public ConsoleReporter {
+ public:
+  explicit ProfileReporter(internal::MachineProfile* profile)
+      : profile_(profile) {}
+
+  void ReportRuns(const std::vector<Run>& reports) override {
+    ConsoleReporter::ReportRuns(reports);
+    for (const Run& run : reports) {
+      if (run.run_type != Run::RT_Iteration || run.skipped) {
+        continue;
+      }
+      for (const char* counter : {"bytes_per_second", "latency", "flops"}) {
+        auto it = run.counters.find(counter);
+        if (it == run.counters.end()) {
+          continue;
+        }
+        const bool lower_is_better = std::strcmp(counter, "latency") == 0;
+        auto inserted =
+            profile_->values().emplace(run.run_name.function_name, it->second);
+        double& best = inserted.first->second;
+        best = lower_is_better ? std::min<double>(best, it->second)
+                               : std::max<double>(best, it->second);
+      }
+    }
+  }
+
+ private:
+  internal::MachineProfile* profile_;
+};
+
+void RegisterProfileBenchmarks() {
+  const std::pair<const char*, StreamKernel> kernels[] = {
+      {"copy", kCopy}, {"scale", kScale}, {"triad", kTriad}};
+  for (const auto& kernel : kernels) {
+    RegisterBenchmark(std::string(kernel.first) + "_bandwidth", BM_Stream,
+                      kernel.second)
+        ->UseRealTime();
+    RegisterBenchmark(std::string(kernel.first) + "_bandwidth_all_cpus",
+                      BM_Stream, kernel.second)
+        ->ThreadPerCpu()
+        ->MemoryPolicy(NumaPolicy::Local())
+        ->UseRealTime();
+  }
+  const std::vector<std::vector<int>>& numa_distances =
+      CPUInfo::Get().numa_distances;
+  for (size_t node = 0;
+       numa_distances.size() > 1 && node < numa_distances.size(); ++node) {
+    if (numa_distances[node].empty() || numa_distances[node][node] < 0) {
+      continue;
+    }
+    RegisterBenchmark("triad_bandwidth_node" + std::to_string(node) +
+                          "_all_cpus",
+                      BM_Stream, kTriad)
+        ->ThreadPerCpu()
+        ->MemoryPolicy(NumaPolicy::Node(static_cast<int>(node)))
+        ->UseRealTime();
+  }
+
+  // Half of each cache level, so that the working set does not spill over,
+  // and memory well beyond the largest cache.
+  const CPUInfo& info = CPUInfo::Get();
+  int64_t largest_cache = 0;
+  for (const internal::CacheSweepLevel& level :
+       internal::GetCacheSweepLevels(info.caches, /*tlb_reach=*/0)) {
+    RegisterBenchmark(level.name + "_latency", BM_PointerChase)
+        ->Arg(level.bytes / 2);
+    largest_cache = std::max(largest_cache, level.bytes);
+  }
+  RegisterBenchmark("memory_latency", BM_PointerChase)
+      ->Arg(std::max<int64_t>(8 * largest_cache, int64_t{256} << 20));
+
+  RegisterBenchmark("scalar_flops", BM_Flops, ScalarFlops);
+  const auto simd = GetSimdKernel();
+  AddCustomContext("simd_flops_kernel", simd.second);
+  RegisterBenchmark("simd_flops", BM_Flops, simd.first);
+}
+
+}  // namespace
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+  std::string out = "machine_profile.json";
+  std::string core_to_core_out;
+  int kept = 1;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], benchmark::kOutFlag,
+                     std::strlen(benchmark::kOutFlag)) == 0) {
+      out = argv[i] + std::strlen(benchmark::kOutFlag);
+    } else if (std::strncmp(argv[i], benchmark::kCoreToCoreOutFlag,
+                            std::strlen(benchmark::kCoreToCoreOutFlag)) == 0) {
+      core_to_core_out = argv[i] + std::strlen(benchmark::kCoreToCoreOutFlag);
+    } else {
+      argv[kept++] = argv[i];
+    }
+  }
+  argc = kept;
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  if (!core_to_core_out.empty()) {
+    benchmark::internal::CoreToCoreLatencies latencies(
+        benchmark::internal::GetAllowedCPUs());
+    if (latencies.cpus().size() < 2) {
+      std::cerr << "core to core latencies need at least two CPUs that "
+                   "threads can be pinned to\n";
+      return 1;
+    }
+    benchmark::RegisterCoreToCoreBenchmarks(latencies.cpus());
+    benchmark::CoreToCoreReporter reporter(&latencies);
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    std::string error;
+    if (!latencies.Save(core_to_core_out, benchmark::CPUInfo::Get().topology,
+                        &error)) {
+      std::cerr << "cannot write the core to core latencies '"
+                << core_to_core_out << "': " << error << "\n";
+      return 1;
+    }
+    std::cout << "Wrote the core to core latencies to " << core_to_core_out
+              << "\n";
+    return 0;
+  }
+
+  benchmark::RegisterProfileBenchmarks();
+
+  benchmark::internal::MachineProfile profile;
+  benchmark::ProfileReporter reporter(&profile);
+  benchmark::RunSpecifiedBenchmarks(&reporter);
+  benchmark::Shutdown();
+
+  std::string error;
+  if (!profile.Save(out, &error)) {
+    std::cerr << "cannot write the machine profile '" << out << "': " << error
+              << "\n";
+    return 1;
+  }
+  std::cout << "Wrote the machine profile to " << out << "\n";
+  return 0;
+}
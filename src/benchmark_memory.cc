@@ -0,0 +1,200 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A memory manager counting the allocations made through malloc and friends,
+// which operator new and delete, including their aligned variants, use as
+// well. Linking this library replaces them with versions that count, and
+// forward to the ones of glibc, and registers the memory manager.
+
+#include <malloc.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include "benchmark/managers.h"
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace benchmark {
+namespace {
+
+// Only counted between Start() and Stop(), so that the allocator is as fast
+// as without this library while the benchmark is timed. All counters are
+// shared by all threads, since the peak is that of the bytes used by all of
+// them; the memory manager only runs benchmarks on a single thread though.
+std::atomic<bool> counting{false};
+std::atomic<int64_t> num_allocs{0};
+std::atomic<int64_t> allocated_bytes{0};
+// Of the blocks allocated since Start(), minus those freed since, which may
+// have been allocated before.
+std::atomic<int64_t> live_bytes{0};
+std::atomic<int64_t> peak_bytes{0};
+
+// The sizes are those of the blocks the allocator actually reserved, which it
+// rounds up from the requested ones, so that a block counts the same when it
+// is allocated and when it is freed.
+int64_t BlockSize(void* ptr) {
+  return static_cast<int64_t>(malloc_usable_size(ptr));
+}
+
+void* CountAlloc(void* ptr) {
+  if (ptr == nullptr || !counting.load(std::memory_order_relaxed)) {
+    return ptr;
+  }
+  const int64_t size = BlockSize(ptr);
+  num_allocs.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  const int64_t live =
+      live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  int64_t peak = peak_bytes.load(std::memory_order_relaxed);
+  while (live > peak && !peak_bytes.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+  return ptr;
+}
+
+// The size of the block at `ptr` if allocations are being counted, and 0
+// otherwise, without asking the allocator.
+int64_t CountedBlockSize(void* ptr) {
+  if (ptr == nullptr || !counting.load(std::memory_order_relaxed)) {
+    return 0;
+  }
+  return BlockSize(ptr);
+}
+
+// `size` is as returned by CountedBlockSize().
+void CountFree(int64_t size) {
+  if (size != 0) {
+    live_bytes.fetch_sub(size, std::memory_order_relaxed);
+  }
+}
+
+bool IsValidAlignment(size_t alignment) {
+  return alignment != 0 && (alignment & (alignment - 1)) == 0;
+}
+
+class MallocMemoryManager : public MemoryManager {
+ public:
+  void Start() override {
+    num_allocs.store(0, std::memory_order_relaxed);
+    allocated_bytes.store(0, std::memory_order_relaxed);
+    live_bytes.store(0, std::memory_order_relaxed);
+    peak_bytes.store(0, std::memory_order_relaxed);
+    counting.store(true, std::memory_order_seq_cst);
+  }
+
+  void Stop(Result& result) override {
+    counting.store(false, std::memory_order_seq_cst);
+    result.num_allocs = num_allocs.load(std::memory_order_relaxed);
+    result.max_bytes_used = peak_bytes.load(std::memory_order_relaxed);
+    result.total_allocated_bytes =
+        allocated_bytes.load(std::memory_order_relaxed);
+    result.net_heap_growth = live_bytes.load(std::memory_order_relaxed);
+  }
+};
+
+MallocMemoryManager memory_manager;
+
+BENCHMARK_UNUSED const bool registered = [] {
+  RegisterMemoryManager(&memory_manager);
+  return true;
+}();
+
+}  // namespace
+}  // namespace benchmark
+
+extern "C" {
+
+// Referenced by the users of this library when linking, so that it is linked
+// in even if they don't call malloc directly.
+int benchmark_memory_manager = 0;
+
+void* malloc(size_t size) __THROW {
+  return benchmark::CountAlloc(__libc_malloc(size));
+}
+
+void* calloc(size_t count, size_t size) __THROW {
+  return benchmark::CountAlloc(__libc_calloc(count, size));
+}
+
+void* realloc(void* ptr, size_t size) __THROW {
+  const int64_t old_size = benchmark::CountedBlockSize(ptr);
+  void* new_ptr = __libc_realloc(ptr, size);
+  // On failure, the old block is left as it was, unless it was freed by
+  // asking for no bytes.
+  if (new_ptr != nullptr || size == 0) {
+    benchmark::CountFree(old_size);
+  }
+  return benchmark::CountAlloc(new_ptr);
+}
+
+void* reallocarray(void* ptr, size_t count, size_t size) __THROW {
+  size_t bytes = 0;
+  if (__builtin_mul_overflow(count, size, &bytes)) {
+    errno = ENOMEM;
+    return nullptr;
+  }
+  return realloc(ptr, bytes);
+}
+
+void free(void* ptr) __THROW {
+  benchmark::CountFree(benchmark::CountedBlockSize(ptr));
+  __libc_free(ptr);
+}
+
+void* memalign(size_t alignment, size_t size) __THROW {
+  return benchmark::CountAlloc(__libc_memalign(alignment, size));
+}
+
+void* aligned_alloc(size_t alignment, size_t size) __THROW {
+  if (!benchmark::IsValidAlignment(alignment)) {
+    errno = EINVAL;
+    return nullptr;
+  }
+  return memalign(alignment, size);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) __THROW {
+  if (!benchmark::IsValidAlignment(alignment) ||
+      alignment % sizeof(void*) != 0) {
+    return EINVAL;
+  }
+  void* ptr = memalign(alignment, size);
+  if (ptr == nullptr) {
+    return ENOMEM;
+  }
+  *result = ptr;
+  return 0;
+}
+
+void* valloc(size_t size) __THROW {
+  return memalign(static_cast<size_t>(sysconf(_SC_PAGESIZE)), size);
+}
+
+void* pvalloc(size_t size) __THROW {
+  const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return memalign(page_size, (size + page_size - 1) & ~(page_size - 1));
+}
+
+}  // extern "C"
@@ -32,6 +32,7 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <sstream>
@@ -150,6 +151,7 @@ bool BenchmarkFamilies::FindBenchmarks(
       continue;
     }
 
+    family->ExpandCacheSweeps();
     if (family->ArgsCnt() == -1) {
       family->Args({});
     }
@@ -171,10 +173,11 @@ bool BenchmarkFamilies::FindBenchmarks(
       benchmarks->reserve(benchmarks->size() + family_size);
     }
 
-    for (auto const& args : family->args_) {
+    for (size_t args_index = 0; args_index < family->args_.size();
+         ++args_index) {
       for (int num_threads : *thread_counts) {
         BenchmarkInstance instance(family.get(), family_index,
-                                   per_family_instance_index, args,
+                                   per_family_instance_index, args_index,
                                    num_threads);
 
         const auto full_name = instance.name().str();
@@ -232,8 +235,12 @@ Benchmark::Benchmark(const std::string& name)
       measure_process_cpu_time_(false),
       use_real_time_(false),
       use_manual_time_(false),
+      use_cycle_clock_(false),
+      record_latency_distribution_(false),
       complexity_(oNone),
-      complexity_lambda_(nullptr) {
+      complexity_lambda_(nullptr),
+      thread_affinity_(kAffinityNone),
+      use_default_thread_affinity_(true) {
   ComputeStatistics("mean", StatisticsMean);
   ComputeStatistics("median", StatisticsMedian);
   ComputeStatistics("stddev", StatisticsStdDev);
@@ -333,6 +340,12 @@ Benchmark* Benchmark::DenseRange(int64_t start, int64_t limit, int step) {
   return this;
 }
 
+Benchmark* Benchmark::CacheSweep(int64_t bytes_per_element) {
+  BM_CHECK(ArgsCnt() == -1 || ArgsCnt() == 1);
+  cache_sweeps_.emplace_back(args_.size(), bytes_per_element);
+  return this;
+}
+
 Benchmark* Benchmark::Args(const std::vector<int64_t>& args) {
   BM_CHECK(ArgsCnt() == -1 || ArgsCnt() == static_cast<int>(args.size()));
   args_.push_back(args);
@@ -428,6 +441,8 @@ Benchmark* Benchmark::DisplayAggregatesOnly(bool value) {
 
 Benchmark* Benchmark::MeasureProcessCPUTime() {
   // Can be used together with UseRealTime() / UseManualTime().
+  BM_CHECK(!use_cycle_clock_)
+      << "Cannot set MeasureProcessCPUTime and UseCycleClock simultaneously.";
   measure_process_cpu_time_ = true;
   return this;
 }
@@ -442,10 +457,26 @@ Benchmark* Benchmark::UseRealTime() {
 Benchmark* Benchmark::UseManualTime() {
   BM_CHECK(!use_real_time_)
       << "Cannot set UseRealTime and UseManualTime simultaneously.";
+  BM_CHECK(!use_cycle_clock_)
+      << "Cannot set UseCycleClock and UseManualTime simultaneously.";
   use_manual_time_ = true;
   return this;
 }
 
+Benchmark* Benchmark::UseCycleClock() {
+  BM_CHECK(!use_manual_time_)
+      << "Cannot set UseCycleClock and UseManualTime simultaneously.";
+  BM_CHECK(!measure_process_cpu_time_)
+      << "Cannot set MeasureProcessCPUTime and UseCycleClock simultaneously.";
+  use_cycle_clock_ = true;
+  return this;
+}
+
+Benchmark* Benchmark::RecordLatencyDistribution() {
+  record_latency_distribution_ = true;
+  return this;
+}
+
 Benchmark* Benchmark::Complexity(BigO complexity) {
   complexity_ = complexity;
   return this;
@@ -501,12 +532,28 @@ Benchmark* Benchmark::ThreadRunner(threadrunner_factory&& factory) {
   return this;
 }
 
+Benchmark* Benchmark::ThreadAffinity(ThreadAffinityPolicy policy) {
+  thread_affinity_ = policy;
+  use_default_thread_affinity_ = false;
+  return this;
+}
+
+Benchmark* Benchmark::MemoryPolicy(NumaPolicy policy) {
+  BM_CHECK(policy.mode != NumaPolicy::kNode || policy.node >= 0)
+      << "NUMA node must be non-negative.";
+  memory_policy_ = policy;
+  return this;
+}
+
 void Benchmark::SetName(const std::string& name) { name_ = name; }
 
 const char* Benchmark::GetName() const { return name_.c_str(); }
 
 int Benchmark::ArgsCnt() const {
   if (args_.empty()) {
+    if (!cache_sweeps_.empty()) {
+      return 1;
+    }
     if (arg_names_.empty()) {
       return -1;
     }
@@ -515,6 +562,34 @@ int Benchmark::ArgsCnt() const {
   return static_cast<int>(args_.front().size());
 }
 
+void Benchmark::ExpandCacheSweeps() {
+  if (cache_sweeps_.empty()) {
+    return;
+  }
+  const CPUInfo& info = CPUInfo::Get();
+  const std::vector<internal::CacheSweepLevel> levels =
+      internal::GetCacheSweepLevels(info.caches, info.tlb_reach);
+  std::vector<std::vector<int64_t>> args;
+  auto sweep = cache_sweeps_.begin();
+  for (size_t i = 0; i <= args_.size(); ++i) {
+    for (; sweep != cache_sweeps_.end() && sweep->first == i; ++sweep) {
+      const int64_t bytes_per_element = sweep->second;
+      for (const auto& point :
+           internal::CreateCacheSweep(levels, bytes_per_element)) {
+        working_set_names_[args.size()] = point.first;
+        working_set_descriptions_[args.size()] = internal::DescribeWorkingSet(
+            levels, point.second * bytes_per_element);
+        args.push_back({point.second});
+      }
+    }
+    if (i < args_.size()) {
+      args.push_back(std::move(args_[i]));
+    }
+  }
+  args_ = std::move(args);
+  cache_sweeps_.clear();
+}
+
 const char* Benchmark::GetArgName(int arg) const {
   BM_CHECK_GE(arg, 0);
   size_t uarg = static_cast<size_t>(arg);
@@ -526,8 +601,102 @@ TimeUnit Benchmark::GetTimeUnit() const {
   return use_default_time_unit_ ? GetDefaultTimeUnit() : time_unit_;
 }
 
+ThreadAffinityPolicy Benchmark::GetThreadAffinity() const {
+  return use_default_thread_affinity_ ? GetDefaultThreadAffinity()
+                                      : thread_affinity_;
+}
+
 namespace internal {
 
+//=============================================================================//
+//                              CacheSweep
+//=============================================================================//
+
+std::vector<CacheSweepLevel> GetCacheSweepLevels(
+    const std::vector<CPUInfo::CacheInfo>& caches, int64_t tlb_reach) {
+  std::map<int, int64_t> sizes;
+  for (const CPUInfo::CacheInfo& cache : caches) {
+    if ((cache.type == "Data" || cache.type == "Unified") && cache.size > 0) {
+      int64_t& size = sizes[cache.level];
+      size = std::max(size, static_cast<int64_t>(cache.size));
+    }
+  }
+  if (sizes.empty()) {
+    sizes = {{1, int64_t{32} << 10},
+             {2, int64_t{1} << 20},
+             {3, int64_t{32} << 20}};
+  }
+
+  std::vector<CacheSweepLevel> levels;
+  for (const auto& size : sizes) {
+    levels.push_back({StrFormat("L%d", size.first), size.second});
+  }
+  if (tlb_reach > 0) {
+    levels.push_back({"TLB", tlb_reach});
+  }
+  std::stable_sort(levels.begin(), levels.end(),
+                   [](const CacheSweepLevel& a, const CacheSweepLevel& b) {
+                     return a.bytes < b.bytes;
+                   });
+  return levels;
+}
+
+std::vector<std::pair<std::string, int64_t>> CreateCacheSweep(
+    const std::vector<CacheSweepLevel>& levels, int64_t bytes_per_element) {
+  BM_CHECK_GT(bytes_per_element, 0);
+  std::vector<std::pair<std::string, int64_t>> sweep;
+  for (const CacheSweepLevel& level : levels) {
+    const std::pair<std::string, int64_t> points[] = {
+        {"below_" + level.name, level.bytes / 2},
+        {level.name, level.bytes},
+        {"above_" + level.name, level.bytes * 2}};
+    for (const auto& point : points) {
+      const int64_t elements =
+          std::max<int64_t>(point.second / bytes_per_element, 1);
+      // Levels close in size, such as the L2 cache and the TLB reach, may
+      // generate the same working sets.
+      if (std::none_of(sweep.begin(), sweep.end(), [&](const auto& other) {
+            return other.second == elements;
+          })) {
+        sweep.emplace_back(point.first, elements);
+      }
+    }
+  }
+  std::stable_sort(sweep.begin(), sweep.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.second < b.second;
+                   });
+  return sweep;
+}
+
+std::string DescribeWorkingSet(const std::vector<CacheSweepLevel>& levels,
+                               int64_t bytes) {
+  const CacheSweepLevel* fits = nullptr;
+  const CacheSweepLevel* largest = nullptr;
+  const CacheSweepLevel* tlb = nullptr;
+  for (const CacheSweepLevel& level : levels) {
+    if (level.name == "TLB") {
+      tlb = &level;
+      continue;
+    }
+    if (fits == nullptr && bytes <= level.bytes) {
+      fits = &level;
+    }
+    largest = &level;
+  }
+
+  std::string description;
+  if (fits != nullptr) {
+    description = "fits in " + fits->name;
+  } else if (largest != nullptr) {
+    description = "exceeds " + largest->name;
+  }
+  if (tlb != nullptr && bytes > tlb->bytes) {
+    description += ", exceeds TLB reach";
+  }
+  return description;
+}
+
 //=============================================================================//
 //                            FunctionBenchmark
 //=============================================================================//
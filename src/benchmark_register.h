@@ -2,10 +2,15 @@
 #define BENCHMARK_REGISTER_H
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
+#include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "benchmark/export.h"
+#include "benchmark/sysinfo.h"
 #include "check.h"
 
 namespace benchmark {
@@ -104,6 +109,33 @@ void AddRange(std::vector<T>* dst, T lo, T hi, int mult) {
   }
 }
 
+// A working set size beyond which memory accesses get slower: the capacity of
+// a cache level, named "L1", "L2"..., or the TLB reach, named "TLB".
+struct CacheSweepLevel {
+  std::string name;
+  int64_t bytes;
+};
+
+// Returns the levels of the data caches in `caches` and the TLB reach, if it
+// is not 0, in increasing order of size. Typical sizes are assumed for the
+// caches if none are known.
+BENCHMARK_EXPORT
+std::vector<CacheSweepLevel> GetCacheSweepLevels(
+    const std::vector<CPUInfo::CacheInfo>& caches, int64_t tlb_reach);
+
+// Returns the numbers of elements of `bytes_per_element` bytes that make
+// working sets of half, once and twice the size of each level, named
+// "below_<level>", "<level>" and "above_<level>", in increasing order.
+BENCHMARK_EXPORT
+std::vector<std::pair<std::string, int64_t>> CreateCacheSweep(
+    const std::vector<CacheSweepLevel>& levels, int64_t bytes_per_element);
+
+// Describes the smallest cache level that a working set of `bytes` fits in,
+// and whether it exceeds the TLB reach.
+BENCHMARK_EXPORT
+std::string DescribeWorkingSet(const std::vector<CacheSweepLevel>& levels,
+                               int64_t bytes);
+
 }  // namespace internal
 }  // namespace benchmark
 
@@ -18,6 +18,7 @@
 #include "benchmark/managers.h"
 #include "benchmark/reporter.h"
 #include "benchmark/state.h"
+#include "benchmark/sysinfo.h"
 #include "benchmark/types.h"
 #include "benchmark_api_internal.h"
 #include "internal_macros.h"
@@ -33,6 +34,7 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cctype>
 #include <climits>
 #include <cmath>
 #include <condition_variable>
@@ -44,7 +46,6 @@
 #include <limits>
 #include <memory>
 #include <string>
-#include <thread>
 #include <utility>
 
 #include "check.h"
@@ -52,24 +53,37 @@
 #include "commandlineflags.h"
 #include "complexity.h"
 #include "counter.h"
+#include "latency_histogram.h"
 #include "log.h"
 #include "mutex.h"
+#include "numa.h"
 #include "perf_counters.h"
 #include "re.h"
+#include "sampling_profiler.h"
 #include "statistics.h"
 #include "string_util.h"
 #include "thread_manager.h"
+#include "thread_pool.h"
 #include "thread_timer.h"
+#include "timer_overhead.h"
+#include "timers.h"
 
 namespace benchmark {
 
 BM_DECLARE_bool(benchmark_dry_run);
 BM_DECLARE_string(benchmark_min_time);
 BM_DECLARE_double(benchmark_min_warmup_time);
+BM_DECLARE_double(benchmark_target_rel_error);
+BM_DECLARE_double(benchmark_max_time);
 BM_DECLARE_int32(benchmark_repetitions);
 BM_DECLARE_bool(benchmark_report_aggregates_only);
 BM_DECLARE_bool(benchmark_display_aggregates_only);
 BM_DECLARE_string(benchmark_perf_counters);
+BM_DECLARE_bool(benchmark_perf_counters_per_thread);
+BM_DECLARE_bool(benchmark_report_release_skew);
+BM_DECLARE_string(benchmark_timer_overhead);
+BM_DECLARE_bool(benchmark_sample_profile);
+BM_DECLARE_string(benchmark_out);
 
 namespace internal {
 
@@ -80,9 +94,37 @@ ProfilerManager* profiler_manager = nullptr;
 namespace {
 
 constexpr IterationCount kMaxIterations = 1000000000000;
+// Of the sampling profiler, in samples per second of CPU time. Not a round
+// number, so as not to sample in lockstep with periodic activity.
+constexpr int kSamplingFrequency = 997;
 const double kDefaultMinTime =
     std::strtod(::benchmark::kDefaultMinTimeStr, /*p_end*/ nullptr);
 
+// When aiming for a target relative error, each repetition is measured as a
+// sequence of sub-batches of (at most) this many seconds each, and at least
+// kMinSubBatches of them are taken before the error estimate is trusted.
+constexpr double kSubBatchTime = 0.01;
+constexpr size_t kMinSubBatches = 5;
+
+// The percentiles reported for benchmarks that record their latency
+// distribution, along with the name of the counter they are reported as.
+const std::pair<double, const char*> kLatencyPercentiles[] = {
+    {50.0, "latency_p50"}, {99.0, "latency_p99"}, {99.9, "latency_p99.9"}};
+
+void AddLatencyPercentiles(const LatencyHistogram& histogram,
+                           UserCounters* counters) {
+  if (histogram.empty()) {
+    return;
+  }
+  // The histogram is kept in cycle clock ticks, report seconds.
+  const double seconds_per_tick = 1.0 / CPUInfo::Get().cycles_per_second;
+  for (const auto& percentile : kLatencyPercentiles) {
+    (*counters)[percentile.second] =
+        Counter(histogram.ValueAtPercentile(percentile.first) *
+                seconds_per_tick);
+  }
+}
+
 BenchmarkReporter::Run CreateRunReport(
     const benchmark::internal::BenchmarkInstance& b,
     const internal::ThreadManager::Result& results,
@@ -97,7 +139,9 @@ BenchmarkReporter::Run CreateRunReport(
   report.per_family_instance_index = b.per_family_instance_index();
   report.skipped = results.skipped_;
   report.skip_message = results.skip_message_;
-  report.report_label = results.report_label_;
+  report.report_label = results.report_label_.empty()
+                            ? b.working_set_description()
+                            : results.report_label_;
   // This is the total iterations across all threads.
   report.iterations = results.iterations;
   report.time_unit = b.time_unit();
@@ -118,6 +162,22 @@ BenchmarkReporter::Run CreateRunReport(
     report.complexity_lambda = b.complexity_lambda();
     report.statistics = &b.statistics();
     report.counters = results.counters;
+    AddLatencyPercentiles(results.latency_histogram, &report.counters);
+    if (FLAGS_benchmark_report_release_skew && b.threads() > 1) {
+      report.counters["release_skew"] =
+          Counter(static_cast<double>(results.release_skew_cycles) /
+                  CPUInfo::Get().cycles_per_second);
+    }
+    if (results.numa_distance >= 0) {
+      report.counters["numa_distance"] =
+          Counter(results.numa_distance / b.threads());
+    }
+    // Below 1 if the kernel multiplexed the perf counters, which were then
+    // scaled up from a sample of the run.
+    if (results.perf_time_enabled > 0) {
+      report.counters["perf_running_fraction"] = Counter(
+          results.perf_time_running / results.perf_time_enabled);
+    }
 
     if (memory_iterations > 0) {
       report.memory_result = memory_result;
@@ -140,7 +200,7 @@ BenchmarkReporter::Run CreateRunReport(
 }
 
 // Execute one thread of benchmark b for the specified number of iterations.
-// Adds the stats collected for the thread into manager->results.
+// Stores the stats collected for the thread in its slot of the manager.
 void RunInThread(const BenchmarkInstance* b, IterationCount iters,
                  int thread_id, ThreadManager* manager,
                  PerfCountersMeasurement* perf_counters_measurement,
@@ -149,7 +209,46 @@ void RunInThread(const BenchmarkInstance* b, IterationCount iters,
       b->measure_process_cpu_time()
           ? internal::ThreadTimer::CreateProcessCpuTime()
           : internal::ThreadTimer::Create());
+  internal::ThreadManager::Result& results =
+      manager->GetThreadResult(thread_id);
+  if (b->use_cycle_clock()) {
+    timer.UseCycleClock();
+  }
+  if (b->record_latency_distribution()) {
+    timer.RecordLatencyInto(&results.latency_histogram);
+  }
 
+  // Counters only count the thread that opened them (and the threads it
+  // starts later on), so every thread of a multi-threaded benchmark opens its
+  // own.
+  std::unique_ptr<PerfCountersMeasurement> thread_perf_counters;
+  if (b->threads() > 1 && perf_counters_measurement != nullptr &&
+      perf_counters_measurement->num_counters() > 0) {
+    thread_perf_counters = std::make_unique<PerfCountersMeasurement>(
+        perf_counters_measurement->names());
+    perf_counters_measurement = thread_perf_counters.get();
+  }
+
+  ScopedMemoryPolicy memory_policy(b->memory_policy());
+  // The distance is unknown under the default policy, so do not pay for
+  // finding the node the thread runs on.
+  if (b->memory_policy().mode != NumaPolicy::kDefault) {
+    results.numa_distance = NumaDistanceToData(
+        b->memory_policy(), GetCurrentNumaNode(),
+        b->memory_policy().mode == NumaPolicy::kInterleave
+            ? GetAllowedMemoryNodes()
+            : std::vector<int>(),
+        CPUInfo::Get().numa_distances);
+  }
+
+  const double perf_time_enabled =
+      perf_counters_measurement != nullptr
+          ? perf_counters_measurement->time_enabled()
+          : 0;
+  const double perf_time_running =
+      perf_counters_measurement != nullptr
+          ? perf_counters_measurement->time_running()
+          : 0;
   State st = b->Run(iters, thread_id, &timer, manager,
                     perf_counters_measurement, profiler_manager_);
   if (!(st.skipped() || st.iterations() >= st.max_iterations)) {
@@ -157,19 +256,56 @@ void RunInThread(const BenchmarkInstance* b, IterationCount iters,
         "The benchmark didn't run, nor was it explicitly skipped. Please call "
         "'SkipWithXXX` in your benchmark as appropriate.");
   }
-  {
-    MutexLock l(manager->GetBenchmarkMutex());
-    internal::ThreadManager::Result& results = manager->results;
-    results.iterations += st.iterations();
-    results.cpu_time_used += timer.cpu_time_used();
-    results.real_time_used += timer.real_time_used();
-    results.manual_time_used += timer.manual_time_used();
-    results.complexity_n += st.complexity_length_n();
-    internal::Increment(&results.counters, st.counters);
+  if (thread_perf_counters != nullptr &&
+      FLAGS_benchmark_perf_counters_per_thread && st.iterations() > 0) {
+    // Per iteration of this thread, which the flags of a counter cannot
+    // express, so it is divided here.
+    const double iterations = static_cast<double>(st.iterations());
+    for (const std::string& name : thread_perf_counters->names()) {
+      st.counters[StrCat(name, "/thread:", thread_id)] =
+          Counter(st.counters[name].value / iterations);
+    }
+  }
+
+  double real_time_used = timer.real_time_used();
+  double cpu_time_used = timer.cpu_time_used();
+  if (FLAGS_benchmark_timer_overhead == "subtract") {
+    SubtractTimerOverhead(*b, st.iterations(), timer.intervals(),
+                          &real_time_used, &cpu_time_used);
+  }
+  results.iterations += st.iterations();
+  results.cpu_time_used += cpu_time_used;
+  results.real_time_used += real_time_used;
+  results.manual_time_used += timer.manual_time_used();
+  results.complexity_n += st.complexity_length_n();
+  internal::Increment(&results.counters, st.counters);
+  if (perf_counters_measurement != nullptr) {
+    results.perf_time_enabled +=
+        perf_counters_measurement->time_enabled() - perf_time_enabled;
+    results.perf_time_running +=
+        perf_counters_measurement->time_running() - perf_time_running;
   }
   manager->NotifyThreadComplete();
 }
 
+// Adds the measurements of another run of the same benchmark into `results`.
+void AccumulateResults(const internal::ThreadManager::Result& other,
+                       internal::ThreadManager::Result* results) {
+  internal::Merge(&results->counters, results->iterations, other.counters,
+                  other.iterations);
+  results->iterations += other.iterations;
+  results->cpu_time_used += other.cpu_time_used;
+  results->real_time_used += other.real_time_used;
+  results->manual_time_used += other.manual_time_used;
+  results->complexity_n = other.complexity_n;
+  results->latency_histogram.Merge(other.latency_histogram);
+  results->release_skew_cycles =
+      std::max(results->release_skew_cycles, other.release_skew_cycles);
+  results->numa_distance = other.numa_distance;
+  results->perf_time_enabled += other.perf_time_enabled;
+  results->perf_time_running += other.perf_time_running;
+}
+
 double ComputeMinTime(const benchmark::internal::BenchmarkInstance& b,
                       const BenchTimeType& iters_or_time) {
   if (!IsZero(b.min_time())) {
@@ -196,37 +332,31 @@ IterationCount ComputeIters(const benchmark::internal::BenchmarkInstance& b,
   return iters_or_time.iters;
 }
 
+// Runs the threads of a benchmark on the process-wide pool of workers, which
+// are kept around across repetitions and instances.
 class ThreadRunnerDefault : public ThreadRunnerBase {
  public:
-  explicit ThreadRunnerDefault(int num_threads)
-      : pool(static_cast<size_t>(num_threads - 1)) {}
+  ThreadRunnerDefault(int num_threads, std::vector<int> cpus)
+      : num_threads_(num_threads), cpus_(std::move(cpus)) {}
 
   void RunThreads(const std::function<void(int)>& fn) override final {
-    // Run all but one thread in separate threads
-    for (std::size_t ti = 0; ti < pool.size(); ++ti) {
-      pool[ti] = std::thread(fn, static_cast<int>(ti + 1));
-    }
-    // And run one thread here directly.
-    // (If we were asked to run just one thread, we don't create new threads.)
-    // Yes, we need to do this here *after* we start the separate threads.
-    fn(0);
-
-    // The main thread has finished. Now let's wait for the other threads.
-    for (std::thread& thread : pool) {
-      thread.join();
-    }
+    ThreadPool::Get().Run(num_threads_, fn, cpus_);
   }
 
  private:
-  std::vector<std::thread> pool;
+  const int num_threads_;
+  // The CPUs to pin the threads to, if any.
+  const std::vector<int> cpus_;
 };
 
 std::unique_ptr<ThreadRunnerBase> GetThreadRunner(
-    const benchmark::threadrunner_factory& userThreadRunnerFactory,
-    int num_threads) {
+    const BenchmarkInstance& b) {
+  const benchmark::threadrunner_factory& userThreadRunnerFactory =
+      b.GetUserThreadRunnerFactory();
   return userThreadRunnerFactory
-             ? userThreadRunnerFactory(num_threads)
-             : std::make_unique<ThreadRunnerDefault>(num_threads);
+             ? userThreadRunnerFactory(b.threads())
+             : std::make_unique<ThreadRunnerDefault>(b.threads(),
+                                                     b.affinity_cpus());
 }
 
 }  // end namespace
@@ -283,7 +413,8 @@ BenchTimeType ParseBenchMinTime(const std::string& value) {
 
 BenchmarkRunner::BenchmarkRunner(
     const benchmark::internal::BenchmarkInstance& b_,
-    PerfCountersMeasurement* pcm_,
+    PerfCountersMeasurement* pcm_, const PerfMetrics* perf_metrics_,
+    const Roofline* roofline_,
     BenchmarkReporter::PerFamilyRunReports* reports_for_family_)
     : b(b_),
       reports_for_family(reports_for_family_),
@@ -297,6 +428,10 @@ BenchmarkRunner::BenchmarkRunner(
               : ((!IsZero(b.min_time()) && b.min_warmup_time() > 0.0)
                      ? b.min_warmup_time()
                      : FLAGS_benchmark_min_warmup_time)),
+      target_rel_error(FLAGS_benchmark_dry_run
+                           ? 0.0
+                           : std::max(FLAGS_benchmark_target_rel_error, 0.0)),
+      max_time(FLAGS_benchmark_max_time),
       warmup_done(FLAGS_benchmark_dry_run ? true : !(min_warmup_time > 0.0)),
       repeats(FLAGS_benchmark_dry_run
                   ? 1
@@ -305,14 +440,15 @@ BenchmarkRunner::BenchmarkRunner(
       has_explicit_iteration_count(b.iterations() != 0 ||
                                    parsed_benchtime_flag.tag ==
                                        BenchTimeType::ITERS),
-      thread_runner(
-          GetThreadRunner(b.GetUserThreadRunnerFactory(), b.threads())),
+      thread_runner(GetThreadRunner(b)),
       iters(FLAGS_benchmark_dry_run
                 ? 1
                 : (has_explicit_iteration_count
                        ? ComputeIters(b_, parsed_benchtime_flag)
                        : 1)),
-      perf_counters_measurement_ptr(pcm_) {
+      perf_counters_measurement_ptr(pcm_),
+      perf_metrics(perf_metrics_),
+      roofline(roofline_) {
   run_results.display_report_aggregates_only =
       (FLAGS_benchmark_report_aggregates_only ||
        FLAGS_benchmark_display_aggregates_only);
@@ -342,12 +478,9 @@ BenchmarkRunner::IterationResults BenchmarkRunner::DoNIterations() {
                 perf_counters_measurement_ptr, /*profiler_manager=*/nullptr);
   });
 
+  // All threads are done, so their results can be combined.
   IterationResults i;
-  // Acquire the measurements/counters from the manager, UNDER THE LOCK!
-  {
-    MutexLock l(manager->GetBenchmarkMutex());
-    i.results = manager->results;
-  }
+  i.results = manager->GetResults();
 
   // And get rid of the manager.
   manager.reset();
@@ -416,7 +549,58 @@ double BenchmarkRunner::GetMinTimeToApply() const {
   // min_time or min_warmup_time. This function will figure out if we are in the
   // warmup phase and therefore need to apply min_warmup_time or if we already
   // in the benchmarking phase and min_time needs to be applied.
-  return warmup_done ? min_time : min_warmup_time;
+  if (!warmup_done) {
+    return min_warmup_time;
+  }
+  // With a target relative error, min_time only bounds the length of a single
+  // sub-batch; how many of them are run is decided by RunUntilTargetRelError.
+  return target_rel_error > 0.0 ? std::min(min_time, kSubBatchTime)
+                                : min_time;
+}
+
+void BenchmarkRunner::RunUntilTargetRelError(IterationResults* i) {
+  // Every sub-batch runs the same number of iterations, so each yields one
+  // sample of the per-iteration time.
+  std::vector<double> samples;
+  samples.push_back(i->seconds / static_cast<double>(i->iters));
+  const double start = ChronoClockNow();
+
+  // The other repetitions run as many sub-batches as the first one, so that
+  // they all have the same iteration count, which the aggregates rely on.
+  const bool is_the_first_repetition = num_sub_batches == 0;
+  auto needs_more = [&](double rel_error) {
+    return is_the_first_repetition
+               ? samples.size() < kMinSubBatches || rel_error > target_rel_error
+               : samples.size() < num_sub_batches;
+  };
+
+  double rel_error = StatisticsMeanRelativeError(samples);
+  while (needs_more(rel_error)) {
+    if (is_the_first_repetition && ChronoClockNow() - start >= max_time) {
+      BM_VLOG(1) << b.name().str() << ": reached --benchmark_max_time with a "
+                 << "relative error of " << rel_error << "\n";
+      break;
+    }
+
+    b.Setup();
+    IterationResults next = DoNIterations();
+    b.Teardown();
+
+    if (next.results.skipped_ != 0u) {
+      *i = next;
+      return;
+    }
+
+    samples.push_back(next.seconds / static_cast<double>(next.iters));
+    AccumulateResults(next.results, &i->results);
+    i->iters += next.iters;
+    i->seconds += next.seconds;
+    rel_error = StatisticsMeanRelativeError(samples);
+  }
+
+  BM_VLOG(2) << "Took " << samples.size() << " sub-batches for a relative "
+             << "error of " << rel_error << "\n";
+  num_sub_batches = samples.size();
 }
 
 void BenchmarkRunner::FinishWarmUp(const IterationCount& i) {
@@ -477,22 +661,59 @@ MemoryManager::Result BenchmarkRunner::RunMemoryManager(
   return memory_result;
 }
 
-void BenchmarkRunner::RunProfilerManager(IterationCount profile_iterations) {
-  std::unique_ptr<internal::ThreadManager> manager;
-  manager.reset(new internal::ThreadManager(1));
+void BenchmarkRunner::RunProfilerManager(ProfilerManager* manager,
+                                         IterationCount profile_iterations) {
+  std::unique_ptr<internal::ThreadManager> thread_manager;
+  thread_manager.reset(new internal::ThreadManager(1));
   b.Setup();
-  RunInThread(&b, profile_iterations, 0, manager.get(),
+  RunInThread(&b, profile_iterations, 0, thread_manager.get(),
               /*perf_counters_measurement_ptr=*/nullptr,
-              /*profiler_manager=*/profiler_manager);
-  manager.reset();
+              /*profiler_manager=*/manager);
+  thread_manager.reset();
   b.Teardown();
 }
 
+void BenchmarkRunner::RunSamplingProfiler(IterationCount profile_iterations) {
+  SamplingProfiler profiler(kSamplingFrequency);
+  if (!profiler.ok()) {
+    return;
+  }
+  RunProfilerManager(&profiler, profile_iterations);
+
+  std::string file_name = b.name().str();
+  for (char& c : file_name) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' &&
+        c != '.') {
+      c = '_';
+    }
+  }
+  const std::string path =
+      StrCat(FLAGS_benchmark_out.empty() ? "benchmark" : FLAGS_benchmark_out,
+             ".", file_name, ".folded");
+  std::string error;
+  if (!profiler.WriteFolded(path, &error)) {
+    GetErrorLogInstance() << "***WARNING*** Failed to write the profile '"
+                          << path << "': " << error << "\n";
+  } else if (profiler.num_lost() > 0) {
+    GetErrorLogInstance() << "***WARNING*** The profile '" << path
+                          << "' is missing " << profiler.num_lost()
+                          << " samples.\n";
+  }
+}
+
 void BenchmarkRunner::DoOneRepetition() {
   assert(HasRepeatsRemaining() && "Already done all repetitions?");
 
   const bool is_the_first_repetition = num_repetitions_done == 0;
 
+  // With the perf counters split into groups, each repetition counts the next
+  // group.
+  if (perf_counters_measurement_ptr != nullptr) {
+    perf_counters_measurement_ptr->SelectGroup(
+        static_cast<size_t>(num_repetitions_done) %
+        perf_counters_measurement_ptr->num_groups());
+  }
+
   // In case a warmup phase is requested by the benchmark, run it now.
   // After running the warmup phase the BenchmarkRunner should be in a state as
   // this warmup never happened except the fact that warmup_done is set. Every
@@ -536,6 +757,13 @@ void BenchmarkRunner::DoOneRepetition() {
            "then we should have accepted the current iteration run.");
   }
 
+  // The run above is only the first sub-batch if we are aiming for a target
+  // relative error; keep sampling until the estimate is tight enough.
+  if (target_rel_error > 0.0 && !has_explicit_iteration_count &&
+      i.results.skipped_ == 0u) {
+    RunUntilTargetRelError(&i);
+  }
+
   // Produce memory measurements if requested.
   MemoryManager::Result memory_result;
   IterationCount memory_iterations = 0;
@@ -550,13 +778,28 @@ void BenchmarkRunner::DoOneRepetition() {
     // We want to externally profile the benchmark for the same number of
     // iterations because, for example, if we're tracing the benchmark then we
     // want trace data to reasonably match PMU data.
-    RunProfilerManager(iters);
+    RunProfilerManager(profiler_manager, iters);
+  }
+
+  if (FLAGS_benchmark_sample_profile && is_the_first_repetition) {
+    RunSamplingProfiler(iters);
   }
 
   // Ok, now actually report.
   BenchmarkReporter::Run report =
       CreateRunReport(b, i.results, memory_iterations, memory_result, i.seconds,
                       num_repetitions_done, repeats);
+  if (perf_metrics != nullptr && report.skipped == 0u) {
+    // The perf counters are per iteration of any thread.
+    perf_metrics->Compute(
+        &report.counters,
+        report.iterations > 0 ? report.cpu_accumulated_time /
+                                    static_cast<double>(report.iterations)
+                              : 0.0);
+  }
+  if (roofline != nullptr && report.skipped == 0u) {
+    roofline->Compute(b.threads(), &report.counters);
+  }
 
   if (reports_for_family != nullptr) {
     ++reports_for_family->num_runs_done;
@@ -570,6 +813,49 @@ void BenchmarkRunner::DoOneRepetition() {
   ++num_repetitions_done;
 }
 
+void BenchmarkRunner::AdoptRuns(std::vector<BenchmarkReporter::Run>&& runs,
+                                const std::string& failure) {
+  for (int64_t index = num_repetitions_done; index < repeats; ++index) {
+    BenchmarkReporter::Run report;
+    const size_t run_index = static_cast<size_t>(index - num_repetitions_done);
+    if (run_index < runs.size()) {
+      report = std::move(runs[run_index]);
+      // These point into the registration, which the producer of the run may
+      // not share with us.
+      report.run_name = b.name();
+      if (report.skipped == 0u) {
+        report.statistics = &b.statistics();
+        report.complexity_lambda = b.complexity_lambda();
+      }
+    } else {
+      internal::ThreadManager::Result results;
+      results.skipped_ = internal::SkippedWithError;
+      results.skip_message_ = failure;
+      report = CreateRunReport(b, results, 0, MemoryManager::Result(), 0,
+                               index, repeats);
+    }
+
+    if (reports_for_family != nullptr) {
+      ++reports_for_family->num_runs_done;
+      if (report.skipped == 0u) {
+        reports_for_family->Runs.push_back(report);
+      }
+    }
+    run_results.non_aggregates.push_back(std::move(report));
+  }
+  num_repetitions_done = repeats;
+}
+
+void BenchmarkRunner::AddRepetitions(int count) {
+  repeats += count;
+  for (BenchmarkReporter::Run& run : run_results.non_aggregates) {
+    run.repetitions = repeats;
+  }
+  if (reports_for_family != nullptr) {
+    reports_for_family->num_runs_total += count;
+  }
+}
+
 RunResults&& BenchmarkRunner::GetResults() {
   assert(!HasRepeatsRemaining() && "Did not run all repetitions yet?");
 
@@ -21,6 +21,8 @@
 
 #include "benchmark_api_internal.h"
 #include "perf_counters.h"
+#include "perf_metrics.h"
+#include "roofline.h"
 #include "thread_manager.h"
 
 namespace benchmark {
@@ -53,6 +55,8 @@ class BenchmarkRunner {
  public:
   BenchmarkRunner(const benchmark::internal::BenchmarkInstance& b_,
                   benchmark::internal::PerfCountersMeasurement* pcm_,
+                  const PerfMetrics* perf_metrics_,
+                  const Roofline* roofline_,
                   BenchmarkReporter::PerFamilyRunReports* reports_for_family);
 
   int GetNumRepeats() const { return repeats; }
@@ -63,12 +67,32 @@ class BenchmarkRunner {
 
   void DoOneRepetition();
 
+  // Takes over the runs of all remaining repetitions, as produced by another
+  // runner for the same benchmark (e.g. in a child process). Repetitions for
+  // which no run was produced are reported as errors with `failure`.
+  void AdoptRuns(std::vector<BenchmarkReporter::Run>&& runs,
+                 const std::string& failure);
+
+  // Adds `count` repetitions to be run, e.g. when the results of the ones so
+  // far are not conclusive. The runs done so far are updated to the new
+  // number of repetitions.
+  void AddRepetitions(int count);
+
   RunResults&& GetResults();
 
+  // The runs of the repetitions done so far.
+  const std::vector<BenchmarkReporter::Run>& GetRuns() const {
+    return run_results.non_aggregates;
+  }
+
   BenchmarkReporter::PerFamilyRunReports* GetReportsForFamily() const {
     return reports_for_family;
   }
 
+  const benchmark::internal::BenchmarkInstance& GetBenchmarkInstance() const {
+    return b;
+  }
+
   double GetMinTime() const { return min_time; }
 
   bool HasExplicitIters() const { return has_explicit_iteration_count; }
@@ -84,8 +108,10 @@ class BenchmarkRunner {
   BenchTimeType parsed_benchtime_flag;
   const double min_time;
   const double min_warmup_time;
+  const double target_rel_error;  // 0 unless the adaptive stopping rule is on.
+  const double max_time;
   bool warmup_done;
-  const int repeats;
+  int repeats;
   const bool has_explicit_iteration_count;
 
   int num_repetitions_done = 0;
@@ -96,7 +122,13 @@ class BenchmarkRunner {
   // So only the first repetition has to find/calculate it,
   // the other repetitions will just use that precomputed iteration count.
 
+  // Likewise, the sub-batches of `iters` that the first repetition ran to
+  // reach the target relative error, 0 until then.
+  size_t num_sub_batches = 0;
+
   PerfCountersMeasurement* const perf_counters_measurement_ptr = nullptr;
+  const PerfMetrics* const perf_metrics = nullptr;
+  const Roofline* const roofline = nullptr;
 
   struct IterationResults {
     internal::ThreadManager::Result results;
@@ -107,12 +139,19 @@ class BenchmarkRunner {
 
   MemoryManager::Result RunMemoryManager(IterationCount memory_iterations);
 
-  void RunProfilerManager(IterationCount profile_iterations);
+  void RunProfilerManager(ProfilerManager* manager,
+                          IterationCount profile_iterations);
+
+  // Samples the call stacks of the benchmark, and writes them next to the
+  // output file.
+  void RunSamplingProfiler(IterationCount profile_iterations);
 
   IterationCount PredictNumItersNeeded(const IterationResults& i) const;
 
   bool ShouldReportIterationResults(const IterationResults& i) const;
 
+  void RunUntilTargetRelError(IterationResults* i);
+
   double GetMinTimeToApply() const;
 
   void FinishWarmUp(const IterationCount& i);
@@ -0,0 +1,199 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "checkpoint.h"
+
+#include "internal_macros.h"
+
+#ifndef BENCHMARK_OS_WINDOWS
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "log.h"
+#include "process_isolation.h"
+
+namespace benchmark {
+namespace internal {
+
+namespace {
+
+// Bump the version whenever the encoding of EncodeRun changes, so that old
+// checkpoints are rejected instead of misread.
+constexpr char kMagic[] = "benchmark checkpoint v1\n";
+constexpr size_t kMagicSize = sizeof(kMagic) - 1;
+
+}  // namespace
+
+Checkpoint::Checkpoint(std::string path) : path_(std::move(path)) {}
+
+Checkpoint::~Checkpoint() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+  }
+}
+
+void Checkpoint::Encode(const std::string& name,
+                        const BenchmarkReporter::Run& run, std::string* out) {
+  const uint32_t name_size = static_cast<uint32_t>(name.size());
+  char bytes[sizeof(name_size)];
+  std::memcpy(bytes, &name_size, sizeof(name_size));
+  out->append(bytes, sizeof(name_size));
+  out->append(name);
+  EncodeRun(run, out);
+}
+
+bool Checkpoint::Load() {
+  std::FILE* file = std::fopen(path_.c_str(), "rb");
+  if (file == nullptr) {
+    return true;
+  }
+  std::string data;
+  char buffer[4096];
+  size_t n = 0;
+  while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data.append(buffer, n);
+  }
+  std::fclose(file);
+
+  // An interrupted Start() may leave an empty file behind.
+  if (data.empty()) {
+    return true;
+  }
+  if (data.compare(0, kMagicSize, kMagic) != 0) {
+    return false;
+  }
+  const char* pos = data.data() + kMagicSize;
+  const char* end = data.data() + data.size();
+  while (pos != end) {
+    uint32_t name_size = 0;
+    if (static_cast<size_t>(end - pos) < sizeof(name_size)) {
+      break;
+    }
+    std::memcpy(&name_size, pos, sizeof(name_size));
+    pos += sizeof(name_size);
+    if (static_cast<size_t>(end - pos) < name_size) {
+      break;
+    }
+    std::string name(pos, name_size);
+    pos += name_size;
+    BenchmarkReporter::Run run;
+    if (!DecodeRun(&pos, end, &run)) {
+      break;
+    }
+    const Key key(std::move(name), run.family_index,
+                  run.per_family_instance_index);
+    loaded_[key][run.repetition_index] = std::move(run);
+  }
+  if (pos != end) {
+    BM_VLOG(1) << "Dropping a truncated record from checkpoint '" << path_
+               << "'\n";
+  }
+  return true;
+}
+
+bool Checkpoint::TakeRuns(const std::string& name, int64_t family_index,
+                          int64_t per_family_instance_index,
+                          int num_repetitions,
+                          std::vector<BenchmarkReporter::Run>* runs) {
+  auto it = loaded_.find(Key(name, family_index, per_family_instance_index));
+  if (it == loaded_.end()) {
+    return false;
+  }
+  const std::map<int64_t, BenchmarkReporter::Run>& by_repetition = it->second;
+  if (by_repetition.size() != static_cast<size_t>(num_repetitions)) {
+    return false;
+  }
+  int64_t expected_index = 0;
+  for (const auto& repetition : by_repetition) {
+    if (repetition.first != expected_index++ ||
+        repetition.second.repetitions != num_repetitions) {
+      return false;
+    }
+  }
+
+  runs->clear();
+  for (auto& repetition : it->second) {
+    Encode(name, repetition.second, &taken_);
+    runs->push_back(std::move(repetition.second));
+  }
+  loaded_.erase(it);
+  return true;
+}
+
+bool Checkpoint::Write(const std::string& data) {
+  if (std::fwrite(data.data(), 1, data.size(), file_) != data.size() ||
+      std::fflush(file_) != 0) {
+    return false;
+  }
+#ifndef BENCHMARK_OS_WINDOWS
+  fsync(fileno(file_));
+#endif
+  return true;
+}
+
+bool Checkpoint::Start() {
+  // Write the new file next to the old one and only then replace it, so that
+  // being interrupted here does not lose the runs in the old one.
+  const std::string temp_path = path_ + ".tmp";
+  file_ = std::fopen(temp_path.c_str(), "wb");
+  if (file_ == nullptr) {
+    return false;
+  }
+  if (!Write(std::string(kMagic, kMagicSize) + taken_)) {
+    std::fclose(file_);
+    file_ = nullptr;
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  std::fclose(file_);
+  file_ = nullptr;
+#ifdef BENCHMARK_OS_WINDOWS
+  std::remove(path_.c_str());
+#endif
+  if (std::rename(temp_path.c_str(), path_.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  file_ = std::fopen(path_.c_str(), "ab");
+  return file_ != nullptr;
+}
+
+void Checkpoint::Record(const BenchmarkReporter::Run& run) {
+  if (file_ == nullptr) {
+    return;
+  }
+  std::string data;
+  Encode(run.run_name.str(), run, &data);
+  if (!Write(data)) {
+    GetErrorLogInstance() << "***WARNING*** Failed to write to checkpoint '"
+                          << path_ << "', no further runs will be recorded\n";
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+}
+
+void Checkpoint::Remove() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+    file_ = nullptr;
+  }
+  std::remove(path_.c_str());
+}
+
+}  // namespace internal
+}  // namespace benchmark
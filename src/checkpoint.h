@@ -0,0 +1,88 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_CHECKPOINT_H_
+#define BENCHMARK_CHECKPOINT_H_
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "benchmark/export.h"
+#include "benchmark/reporter.h"
+
+namespace benchmark {
+namespace internal {
+
+// A file recording the runs of finished repetitions, so that a benchmark
+// binary that was interrupted can be restarted without redoing the benchmark
+// instances it already completed.
+//
+// The runs are stored in the encoding of EncodeRun, so a checkpoint can only
+// be resumed by the same benchmark binary on the same machine.
+class BENCHMARK_EXPORT Checkpoint {
+ public:
+  explicit Checkpoint(std::string path);
+  ~Checkpoint();
+
+  Checkpoint(const Checkpoint&) = delete;
+  Checkpoint& operator=(const Checkpoint&) = delete;
+
+  const std::string& path() const { return path_; }
+
+  // Reads the runs recorded by an earlier invocation. A missing file is an
+  // empty checkpoint, and a truncated last record is dropped. Returns false
+  // if the file exists but is not a checkpoint.
+  bool Load();
+
+  // If the runs of all `num_repetitions` repetitions of the benchmark
+  // instance were loaded, moves them into `runs`, ordered by repetition, and
+  // returns true. The name and both indices have to match, so that runs are
+  // never attributed to a different instance after the registered benchmarks
+  // changed.
+  bool TakeRuns(const std::string& name, int64_t family_index,
+                int64_t per_family_instance_index, int num_repetitions,
+                std::vector<BenchmarkReporter::Run>* runs);
+
+  // Replaces the file with one holding only the runs taken so far, and keeps
+  // it open for Record(). Returns false if the file cannot be written.
+  bool Start();
+
+  // Appends `run` to the file and syncs it to disk.
+  void Record(const BenchmarkReporter::Run& run);
+
+  // Closes and deletes the file, once its runs are no longer needed.
+  void Remove();
+
+ private:
+  using Key = std::tuple<std::string, int64_t, int64_t>;
+
+  static void Encode(const std::string& name, const BenchmarkReporter::Run& run,
+                     std::string* out);
+  bool Write(const std::string& data);
+
+  const std::string path_;
+  std::FILE* file_ = nullptr;
+  // Loaded runs by instance, then by repetition_index.
+  std::map<Key, std::map<int64_t, BenchmarkReporter::Run>> loaded_;
+  // The encoded runs handed out by TakeRuns, which Start() writes back.
+  std::string taken_;
+};
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_CHECKPOINT_H_
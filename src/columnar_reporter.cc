@@ -0,0 +1,274 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/export.h"
+#include "benchmark/reporter.h"
+#include "complexity.h"
+
+// The layout of the output, with all integers little-endian:
+//
+//   file       := "GBCOLUMN" u32:version u32:size context chunk* 'E'
+//   context    := the JSON object of the "context" of the JSON output
+//   chunk      := dictionary | batch
+//   dictionary := 'D' u32:count string*
+//   batch      := 'B' u32:rows u32:count column*
+//   column     := string u8:type validity values
+//   string     := u32:size bytes
+//
+// Each dictionary chunk appends to the one dictionary shared by all string
+// columns, before the first batch referring to the new entries. A column has
+// one validity bit per row (least significant bit first), set if the row has
+// a value, followed by a value for every row: 8 bytes for 'i' (int64) and 'f'
+// (double), 1 byte for 'b' (bool) and 4 bytes for 's' (a dictionary index).
+
+namespace benchmark {
+
+namespace {
+
+const char kMagic[] = "GBCOLUMN";
+const uint32_t kVersion = 1;
+
+// Keeps the memory needed for the columns of a batch bounded.
+const size_t kRowsPerBatch = 16384;
+
+size_t ValueWidth(char type) {
+  switch (type) {
+    case 'b':
+      return 1;
+    case 's':
+      return 4;
+    default:
+      return 8;
+  }
+}
+
+void PutLittleEndian(uint64_t bits, size_t width, std::string* out) {
+  for (size_t i = 0; i < width; ++i) {
+    out->push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+  }
+}
+
+void PutString(const std::string& value, std::string* out) {
+  PutLittleEndian(value.size(), 4, out);
+  out->append(value);
+}
+
+}  // end namespace
+
+bool ColumnarReporter::ReportContext(const Context& context) {
+  std::stringstream context_json;
+  context_json << "{\n";
+  PrintContextData(context_json, context);
+  context_json << "}";
+
+  std::string header(kMagic, sizeof(kMagic) - 1);
+  PutLittleEndian(kVersion, 4, &header);
+  PutString(context_json.str(), &header);
+  GetOutputStream().write(header.data(),
+                          static_cast<std::streamsize>(header.size()));
+  return true;
+}
+
+void ColumnarReporter::ReportRuns(const std::vector<Run>& reports) {
+  for (const Run& run : reports) {
+    AddRow(run);
+    if (num_rows_ == kRowsPerBatch) {
+      WriteBatch();
+    }
+  }
+}
+
+void ColumnarReporter::Finalize() {
+  WriteBatch();
+  GetOutputStream().put('E');
+}
+
+ColumnarReporter::Column& ColumnarReporter::GetColumn(const std::string& name,
+                                                      char type) {
+  auto it = column_indices_.find(name);
+  if (it != column_indices_.end()) {
+    return columns_[it->second];
+  }
+  column_indices_[name] = columns_.size();
+  columns_.push_back(Column{name, type, std::string(), std::string()});
+  return columns_.back();
+}
+
+void ColumnarReporter::SetValue(const std::string& name, char type,
+                                uint64_t bits) {
+  Column& column = GetColumn(name, type);
+  // A user counter may have the name of another field, which the JSON output
+  // would print twice. Keep the first one.
+  if (column.type != type) {
+    return;
+  }
+  const size_t width = ValueWidth(type);
+  if (column.values.size() > num_rows_ * width) {
+    return;
+  }
+  column.values.resize(num_rows_ * width, '\0');
+  column.validity.resize(num_rows_ / 8 + 1, '\0');
+  column.validity[num_rows_ / 8] |= static_cast<char>(1 << (num_rows_ % 8));
+  PutLittleEndian(bits, width, &column.values);
+}
+
+void ColumnarReporter::SetInt(const std::string& name, int64_t value) {
+  SetValue(name, 'i', static_cast<uint64_t>(value));
+}
+
+void ColumnarReporter::SetDouble(const std::string& name, double value) {
+  uint64_t bits = 0;
+  static_assert(sizeof(bits) == sizeof(value), "Unexpected size of double");
+  std::memcpy(&bits, &value, sizeof(bits));
+  SetValue(name, 'f', bits);
+}
+
+void ColumnarReporter::SetBool(const std::string& name, bool value) {
+  SetValue(name, 'b', value ? 1 : 0);
+}
+
+void ColumnarReporter::SetString(const std::string& name,
+                                 const std::string& value) {
+  auto it = dictionary_.find(value);
+  if (it == dictionary_.end()) {
+    it = dictionary_
+             .insert(std::make_pair(
+                 value, static_cast<uint32_t>(dictionary_.size())))
+             .first;
+    new_dictionary_entries_.push_back(value);
+  }
+  SetValue(name, 's', it->second);
+}
+
+// Mirrors JSONReporter::PrintRunData, so that a reader can turn the rows back
+// into the objects of the JSON output.
+void ColumnarReporter::AddRow(const Run& run) {
+  SetString("name", run.benchmark_name());
+  SetInt("family_index", run.family_index);
+  SetInt("per_family_instance_index", run.per_family_instance_index);
+  SetString("run_name", run.run_name.str());
+  SetString("run_type",
+            run.run_type == Run::RT_Aggregate ? "aggregate" : "iteration");
+  SetInt("repetitions", run.repetitions);
+  if (run.run_type != Run::RT_Aggregate) {
+    SetInt("repetition_index", run.repetition_index);
+  }
+  SetInt("threads", run.threads);
+  if (run.run_type == Run::RT_Aggregate) {
+    SetString("aggregate_name", run.aggregate_name);
+    SetString("aggregate_unit", run.aggregate_unit == StatisticUnit::kTime
+                                    ? "time"
+                                    : "percentage");
+  }
+  if (internal::SkippedWithError == run.skipped) {
+    SetBool("error_occurred", true);
+    SetString("error_message", run.skip_message);
+  } else if (internal::SkippedWithMessage == run.skipped) {
+    SetBool("skipped", true);
+    SetString("skip_message", run.skip_message);
+  }
+  if (!run.report_big_o && !run.report_rms) {
+    SetInt("iterations", run.iterations);
+    if (run.run_type != Run::RT_Aggregate ||
+        run.aggregate_unit == StatisticUnit::kTime) {
+      SetDouble("real_time", run.GetAdjustedRealTime());
+      SetDouble("cpu_time", run.GetAdjustedCPUTime());
+    } else {
+      SetDouble("real_time", run.real_accumulated_time);
+      SetDouble("cpu_time", run.cpu_accumulated_time);
+    }
+    SetString("time_unit", GetTimeUnitString(run.time_unit));
+  } else if (run.report_big_o) {
+    SetDouble("cpu_coefficient", run.GetAdjustedCPUTime());
+    SetDouble("real_coefficient", run.GetAdjustedRealTime());
+    SetString("big_o", GetBigOString(run.complexity));
+    SetString("time_unit", GetTimeUnitString(run.time_unit));
+  } else if (run.report_rms) {
+    SetDouble("rms", run.GetAdjustedCPUTime());
+  }
+
+  for (const auto& c : run.counters) {
+    SetDouble(c.first, c.second.value);
+  }
+
+  if (run.memory_result.memory_iterations > 0) {
+    const auto& memory_result = run.memory_result;
+    SetDouble("allocs_per_iter", run.allocs_per_iter);
+    SetInt("max_bytes_used", memory_result.max_bytes_used);
+    if (memory_result.total_allocated_bytes != MemoryManager::TombstoneValue) {
+      SetInt("total_allocated_bytes", memory_result.total_allocated_bytes);
+    }
+    if (memory_result.net_heap_growth != MemoryManager::TombstoneValue) {
+      SetInt("net_heap_growth", memory_result.net_heap_growth);
+    }
+  }
+
+  const std::string bound = run.roofline_bound();
+  if (!bound.empty()) {
+    SetString("roofline_bound", bound);
+  }
+
+  if (!run.report_label.empty()) {
+    SetString("label", run.report_label);
+  }
+  ++num_rows_;
+}
+
+void ColumnarReporter::WriteBatch() {
+  if (num_rows_ == 0) {
+    return;
+  }
+  std::string out;
+  if (!new_dictionary_entries_.empty()) {
+    out.push_back('D');
+    PutLittleEndian(new_dictionary_entries_.size(), 4, &out);
+    for (const std::string& entry : new_dictionary_entries_) {
+      PutString(entry, &out);
+    }
+    new_dictionary_entries_.clear();
+  }
+
+  // Columns without a value in this batch are left out.
+  uint32_t num_columns = 0;
+  for (const Column& column : columns_) {
+    num_columns += column.values.empty() ? 0 : 1;
+  }
+  out.push_back('B');
+  PutLittleEndian(num_rows_, 4, &out);
+  PutLittleEndian(num_columns, 4, &out);
+  for (Column& column : columns_) {
+    if (column.values.empty()) {
+      continue;
+    }
+    column.values.resize(num_rows_ * ValueWidth(column.type), '\0');
+    column.validity.resize((num_rows_ + 7) / 8, '\0');
+    PutString(column.name, &out);
+    out.push_back(column.type);
+    out.append(column.validity);
+    out.append(column.values);
+    column.validity.clear();
+    column.values.clear();
+  }
+  num_rows_ = 0;
+  GetOutputStream().write(out.data(), static_cast<std::streamsize>(out.size()));
+}
+
+}  // end namespace benchmark
@@ -205,6 +205,11 @@ void ConsoleReporter::PrintRunData(const Run& result) {
     }
   }
 
+  const std::string bound = result.roofline_bound();
+  if (!bound.empty()) {
+    printer(Out, COLOR_DEFAULT, " %s-bound", bound.c_str());
+  }
+
   if (!result.report_label.empty()) {
     printer(Out, COLOR_DEFAULT, " %s", result.report_label.c_str());
   }
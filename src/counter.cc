@@ -67,6 +67,36 @@ void Increment(UserCounters* l, UserCounters const& r) {
   }
 }
 
+void Merge(UserCounters* l, IterationCount l_iterations, UserCounters const& r,
+           IterationCount r_iterations) {
+  const double total = static_cast<double>(l_iterations + r_iterations);
+  if (total <= 0) {
+    return;
+  }
+  const double l_weight = static_cast<double>(l_iterations) / total;
+  const double r_weight = static_cast<double>(r_iterations) / total;
+  for (auto const& tc : r) {
+    auto it = l->find(tc.first);
+    if (it == l->end()) {
+      (*l)[tc.first] = tc.second;
+      continue;
+    }
+    // Rates and per-iteration averages are divided by the time and by the
+    // iterations, which add up as well. A rate that is also multiplied by the
+    // iterations is a per-iteration value.
+    const Counter::Flags flags = it->second.flags;
+    const bool is_total = ((flags & Counter::kIsRate) != 0 &&
+                           (flags & Counter::kIsIterationInvariant) == 0) ||
+                          (flags & Counter::kAvgIterations) != 0;
+    if (is_total) {
+      it->second.value += tc.second.value;
+    } else {
+      it->second.value =
+          it->second.value * l_weight + tc.second.value * r_weight;
+    }
+  }
+}
+
 bool SameNames(UserCounters const& l, UserCounters const& r) {
   if (&l == &r) {
     return true;
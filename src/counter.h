@@ -25,6 +25,12 @@ namespace internal {
 void Finish(UserCounters* l, IterationCount iterations, double time,
             double num_threads);
 void Increment(UserCounters* l, UserCounters const& r);
+// Merges the counters `r` of `r_iterations` into the counters `l` of
+// `l_iterations` of the same run, before Finish(). Counters that are totals
+// over the iterations are added up, the others are averaged, weighted by the
+// iterations.
+void Merge(UserCounters* l, IterationCount l_iterations, UserCounters const& r,
+           IterationCount r_iterations);
 bool SameNames(UserCounters const& l, UserCounters const& r);
 }  // end namespace internal
 
@@ -0,0 +1,234 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cpu_affinity.h"
+
+#include "internal_macros.h"
+
+#if defined(BENCHMARK_HAS_PTHREAD_AFFINITY)
+#if defined(BENCHMARK_OS_FREEBSD)
+#include <pthread_np.h>
+#endif
+#include <pthread.h>
+#endif
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
+#include <utility>
+
+namespace benchmark {
+namespace internal {
+
+#if defined(BENCHMARK_HAS_PTHREAD_AFFINITY) && defined(BENCHMARK_OS_FREEBSD)
+typedef cpuset_t cpu_set_t;
+#endif
+
+std::vector<int> GetAllowedCPUs() {
+  std::vector<int> res;
+#if defined(BENCHMARK_HAS_PTHREAD_AFFINITY)
+  cpu_set_t affinity;
+  CPU_ZERO(&affinity);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(affinity), &affinity) !=
+      0) {
+    return res;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &affinity)) {
+      res.push_back(cpu);
+    }
+  }
+#endif
+  return res;
+}
+
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus) {
+#if defined(BENCHMARK_HAS_PTHREAD_AFFINITY)
+  cpu_set_t affinity;
+  CPU_ZERO(&affinity);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(cpu, &affinity);
+  }
+  return !cpus.empty() && pthread_setaffinity_np(pthread_self(),
+                                                 sizeof(affinity),
+                                                 &affinity) == 0;
+#else
+  (void)cpus;
+  return false;
+#endif
+}
+
+bool PinCurrentThreadToCPU(int cpu) { return SetCurrentThreadAffinity({cpu}); }
+
+std::vector<int> PickIsolatedCPUs(
+    const std::vector<CPUInfo::LogicalCPU>& topology,
+    const std::vector<int>& allowed, size_t count) {
+  const std::set<int> allowed_set(allowed.begin(), allowed.end());
+  std::set<int> used_cores;
+  std::set<int> used_l2_domains;
+  // Greedily take the first CPU of every core and L2 domain, by package.
+  std::map<int, std::vector<int>> by_package;
+  for (const CPUInfo::LogicalCPU& cpu : topology) {
+    if (allowed_set.count(cpu.cpu) == 0 || used_cores.count(cpu.core) != 0 ||
+        (cpu.l2_domain >= 0 && used_l2_domains.count(cpu.l2_domain) != 0)) {
+      continue;
+    }
+    used_cores.insert(cpu.core);
+    if (cpu.l2_domain >= 0) {
+      used_l2_domains.insert(cpu.l2_domain);
+    }
+    by_package[cpu.package].push_back(cpu.cpu);
+  }
+
+  std::vector<int> res;
+  for (size_t round = 0; res.size() < count; ++round) {
+    bool any = false;
+    for (const auto& package : by_package) {
+      if (round < package.second.size() && res.size() < count) {
+        res.push_back(package.second[round]);
+        any = true;
+      }
+    }
+    if (!any) {
+      break;
+    }
+  }
+  return res;
+}
+
+std::vector<int> PickAffinityCPUs(
+    ThreadAffinityPolicy policy,
+    const std::vector<CPUInfo::LogicalCPU>& topology,
+    const std::vector<int>& allowed, size_t num_threads) {
+  if (policy == kAffinityNone || allowed.empty() || num_threads == 0) {
+    return {};
+  }
+
+  std::vector<CPUInfo::LogicalCPU> usable;
+  if (topology.empty()) {
+    for (int cpu : allowed) {
+      usable.push_back({cpu, cpu, 0, -1, -1});
+    }
+  } else {
+    const std::set<int> allowed_set(allowed.begin(), allowed.end());
+    for (const CPUInfo::LogicalCPU& cpu : topology) {
+      if (allowed_set.count(cpu.cpu) != 0) {
+        usable.push_back(cpu);
+      }
+    }
+  }
+
+  // Where every CPU sits, as ranks in topology order: the rank of its core
+  // within the package, and its own rank among the SMT siblings of the core.
+  struct Slot {
+    int cpu;
+    int package;
+    size_t core_rank;
+    size_t sibling_rank;
+  };
+  std::map<std::pair<int, int>, size_t> siblings_seen;
+  std::map<int, std::map<int, size_t>> core_ranks;
+  std::set<int> numa_nodes_seen;
+  std::vector<Slot> slots;
+  for (const CPUInfo::LogicalCPU& cpu : usable) {
+    const size_t sibling_rank = siblings_seen[{cpu.package, cpu.core}]++;
+    auto& package_cores = core_ranks[cpu.package];
+    const size_t core_rank =
+        package_cores.emplace(cpu.core, package_cores.size()).first->second;
+    // Where the NUMA layout is unknown, treat every package as a node.
+    const int numa_node =
+        cpu.numa_node >= 0 ? cpu.numa_node : -1 - cpu.package;
+    switch (policy) {
+      case kAffinityPhysicalCore:
+        if (sibling_rank != 0) {
+          continue;
+        }
+        break;
+      case kAffinityNumaNode:
+        if (sibling_rank != 0 || !numa_nodes_seen.insert(numa_node).second) {
+          continue;
+        }
+        break;
+      default:
+        break;
+    }
+    slots.push_back({cpu.cpu, cpu.package, core_rank, sibling_rank});
+  }
+
+  switch (policy) {
+    case kAffinityScatter:
+      std::stable_sort(slots.begin(), slots.end(),
+                       [](const Slot& a, const Slot& b) {
+                         return std::tie(a.sibling_rank, a.core_rank,
+                                         a.package) <
+                                std::tie(b.sibling_rank, b.core_rank,
+                                         b.package);
+                       });
+      break;
+    case kAffinityNumaNode:
+      // Already one CPU per node, in topology order.
+      break;
+    default:
+      std::stable_sort(slots.begin(), slots.end(),
+                       [](const Slot& a, const Slot& b) {
+                         return std::tie(a.package, a.core_rank,
+                                         a.sibling_rank) <
+                                std::tie(b.package, b.core_rank,
+                                         b.sibling_rank);
+                       });
+      break;
+  }
+
+  std::vector<int> res;
+  for (size_t i = 0; i < slots.size() && i < num_threads; ++i) {
+    res.push_back(slots[i].cpu);
+  }
+  return res;
+}
+
+const char* ThreadAffinityPolicyName(ThreadAffinityPolicy policy) {
+  switch (policy) {
+    case kAffinityNone:
+      return "none";
+    case kAffinityCompact:
+      return "compact";
+    case kAffinityScatter:
+      return "scatter";
+    case kAffinityPhysicalCore:
+      return "physical_core";
+    case kAffinityNumaNode:
+      return "numa_node";
+  }
+  BENCHMARK_UNREACHABLE();
+}
+
+bool ParseThreadAffinityPolicy(const std::string& name,
+                               ThreadAffinityPolicy* policy) {
+  for (ThreadAffinityPolicy p :
+       {kAffinityNone, kAffinityCompact, kAffinityScatter,
+        kAffinityPhysicalCore, kAffinityNumaNode}) {
+    if (name == ThreadAffinityPolicyName(p)) {
+      *policy = p;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace internal
+}  // namespace benchmark
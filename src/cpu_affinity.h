@@ -0,0 +1,77 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_CPU_AFFINITY_H_
+#define BENCHMARK_CPU_AFFINITY_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "benchmark/export.h"
+#include "benchmark/sysinfo.h"
+#include "benchmark/types.h"
+
+namespace benchmark {
+namespace internal {
+
+// Returns the CPUs the calling thread is allowed to run on, in increasing
+// order, or an empty vector if this cannot be determined on this platform.
+BENCHMARK_EXPORT
+std::vector<int> GetAllowedCPUs();
+
+// Restricts the calling thread to `cpus`. Returns false if this is not
+// supported or failed.
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus);
+
+// Restricts the calling thread to `cpu`. Returns false if this is not
+// supported or failed.
+BENCHMARK_EXPORT
+bool PinCurrentThreadToCPU(int cpu);
+
+// Picks up to `count` CPUs out of `allowed` such that no two of them share a
+// physical core or an L2 cache, so that code running on one of them does not
+// disturb the others. The picks are spread round-robin over the packages.
+BENCHMARK_EXPORT
+std::vector<int> PickIsolatedCPUs(
+    const std::vector<CPUInfo::LogicalCPU>& topology,
+    const std::vector<int>& allowed, size_t count);
+
+// Returns the CPUs out of `allowed` that the threads of a benchmark run with
+// `num_threads` threads are pinned to under `policy`; thread `i` goes to
+// element `i % size()`. The result has at most `num_threads` elements, and
+// fewer if the policy does not provide that many CPUs. Returns an empty vector
+// for kAffinityNone or if `allowed` is empty.
+//
+// Without a `topology`, every allowed CPU is treated as a core of its own.
+BENCHMARK_EXPORT
+std::vector<int> PickAffinityCPUs(
+    ThreadAffinityPolicy policy,
+    const std::vector<CPUInfo::LogicalCPU>& topology,
+    const std::vector<int>& allowed, size_t num_threads);
+
+// The name of `policy` as accepted by --benchmark_affinity.
+BENCHMARK_EXPORT
+const char* ThreadAffinityPolicyName(ThreadAffinityPolicy policy);
+
+// Parses a policy name as returned by ThreadAffinityPolicyName(). Returns
+// false if `name` is not one.
+BENCHMARK_EXPORT
+bool ParseThreadAffinityPolicy(const std::string& name,
+                               ThreadAffinityPolicy* policy);
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_CPU_AFFINITY_H_
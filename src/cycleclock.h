@@ -255,6 +255,29 @@ inline BENCHMARK_ALWAYS_INLINE int64_t Now() {
 #error You need to define CycleTimer for your OS and CPU
 #endif
 }
+
+// Like Now(), but the read is not reordered with the instructions around it,
+// so that it can delimit a short stretch of code. Where no fence is known this
+// is just Now().
+inline BENCHMARK_ALWAYS_INLINE int64_t NowSerialized() {
+#if !defined(BENCHMARK_OS_EMSCRIPTEN) && !defined(COMPILER_MSVC) && \
+    (defined(__i386__) || defined(__x86_64__) || defined(__amd64__)) && \
+    !defined(__arm64ec__)
+  // lfence waits for all earlier instructions to complete, and later ones do
+  // not start before it does.
+  __asm__ volatile("lfence" : : : "memory");
+  const int64_t now = Now();
+  __asm__ volatile("lfence" : : : "memory");
+  return now;
+#elif !defined(COMPILER_MSVC) && defined(__aarch64__)
+  asm volatile("isb" : : : "memory");
+  const int64_t now = Now();
+  asm volatile("isb" : : : "memory");
+  return now;
+#else
+  return Now();
+#endif
+}
 }  // end namespace cycleclock
 }  // end namespace benchmark
 
@@ -0,0 +1,317 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "json_reader.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+
+#include "string_util.h"
+
+namespace benchmark {
+namespace internal {
+
+const JsonValue* JsonValue::Find(const std::string& key) const {
+  for (const auto& member : object) {
+    if (member.first == key) {
+      return &member.second;
+    }
+  }
+  return nullptr;
+}
+
+namespace {
+
+// Documents nested deeper than this are rejected rather than risking the
+// stack.
+constexpr int kMaxDepth = 64;
+
+class Parser {
+ public:
+  explicit Parser(const std::string& text) : text_(text) {}
+
+  bool ParseDocument(JsonValue* value) {
+    if (!ParseValue(value, 0)) {
+      return false;
+    }
+    SkipWhitespace();
+    return pos_ == text_.size() || Fail("unexpected trailing characters");
+  }
+
+  const std::string& error() const { return error_; }
+
+ private:
+  bool Fail(const char* what) {
+    if (error_.empty()) {
+      error_ = StrCat(what, " at offset ", pos_);
+    }
+    return false;
+  }
+
+  void SkipWhitespace() {
+    while (pos_ < text_.size() &&
+           (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' ||
+            text_[pos_] == '\r')) {
+      ++pos_;
+    }
+  }
+
+  bool Consume(const char* literal) {
+    const size_t size = std::strlen(literal);
+    if (text_.compare(pos_, size, literal) != 0) {
+      return false;
+    }
+    pos_ += size;
+    return true;
+  }
+
+  bool ParseValue(JsonValue* value, int depth) {
+    if (depth > kMaxDepth) {
+      return Fail("nesting too deep");
+    }
+    SkipWhitespace();
+    if (pos_ == text_.size()) {
+      return Fail("unexpected end of input");
+    }
+    const char c = text_[pos_];
+    if (c == '{') {
+      return ParseObject(value, depth);
+    }
+    if (c == '[') {
+      return ParseArray(value, depth);
+    }
+    if (c == '"') {
+      value->type = JsonValue::kString;
+      return ParseString(&value->string);
+    }
+    if (Consume("true") || Consume("false")) {
+      value->type = JsonValue::kBool;
+      value->boolean = c == 't';
+      return true;
+    }
+    if (Consume("null")) {
+      value->type = JsonValue::kNull;
+      return true;
+    }
+    value->type = JsonValue::kNumber;
+    return ParseNumber(&value->number);
+  }
+
+  bool ParseObject(JsonValue* value, int depth) {
+    value->type = JsonValue::kObject;
+    ++pos_;
+    SkipWhitespace();
+    if (Consume("}")) {
+      return true;
+    }
+    for (;;) {
+      SkipWhitespace();
+      std::string key;
+      if (pos_ == text_.size() || text_[pos_] != '"' || !ParseString(&key)) {
+        return Fail("expected a string key");
+      }
+      SkipWhitespace();
+      if (!Consume(":")) {
+        return Fail("expected ':'");
+      }
+      value->object.emplace_back(std::move(key), JsonValue());
+      if (!ParseValue(&value->object.back().second, depth + 1)) {
+        return false;
+      }
+      SkipWhitespace();
+      if (Consume("}")) {
+        return true;
+      }
+      if (!Consume(",")) {
+        return Fail("expected ',' or '}'");
+      }
+    }
+  }
+
+  bool ParseArray(JsonValue* value, int depth) {
+    value->type = JsonValue::kArray;
+    ++pos_;
+    SkipWhitespace();
+    if (Consume("]")) {
+      return true;
+    }
+    for (;;) {
+      value->array.emplace_back();
+      if (!ParseValue(&value->array.back(), depth + 1)) {
+        return false;
+      }
+      SkipWhitespace();
+      if (Consume("]")) {
+        return true;
+      }
+      if (!Consume(",")) {
+        return Fail("expected ',' or ']'");
+      }
+    }
+  }
+
+  bool ParseHex4(uint32_t* code) {
+    if (text_.size() - pos_ < 4) {
+      return Fail("truncated unicode escape");
+    }
+    *code = 0;
+    for (int i = 0; i < 4; ++i) {
+      const char c = text_[pos_++];
+      *code <<= 4;
+      if (c >= '0' && c <= '9') {
+        *code |= static_cast<uint32_t>(c - '0');
+      } else if (c >= 'a' && c <= 'f') {
+        *code |= static_cast<uint32_t>(c - 'a' + 10);
+      } else if (c >= 'A' && c <= 'F') {
+        *code |= static_cast<uint32_t>(c - 'A' + 10);
+      } else {
+        return Fail("invalid unicode escape");
+      }
+    }
+    return true;
+  }
+
+  static void AppendUtf8(uint32_t code, std::string* out) {
+    if (code < 0x80) {
+      out->push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+      out->push_back(static_cast<char>(0xc0 | (code >> 6)));
+      out->push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    } else if (code < 0x10000) {
+      out->push_back(static_cast<char>(0xe0 | (code >> 12)));
+      out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+      out->push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    } else {
+      out->push_back(static_cast<char>(0xf0 | (code >> 18)));
+      out->push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+      out->push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+      out->push_back(static_cast<char>(0x80 | (code & 0x3f)));
+    }
+  }
+
+  bool ParseString(std::string* out) {
+    ++pos_;  // The opening quote.
+    out->clear();
+    while (pos_ < text_.size()) {
+      const char c = text_[pos_++];
+      if (c == '"') {
+        return true;
+      }
+      if (c != '\\') {
+        out->push_back(c);
+        continue;
+      }
+      if (pos_ == text_.size()) {
+        break;
+      }
+      const char escaped = text_[pos_++];
+      switch (escaped) {
+        case '"':
+        case '\\':
+        case '/':
+          out->push_back(escaped);
+          break;
+        case 'b':
+          out->push_back('\b');
+          break;
+        case 'f':
+          out->push_back('\f');
+          break;
+        case 'n':
+          out->push_back('\n');
+          break;
+        case 'r':
+          out->push_back('\r');
+          break;
+        case 't':
+          out->push_back('\t');
+          break;
+        case 'u': {
+          uint32_t code = 0;
+          if (!ParseHex4(&code)) {
+            return false;
+          }
+          // A surrogate pair encodes a code point above the BMP.
+          if (code >= 0xd800 && code < 0xdc00 && Consume("\\u")) {
+            uint32_t low = 0;
+            if (!ParseHex4(&low) || low < 0xdc00 || low >= 0xe000) {
+              return Fail("invalid surrogate pair");
+            }
+            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+          }
+          AppendUtf8(code, out);
+          break;
+        }
+        default:
+          return Fail("invalid escape");
+      }
+    }
+    return Fail("unterminated string");
+  }
+
+  bool ParseNumber(double* number) {
+    const bool negative = pos_ < text_.size() && text_[pos_] == '-';
+    const size_t start = pos_;
+    if (negative) {
+      ++pos_;
+    }
+    if (Consume("NaN")) {
+      *number = std::numeric_limits<double>::quiet_NaN();
+      return true;
+    }
+    if (Consume("Infinity")) {
+      *number = negative ? -std::numeric_limits<double>::infinity()
+                         : std::numeric_limits<double>::infinity();
+      return true;
+    }
+    while (pos_ < text_.size() &&
+           std::strchr("0123456789+-.eE", text_[pos_]) != nullptr) {
+      ++pos_;
+    }
+    if (pos_ == start + (negative ? 1 : 0)) {
+      return Fail("unexpected character");
+    }
+    // Independent of the global locale, like the JSON reporter.
+    std::istringstream in(text_.substr(start, pos_ - start));
+    in.imbue(std::locale::classic());
+    in >> *number;
+    if (in.fail() || in.peek() != std::char_traits<char>::eof()) {
+      pos_ = start;
+      return Fail("invalid number");
+    }
+    return true;
+  }
+
+  const std::string& text_;
+  size_t pos_ = 0;
+  std::string error_;
+};
+
+}  // namespace
+
+bool ParseJson(const std::string& text, JsonValue* value, std::string* error) {
+  Parser parser(text);
+  *value = JsonValue();
+  if (!parser.ParseDocument(value)) {
+    *error = parser.error();
+    return false;
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace benchmark
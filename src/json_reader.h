@@ -0,0 +1,53 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_JSON_READER_H_
+#define BENCHMARK_JSON_READER_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/export.h"
+
+namespace benchmark {
+namespace internal {
+
+// A parsed JSON document. This is just enough to read back the output of the
+// JSON reporter, which is why the non-standard NaN and Infinity numbers it
+// writes are accepted.
+struct BENCHMARK_EXPORT JsonValue {
+  enum Type { kNull, kBool, kNumber, kString, kArray, kObject };
+
+  Type type = kNull;
+  bool boolean = false;
+  double number = 0;
+  std::string string;
+  std::vector<JsonValue> array;
+  // In the order of the document.
+  std::vector<std::pair<std::string, JsonValue>> object;
+
+  // Returns the member `key` of an object, or null if there is none.
+  const JsonValue* Find(const std::string& key) const;
+};
+
+// Parses `text` into `value`. On failure, returns false and describes the
+// problem in `error`.
+BENCHMARK_EXPORT
+bool ParseJson(const std::string& text, JsonValue* value, std::string* error);
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_JSON_READER_H_
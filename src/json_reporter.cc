@@ -17,7 +17,9 @@
 #include <cstdint>
 #include <iomanip>  // for setprecision
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <sstream>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -125,6 +127,16 @@ bool JSONReporter::ReportContext(const Context& context) {
 
   // Open context block and print context information.
   out << inner_indent << "\"context\": {\n";
+  PrintContextData(out, context);
+
+  // Close context block and open the list of benchmarks.
+  out << inner_indent << "},\n";
+  out << inner_indent << "\"benchmarks\": [\n";
+  return true;
+}
+
+void JSONReporter::PrintContextData(std::ostream& out,
+                                    const Context& context) {
   std::string indent(4, ' ');
 
   std::string walltime_value = LocalDateTimeString();
@@ -203,6 +215,49 @@ bool JSONReporter::ReportContext(const Context& context) {
   // NOTE: our json schema is not strictly tied to the library version!
   out << indent << FormatKV("json_schema_version", 1);
 
+  if (!context.timer_overhead.empty()) {
+    const std::string timing_indent(6, ' ');
+    const std::string value_indent(8, ' ');
+    out << ",\n" << indent << "\"timer_overhead\": {\n";
+    for (auto it = context.timer_overhead.begin();
+         it != context.timer_overhead.end(); ++it) {
+      const TimerOverhead& overhead = it->second;
+      out << timing_indent << '"' << StrEscape(it->first) << "\": {\n";
+      out << value_indent
+          << FormatKV("real_time_per_iteration",
+                      overhead.real_time_per_iteration)
+          << ",\n";
+      out << value_indent
+          << FormatKV("cpu_time_per_iteration", overhead.cpu_time_per_iteration)
+          << ",\n";
+      out << value_indent
+          << FormatKV("real_time_per_pause", overhead.real_time_per_pause)
+          << ",\n";
+      out << value_indent
+          << FormatKV("cpu_time_per_pause", overhead.cpu_time_per_pause)
+          << "\n";
+      out << timing_indent << "}"
+          << (std::next(it) != context.timer_overhead.end() ? "," : "")
+          << "\n";
+    }
+    out << indent << "},\n";
+    out << indent
+        << FormatKV("timer_overhead_subtracted",
+                    context.timer_overhead_subtracted);
+  }
+
+  if (!context.machine_profile.empty()) {
+    const std::string value_indent(6, ' ');
+    out << ",\n" << indent << "\"machine_profile\": {\n";
+    for (auto it = context.machine_profile.begin();
+         it != context.machine_profile.end(); ++it) {
+      out << value_indent << FormatKV(it->first, it->second)
+          << (std::next(it) != context.machine_profile.end() ? "," : "")
+          << "\n";
+    }
+    out << indent << "}";
+  }
+
   std::map<std::string, std::string>* global_context =
       internal::GetGlobalContext();
 
@@ -213,11 +268,6 @@ bool JSONReporter::ReportContext(const Context& context) {
     }
   }
   out << "\n";
-
-  // Close context block and open the list of benchmarks.
-  out << inner_indent << "},\n";
-  out << inner_indent << "\"benchmarks\": [\n";
-  return true;
 }
 
 void JSONReporter::ReportRuns(std::vector<Run> const& reports) {
@@ -233,7 +283,7 @@ void JSONReporter::ReportRuns(std::vector<Run> const& reports) {
 
   for (auto it = reports.begin(); it != reports.end(); ++it) {
     out << indent << "{\n";
-    PrintRunData(*it);
+    PrintRunData(out, *it);
     out << indent << '}';
     auto it_cp = it;
     if (++it_cp != reports.end()) {
@@ -247,9 +297,8 @@ void JSONReporter::Finalize() {
   GetOutputStream() << "\n  ]\n}\n";
 }
 
-void JSONReporter::PrintRunData(Run const& run) {
+void JSONReporter::PrintRunData(std::ostream& out, Run const& run) {
   std::string indent(6, ' ');
-  std::ostream& out = GetOutputStream();
   out << indent << FormatKV("name", run.benchmark_name()) << ",\n";
   out << indent << FormatKV("family_index", run.family_index) << ",\n";
   out << indent
@@ -338,6 +387,11 @@ void JSONReporter::PrintRunData(Run const& run) {
     report_if_present("net_heap_growth", memory_result.net_heap_growth);
   }
 
+  const std::string bound = run.roofline_bound();
+  if (!bound.empty()) {
+    out << ",\n" << indent << FormatKV("roofline_bound", bound);
+  }
+
   if (!run.report_label.empty()) {
     out << ",\n" << indent << FormatKV("label", run.report_label);
   }
@@ -364,4 +418,71 @@ void JSONReporter::List(
   out << "\n" << inner_indent << "]\n}\n";
 }
 
+namespace {
+
+// Joins the lines of pretty-printed JSON into one, dropping the indentation.
+// Strings never contain raw newlines, as they are escaped.
+std::string OneLine(const std::string& pretty) {
+  std::string res;
+  res.reserve(pretty.size());
+  size_t i = 0;
+  while (i < pretty.size() && pretty[i] == ' ') {
+    ++i;
+  }
+  for (; i < pretty.size(); ++i) {
+    if (pretty[i] != '\n') {
+      res += pretty[i];
+      continue;
+    }
+    while (i + 1 < pretty.size() && pretty[i + 1] == ' ') {
+      ++i;
+    }
+    if (i + 1 < pretty.size()) {
+      res += ' ';
+    }
+  }
+  return res;
+}
+
+}  // end namespace
+
+void NDJSONReporter::PrintRecord(const char* type,
+                                 const std::string& pretty_fields) {
+  std::ostream& out = GetOutputStream();
+  out << '{' << FormatKV("type", type) << ", " << OneLine(pretty_fields)
+      << "}\n";
+}
+
+bool NDJSONReporter::ReportContext(const Context& context) {
+  std::stringstream fields;
+  PrintContextData(fields, context);
+  PrintRecord("context", fields.str());
+  return true;
+}
+
+void NDJSONReporter::ReportRepetition(const Run& run) {
+  std::stringstream fields;
+  PrintRunData(fields, run);
+  PrintRecord("run", fields.str());
+}
+
+void NDJSONReporter::ReportRuns(const std::vector<Run>& reports) {
+  // The repetitions were already written by ReportRepetition().
+  for (const Run& run : reports) {
+    if (run.run_type == Run::RT_Aggregate) {
+      std::stringstream fields;
+      PrintRunData(fields, run);
+      PrintRecord("run", fields.str());
+    }
+  }
+}
+
+void NDJSONReporter::List(
+    const std::vector<internal::BenchmarkInstance>& benchmarks) {
+  std::ostream& out = GetOutputStream();
+  for (const internal::BenchmarkInstance& benchmark : benchmarks) {
+    out << '{' << FormatKV("name", benchmark.name().str()) << "}\n";
+  }
+}
+
 }  // end namespace benchmark
@@ -0,0 +1,144 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "check.h"
+
+namespace benchmark {
+namespace internal {
+
+namespace {
+
+// Every power of two above kSubBucketCount gets its own run of
+// kSubBucketCount linear buckets.
+constexpr size_t kNumBuckets = static_cast<size_t>(
+    (64 - LatencyHistogram::kSubBucketBits + 1) *
+    LatencyHistogram::kSubBucketCount);
+
+int HighestBitSet(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - __builtin_clzll(value);
+#else
+  int bit = 0;
+  while ((value >>= 1) != 0) {
+    ++bit;
+  }
+  return bit;
+#endif
+}
+
+}  // namespace
+
+size_t LatencyHistogram::BucketIndex(uint64_t value) {
+  const uint64_t sub_bucket_count = static_cast<uint64_t>(kSubBucketCount);
+  if (value < sub_bucket_count) {
+    return static_cast<size_t>(value);
+  }
+  const int shift = HighestBitSet(value) - kSubBucketBits;
+  return static_cast<size_t>(shift + 1) * sub_bucket_count +
+         static_cast<size_t>((value >> shift) - sub_bucket_count);
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(size_t index) {
+  const size_t sub_bucket_count = static_cast<size_t>(kSubBucketCount);
+  if (index < sub_bucket_count) {
+    return index;
+  }
+  const size_t shift = index / sub_bucket_count - 1;
+  return static_cast<uint64_t>(index % sub_bucket_count + sub_bucket_count)
+         << shift;
+}
+
+uint64_t LatencyHistogram::BucketWidth(size_t index) {
+  const size_t sub_bucket_count = static_cast<size_t>(kSubBucketCount);
+  if (index < sub_bucket_count) {
+    return 1;
+  }
+  return uint64_t{1} << (index / sub_bucket_count - 1);
+}
+
+void LatencyHistogram::Record(int64_t value, int64_t count) {
+  if (count <= 0) {
+    return;
+  }
+  value = std::max<int64_t>(value, 0);
+  if (buckets_.empty()) {
+    buckets_.resize(kNumBuckets);
+    min_ = value;
+    max_ = value;
+  }
+  buckets_[BucketIndex(static_cast<uint64_t>(value))] += count;
+  count_ += count;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  if (other.empty()) {
+    return;
+  }
+  if (empty()) {
+    *this = other;
+    return;
+  }
+  BM_CHECK_EQ(buckets_.size(), other.buckets_.size());
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::Reset() {
+  buckets_.clear();
+  count_ = 0;
+  min_ = 0;
+  max_ = 0;
+}
+
+double LatencyHistogram::ValueAtPercentile(double percentile) const {
+  if (empty()) {
+    return 0.0;
+  }
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  // The rank of the sample we are looking for, 1-based.
+  const int64_t rank = std::max<int64_t>(
+      1, static_cast<int64_t>(
+             std::ceil(percentile / 100.0 * static_cast<double>(count_))));
+  // The largest sample is known exactly.
+  if (rank >= count_) {
+    return static_cast<double>(max_);
+  }
+  int64_t seen = 0;
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      // Report the middle of the bucket, but never outside of what was
+      // actually observed.
+      const double mid = static_cast<double>(BucketLowerBound(i)) +
+                         static_cast<double>(BucketWidth(i) - 1) / 2.0;
+      return std::min(std::max(mid, static_cast<double>(min_)),
+                      static_cast<double>(max_));
+    }
+  }
+  return static_cast<double>(max_);
+}
+
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,74 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_LATENCY_HISTOGRAM_H_
+#define BENCHMARK_LATENCY_HISTOGRAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/export.h"
+
+namespace benchmark {
+namespace internal {
+
+// A log-linear histogram of non-negative integer samples, in the spirit of
+// HdrHistogram. Values below kSubBucketCount are stored exactly; larger values
+// keep their kSubBucketBits most significant bits, which bounds the relative
+// error of any reported value by 1/kSubBucketCount.
+//
+// Recording is a couple of shifts and an increment, so it is cheap enough to
+// be done once per benchmark iteration. Storage is only allocated on the first
+// recorded sample, which keeps unused histograms free to copy around.
+class BENCHMARK_EXPORT LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 6;
+  static constexpr int64_t kSubBucketCount = int64_t{1} << kSubBucketBits;
+
+  // Records `count` samples of `value`. Negative values are clamped to 0.
+  void Record(int64_t value, int64_t count = 1);
+
+  // Adds all samples of `other` into this histogram.
+  void Merge(const LatencyHistogram& other);
+
+  void Reset();
+
+  int64_t count() const { return count_; }
+  bool empty() const { return count_ == 0; }
+
+  // REQUIRES: !empty()
+  int64_t min() const { return min_; }
+  int64_t max() const { return max_; }
+
+  // Returns the value that `percentile` percent (in [0, 100]) of the recorded
+  // samples are less than or equal to, up to the precision of the buckets.
+  // Returns 0 when no samples have been recorded.
+  double ValueAtPercentile(double percentile) const;
+
+ private:
+  static size_t BucketIndex(uint64_t value);
+  static uint64_t BucketLowerBound(size_t index);
+  static uint64_t BucketWidth(size_t index);
+
+  std::vector<int64_t> buckets_;
+  int64_t count_ = 0;
+  int64_t min_ = 0;
+  int64_t max_ = 0;
+};
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_LATENCY_HISTOGRAM_H_
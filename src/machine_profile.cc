@@ -0,0 +1,175 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "machine_profile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <utility>
+
+#include "json_reader.h"
+
+namespace benchmark {
+namespace internal {
+
+namespace {
+
+bool WriteFile(const std::string& path, const std::string& contents,
+               std::string* error) {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file.is_open()) {
+    *error = "cannot open file";
+    return false;
+  }
+  file << contents;
+  if (!file.good()) {
+    *error = "cannot write file";
+    return false;
+  }
+  return true;
+}
+
+std::ostringstream JsonStream() {
+  std::ostringstream json;
+  json.imbue(std::locale::classic());
+  json.precision(std::numeric_limits<double>::max_digits10);
+  return json;
+}
+
+}  // namespace
+
+bool MachineProfile::Load(const std::string& path, std::string* error) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    *error = "cannot open file";
+    return false;
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return Parse(contents.str(), error);
+}
+
+bool MachineProfile::Parse(const std::string& json, std::string* error) {
+  JsonValue document;
+  if (!ParseJson(json, &document, error)) {
+    return false;
+  }
+  if (document.type != JsonValue::kObject) {
+    *error = "not an object";
+    return false;
+  }
+  values_.clear();
+  for (const auto& member : document.object) {
+    if (member.second.type != JsonValue::kNumber) {
+      *error = "\"" + member.first + "\" is not a number";
+      return false;
+    }
+    values_[member.first] = member.second.number;
+  }
+  return true;
+}
+
+bool MachineProfile::Save(const std::string& path, std::string* error) const {
+  return WriteFile(path, ToJson(), error);
+}
+
+std::string MachineProfile::ToJson() const {
+  // The names are identifiers, which need no escaping.
+  std::ostringstream json = JsonStream();
+  json << "{";
+  for (auto it = values_.begin(); it != values_.end(); ++it) {
+    json << (it == values_.begin() ? "\n" : ",\n") << "  \"" << it->first
+         << "\": " << it->second;
+  }
+  json << "\n}\n";
+  return json.str();
+}
+
+CoreToCoreLatencies::CoreToCoreLatencies(std::vector<int> cpus)
+    : cpus_(std::move(cpus)),
+      seconds_(cpus_.size(), std::vector<double>(cpus_.size(), 0.0)) {}
+
+int CoreToCoreLatencies::IndexOf(int cpu) const {
+  auto it = std::find(cpus_.begin(), cpus_.end(), cpu);
+  return it == cpus_.end() ? -1 : static_cast<int>(it - cpus_.begin());
+}
+
+void CoreToCoreLatencies::Add(int cpu_a, int cpu_b, double seconds) {
+  const int a = IndexOf(cpu_a);
+  const int b = IndexOf(cpu_b);
+  if (a < 0 || b < 0 || seconds <= 0) {
+    return;
+  }
+  // The round trip is the same in both directions.
+  double& best = seconds_[static_cast<size_t>(a)][static_cast<size_t>(b)];
+  if (best <= 0 || seconds < best) {
+    best = seconds;
+    seconds_[static_cast<size_t>(b)][static_cast<size_t>(a)] = seconds;
+  }
+}
+
+double CoreToCoreLatencies::Get(int cpu_a, int cpu_b) const {
+  const int a = IndexOf(cpu_a);
+  const int b = IndexOf(cpu_b);
+  if (a < 0 || b < 0) {
+    return 0.0;
+  }
+  return seconds_[static_cast<size_t>(a)][static_cast<size_t>(b)];
+}
+
+bool CoreToCoreLatencies::Save(
+    const std::string& path, const std::vector<CPUInfo::LogicalCPU>& topology,
+    std::string* error) const {
+  return WriteFile(path, ToJson(topology), error);
+}
+
+std::string CoreToCoreLatencies::ToJson(
+    const std::vector<CPUInfo::LogicalCPU>& topology) const {
+  std::ostringstream json = JsonStream();
+  json << "{\n  \"cpus\": [";
+  for (size_t i = 0; i < cpus_.size(); ++i) {
+    json << (i == 0 ? "\n" : ",\n") << "    {\"cpu\": " << cpus_[i];
+    for (const CPUInfo::LogicalCPU& logical : topology) {
+      if (logical.cpu == cpus_[i]) {
+        json << ", \"core\": " << logical.core
+             << ", \"package\": " << logical.package
+             << ", \"l2_domain\": " << logical.l2_domain
+             << ", \"numa_node\": " << logical.numa_node;
+        break;
+      }
+    }
+    json << "}";
+  }
+  json << "\n  ],\n  \"round_trip_latency\": [";
+  for (size_t a = 0; a < cpus_.size(); ++a) {
+    json << (a == 0 ? "\n" : ",\n") << "    [";
+    for (size_t b = 0; b < cpus_.size(); ++b) {
+      json << (b == 0 ? "" : ", ");
+      if (seconds_[a][b] > 0) {
+        json << seconds_[a][b];
+      } else {
+        json << "null";
+      }
+    }
+    json << "]";
+  }
+  json << "\n  ]\n}\n";
+  return json.str();
+}
+
+}  // namespace internal
+}  // namespace benchmark
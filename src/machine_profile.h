@@ -0,0 +1,99 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_MACHINE_PROFILE_H_
+#define BENCHMARK_MACHINE_PROFILE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark/export.h"
+#include "benchmark/sysinfo.h"
+
+namespace benchmark {
+namespace internal {
+
+// The performance ceilings of a machine, as measured by the
+// benchmark_machine_profile tool, by name:
+// - "<kernel>_bandwidth": the bytes per second of the STREAM copy, scale and
+//   triad kernels on one thread, and "<kernel>_bandwidth_all_cpus" on a thread
+//   per CPU. "triad_bandwidth_node<N>_all_cpus" is the latter with the memory
+//   on NUMA node N, if there are several.
+// - "<level>_latency": the seconds per load of a pointer chase through a
+//   working set in the cache level ("L1", "L2"...) or "memory".
+// - "scalar_flops" and "simd_flops": the floating point operations per second
+//   on one thread, with scalar and the widest supported vector instructions.
+class BENCHMARK_EXPORT MachineProfile {
+ public:
+  // Reads the profile in `path`. On failure, returns false and describes the
+  // problem in `error`.
+  bool Load(const std::string& path, std::string* error);
+
+  // Like Load(), but from the contents of a file.
+  bool Parse(const std::string& json, std::string* error);
+
+  // Writes the profile to `path`, as a JSON object. On failure, returns false
+  // and describes the problem in `error`.
+  bool Save(const std::string& path, std::string* error) const;
+
+  std::string ToJson() const;
+
+  std::map<std::string, double>& values() { return values_; }
+  const std::map<std::string, double>& values() const { return values_; }
+
+ private:
+  std::map<std::string, double> values_;
+};
+
+// The round-trip latencies of a cache line passed back and forth between two
+// threads on each pair of a set of CPUs, as measured by
+// benchmark_machine_profile --core_to_core_out.
+class BENCHMARK_EXPORT CoreToCoreLatencies {
+ public:
+  explicit CoreToCoreLatencies(std::vector<int> cpus);
+
+  // Records `seconds` for the pair of CPUs, keeping the lowest of several.
+  // Ignores CPUs that are not in the set.
+  void Add(int cpu_a, int cpu_b, double seconds);
+
+  // The seconds recorded for the pair of CPUs, 0 if none.
+  double Get(int cpu_a, int cpu_b) const;
+
+  // Writes the latencies to `path`, as returned by ToJson(). On failure,
+  // returns false and describes the problem in `error`.
+  bool Save(const std::string& path,
+            const std::vector<CPUInfo::LogicalCPU>& topology,
+            std::string* error) const;
+
+  // A JSON object with the CPUs, with their core, package, L2 cache and NUMA
+  // node where `topology` has them, and the "round_trip_latency" matrix in
+  // seconds, whose rows and columns are in the order of the CPUs. Pairs
+  // without a latency are null.
+  std::string ToJson(const std::vector<CPUInfo::LogicalCPU>& topology) const;
+
+  const std::vector<int>& cpus() const { return cpus_; }
+
+ private:
+  // The index of `cpu` in cpus_, or -1.
+  int IndexOf(int cpu) const;
+
+  std::vector<int> cpus_;
+  std::vector<std::vector<double>> seconds_;
+};
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_MACHINE_PROFILE_H_
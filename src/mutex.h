@@ -1,10 +1,22 @@
 #ifndef BENCHMARK_MUTEX_H_
 #define BENCHMARK_MUTEX_H_
 
+#include <atomic>
+#include <climits>
 #include <condition_variable>
+#include <cstdint>
 #include <mutex>
+#include <thread>
 
 #include "check.h"
+#include "cycleclock.h"
+#include "internal_macros.h"
+
+#if defined(BENCHMARK_OS_LINUX)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 // Enable thread safety attributes only with clang.
 // The attributes can be safely erased when compiling with other compilers.
@@ -96,58 +108,157 @@ class SCOPED_CAPABILITY MutexLock {
   MutexLockImp ml_;
 };
 
+// Lets the CPU know that we are busy-waiting, e.g. to give the other hardware
+// thread of the core more resources.
+inline void SpinPause() {
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+  __builtin_ia32_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+// A reusable barrier for a group of threads that may shrink over time.
+//
+// Threads that arrive early spin for a bounded amount of time before going to
+// sleep, so that on release they are usually still running and leave within a
+// fraction of a microsecond of each other, rather than being woken up one by
+// one. Sleeping uses a futex where available.
+//
+// The number of participating and arrived threads share one atomic word, so
+// that exactly one party observes the barrier completing; it then advances the
+// phase, whose change is what all other threads wait for (a generalization of
+// sense reversal).
 class Barrier {
  public:
-  Barrier(int num_threads) : running_threads_(num_threads) {}
-
-  // Called by each thread
-  bool wait() EXCLUDES(lock_) {
-    bool last_thread = false;
-    {
-      MutexLock ml(lock_);
-      last_thread = createBarrier(ml);
+  explicit Barrier(int num_threads)
+      : state_(Pack(static_cast<uint32_t>(num_threads), 0)),
+        spin_(static_cast<unsigned>(num_threads) <=
+              std::thread::hardware_concurrency()) {}
+
+  // Called by each thread. Returns true for the thread that released the
+  // barrier. If given, `release_delay` is set to the number of cycle clock
+  // ticks between the barrier being released and this thread leaving it.
+  bool wait(int64_t* release_delay = nullptr) {
+    const uint32_t phase = phase_.load(std::memory_order_acquire);
+    const bool released = Arrive(/*remove=*/false);
+    if (!released) {
+      WaitForPhaseChange(phase);
+    }
+    if (release_delay != nullptr) {
+      *release_delay =
+          released ? 0
+                   : cycleclock::Now() -
+                         release_time_.load(std::memory_order_relaxed);
     }
-    if (last_thread) phase_condition_.notify_all();
-    return last_thread;
+    return released;
   }
 
-  void removeThread() EXCLUDES(lock_) {
-    MutexLock ml(lock_);
-    --running_threads_;
-    if (entered_ != 0) phase_condition_.notify_all();
-  }
+  // Removes the calling thread from the group. This releases the barrier if
+  // all remaining threads are already waiting on it.
+  void removeThread() { Arrive(/*remove=*/true); }
 
  private:
-  Mutex lock_;
-  Condition phase_condition_;
-  int running_threads_;
-
-  // State for barrier management
-  int phase_number_ = 0;
-  int entered_ = 0;  // Number of threads that have entered this barrier
-
-  // Enter the barrier and wait until all other threads have also
-  // entered the barrier.  Returns iff this is the last thread to
-  // enter the barrier.
-  bool createBarrier(MutexLock& ml) REQUIRES(lock_) {
-    BM_CHECK_LT(entered_, running_threads_);
-    entered_++;
-    if (entered_ < running_threads_) {
-      // Wait for all threads to enter
-      int phase_number_cp = phase_number_;
-      auto cb = [this, phase_number_cp]() {
-        return this->phase_number_ > phase_number_cp ||
-               entered_ == running_threads_;  // A thread has aborted in error
-      };
-      phase_condition_.wait(ml.native_handle(), cb);
-      if (phase_number_ > phase_number_cp) return false;
-      // else (running_threads_ == entered_) and we are the last thread.
+  // How often a waiting thread checks for the release before going to sleep,
+  // which at about 100 cycles per pause adds up to a few hundred microseconds.
+  static constexpr int kSpinIterations = 1 << 12;
+
+  static uint64_t Pack(uint32_t running, uint32_t entered) {
+    return (static_cast<uint64_t>(running) << 32) | entered;
+  }
+  static uint32_t Running(uint64_t state) {
+    return static_cast<uint32_t>(state >> 32);
+  }
+  static uint32_t Entered(uint64_t state) {
+    return static_cast<uint32_t>(state);
+  }
+
+  // Returns true if this call completed the current phase, in which case it
+  // has also released the waiting threads.
+  bool Arrive(bool remove) {
+    uint64_t state = state_.load(std::memory_order_relaxed);
+    for (;;) {
+      const uint32_t running = Running(state) - (remove ? 1 : 0);
+      const uint32_t entered = Entered(state) + (remove ? 0 : 1);
+      BM_CHECK_LE(entered, running);
+      const bool complete = entered != 0 && entered == running;
+      if (state_.compare_exchange_weak(state,
+                                       Pack(running, complete ? 0 : entered),
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
+        if (complete) {
+          Release();
+        }
+        return complete;
+      }
     }
-    // Last thread has reached the barrier
-    phase_number_++;
-    entered_ = 0;
-    return true;
   }
+
+  void Release() {
+    release_time_.store(cycleclock::Now(), std::memory_order_relaxed);
+    // Pairs with the increment of sleepers_ in WaitForPhaseChange(): either we
+    // see the sleeper, or it sees the new phase before going to sleep.
+    phase_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) != 0) {
+      WakeAll();
+    }
+  }
+
+  void WaitForPhaseChange(uint32_t phase) {
+    if (spin_) {
+      for (int i = 0; i < kSpinIterations; ++i) {
+        if (phase_.load(std::memory_order_acquire) != phase) {
+          return;
+        }
+        SpinPause();
+      }
+    }
+    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+    while (phase_.load(std::memory_order_seq_cst) == phase) {
+      Sleep(phase);
+    }
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+#if defined(BENCHMARK_OS_LINUX)
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "the phase is used as a futex word");
+
+  // Returns when woken up, or right away if the phase is no longer `phase`.
+  void Sleep(uint32_t phase) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&phase_),
+            FUTEX_WAIT_PRIVATE, phase, nullptr, nullptr, 0);
+  }
+
+  void WakeAll() {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&phase_),
+            FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+  }
+#else
+  void Sleep(uint32_t phase) {
+    MutexLock ml(sleep_lock_);
+    sleep_condition_.wait(ml.native_handle(), [this, phase]() {
+      return phase_.load(std::memory_order_seq_cst) != phase;
+    });
+  }
+
+  void WakeAll() {
+    // Taking the lock orders this after any sleeper has checked the phase.
+    { MutexLock ml(sleep_lock_); }
+    sleep_condition_.notify_all();
+  }
+
+  Mutex sleep_lock_;
+  Condition sleep_condition_;
+#endif
+
+  std::atomic<uint64_t> state_;
+  std::atomic<uint32_t> phase_{0};
+  std::atomic<int> sleepers_{0};
+  std::atomic<int64_t> release_time_{0};
+  // Spinning only helps if every thread has a CPU of its own.
+  const bool spin_;
 };
 
 }  // end namespace benchmark
@@ -0,0 +1,184 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "numa.h"
+
+#include "internal_macros.h"
+
+#if defined(BENCHMARK_OS_LINUX)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <climits>
+
+#include "log.h"
+
+namespace benchmark {
+namespace internal {
+
+#if defined(BENCHMARK_OS_LINUX)
+namespace {
+
+// Large enough for any kernel configuration in use. Node masks are passed to
+// the kernel directly rather than through libnuma, so that it is not a
+// dependency.
+constexpr size_t kMaxNodes = 4096;
+constexpr size_t kBitsPerWord = sizeof(unsigned long) * CHAR_BIT;
+
+using NodeMask = std::vector<unsigned long>;
+
+NodeMask MakeNodeMask(const std::vector<int>& nodes) {
+  NodeMask mask(kMaxNodes / kBitsPerWord);
+  for (int node : nodes) {
+    const size_t n = static_cast<size_t>(node);
+    mask[n / kBitsPerWord] |= 1UL << (n % kBitsPerWord);
+  }
+  return mask;
+}
+
+long SetMemPolicy(int mode, const NodeMask* mask) {
+  // The kernel only looks at the first `maxnode - 1` bits.
+  return syscall(SYS_set_mempolicy, mode,
+                 mask != nullptr ? mask->data() : nullptr,
+                 mask != nullptr ? kMaxNodes + 1 : 0);
+}
+
+long GetMemPolicy(int* mode, NodeMask* mask, unsigned long flags) {
+  mask->assign(kMaxNodes / kBitsPerWord, 0);
+  return syscall(SYS_get_mempolicy, mode, mask->data(), kMaxNodes + 1,
+                 nullptr, flags);
+}
+
+}  // namespace
+#endif
+
+bool MemoryPolicySupported() {
+#if defined(BENCHMARK_OS_LINUX)
+  return !GetAllowedMemoryNodes().empty();
+#else
+  return false;
+#endif
+}
+
+std::vector<int> GetAllowedMemoryNodes() {
+  std::vector<int> res;
+#if defined(BENCHMARK_OS_LINUX)
+  NodeMask mask;
+  if (GetMemPolicy(nullptr, &mask, MPOL_F_MEMS_ALLOWED) != 0) {
+    return res;
+  }
+  for (size_t node = 0; node < kMaxNodes; ++node) {
+    if ((mask[node / kBitsPerWord] >> (node % kBitsPerWord)) & 1UL) {
+      res.push_back(static_cast<int>(node));
+    }
+  }
+#endif
+  return res;
+}
+
+int GetCurrentNumaNode() {
+#if defined(BENCHMARK_OS_LINUX)
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return static_cast<int>(node);
+  }
+#endif
+  return -1;
+}
+
+ScopedMemoryPolicy::ScopedMemoryPolicy(const NumaPolicy& policy) {
+  if (policy.mode == NumaPolicy::kDefault) {
+    return;
+  }
+#if defined(BENCHMARK_OS_LINUX)
+  if (GetMemPolicy(&old_mode_, &old_nodes_, 0) == 0) {
+    switch (policy.mode) {
+      case NumaPolicy::kLocal:
+        // MPOL_LOCAL needs Linux 3.8, an empty preferred set means the same.
+        applied_ = SetMemPolicy(MPOL_LOCAL, nullptr) == 0 ||
+                   SetMemPolicy(MPOL_PREFERRED, nullptr) == 0;
+        break;
+      case NumaPolicy::kInterleave: {
+        const NodeMask mask = MakeNodeMask(GetAllowedMemoryNodes());
+        applied_ = SetMemPolicy(MPOL_INTERLEAVE, &mask) == 0;
+        break;
+      }
+      case NumaPolicy::kNode:
+        if (policy.node >= 0 && static_cast<size_t>(policy.node) < kMaxNodes) {
+          const NodeMask mask = MakeNodeMask({policy.node});
+          applied_ = SetMemPolicy(MPOL_BIND, &mask) == 0;
+        }
+        break;
+      case NumaPolicy::kDefault:
+        break;
+    }
+  }
+#endif
+  static std::atomic<bool> warned(false);
+  if (!applied_ && !warned.exchange(true)) {
+    GetErrorLogInstance() << "***WARNING*** Failed to set the NUMA memory "
+                             "policy of a benchmark, its memory is placed "
+                             "as usual.\n";
+  }
+}
+
+ScopedMemoryPolicy::~ScopedMemoryPolicy() {
+#if defined(BENCHMARK_OS_LINUX)
+  if (applied_) {
+    SetMemPolicy(old_mode_, old_mode_ == MPOL_DEFAULT ? nullptr : &old_nodes_);
+  }
+#endif
+}
+
+double NumaDistanceToData(const NumaPolicy& policy, int exec_node,
+                          const std::vector<int>& memory_nodes,
+                          const std::vector<std::vector<int>>& distances) {
+  auto distance = [&distances, exec_node](int node) {
+    if (exec_node < 0 || node < 0 ||
+        static_cast<size_t>(exec_node) >= distances.size() ||
+        static_cast<size_t>(node) >= distances.size()) {
+      return -1;
+    }
+    return distances[static_cast<size_t>(exec_node)][static_cast<size_t>(node)];
+  };
+  switch (policy.mode) {
+    case NumaPolicy::kLocal:
+      return distance(exec_node);
+    case NumaPolicy::kNode:
+      return distance(policy.node);
+    case NumaPolicy::kInterleave: {
+      double sum = 0;
+      for (int node : memory_nodes) {
+        const int d = distance(node);
+        if (d < 0) {
+          return -1;
+        }
+        sum += d;
+      }
+      return memory_nodes.empty()
+                 ? -1
+                 : sum / static_cast<double>(memory_nodes.size());
+    }
+    case NumaPolicy::kDefault:
+      break;
+  }
+  return -1;
+}
+
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,67 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_NUMA_H_
+#define BENCHMARK_NUMA_H_
+
+#include <vector>
+
+#include "benchmark/export.h"
+#include "benchmark/types.h"
+
+namespace benchmark {
+namespace internal {
+
+// Whether NumaPolicy can be applied on this platform.
+bool MemoryPolicySupported();
+
+// Returns the NUMA nodes the calling thread may allocate memory on, in
+// increasing order, or an empty vector if this is unknown.
+std::vector<int> GetAllowedMemoryNodes();
+
+// Returns the NUMA node of the CPU the calling thread is running on, or -1 if
+// this is unknown.
+int GetCurrentNumaNode();
+
+// Sets the memory policy of the calling thread for the lifetime of the object,
+// and restores the previous one afterwards. Does nothing for
+// NumaPolicy::kDefault. A warning is logged the first time a policy cannot be
+// set.
+class ScopedMemoryPolicy {
+ public:
+  explicit ScopedMemoryPolicy(const NumaPolicy& policy);
+  ~ScopedMemoryPolicy();
+
+  ScopedMemoryPolicy(const ScopedMemoryPolicy&) = delete;
+  ScopedMemoryPolicy& operator=(const ScopedMemoryPolicy&) = delete;
+
+ private:
+  bool applied_ = false;
+  int old_mode_ = 0;
+  std::vector<unsigned long> old_nodes_;
+};
+
+// Returns the average NUMA distance (see CPUInfo::numa_distances) from
+// `exec_node` to the memory placed under `policy`, where memory is spread over
+// `memory_nodes` for NumaPolicy::kInterleave. Returns -1 if this is unknown,
+// including for NumaPolicy::kDefault.
+BENCHMARK_EXPORT
+double NumaDistanceToData(const NumaPolicy& policy, int exec_node,
+                          const std::vector<int>& memory_nodes,
+                          const std::vector<std::vector<int>>& distances);
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_NUMA_H_
@@ -14,9 +14,11 @@
 
 #include "perf_counters.h"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <optional>
+#include <set>
 #include <vector>
 
 #if defined HAVE_LIBPFM
@@ -41,12 +43,23 @@ size_t PerfCounterValues::Read(const std::vector<int>& leaders) {
   size_t size = bufsize;
   for (int lead : leaders) {
     auto read_bytes = ::read(lead, ptr, size);
-    if (read_bytes >= ssize_t(sizeof(uint64_t))) {
-      // Actual data bytes are all bytes minus initial padding
+    uint64_t header[kPadding];
+    if (read_bytes >= ssize_t(sizeof(header))) {
+      std::memcpy(header, ptr, sizeof(header));
+      // Actual data bytes are all bytes minus the header
       std::size_t data_bytes =
-          static_cast<std::size_t>(read_bytes) - sizeof(uint64_t);
+          static_cast<std::size_t>(read_bytes) - sizeof(header);
       // This should be very cheap since it's in hot cache
-      std::memmove(ptr, ptr + sizeof(uint64_t), data_bytes);
+      std::memmove(ptr, ptr + sizeof(header), data_bytes);
+      const size_t first =
+          static_cast<size_t>(ptr - reinterpret_cast<char*>(values_.data())) /
+          sizeof(uint64_t);
+      const size_t last =
+          std::min(first + data_bytes / sizeof(uint64_t), kMaxCounters);
+      for (size_t i = first; i < last; ++i) {
+        time_enabled_[i] = header[1];
+        time_running_[i] = header[2];
+      }
       // Increment our counters
       ptr += data_bytes;
       size -= data_bytes;
@@ -209,9 +222,10 @@ PerfCounters PerfCounters::Create(
     attr.exclude_user = false;
     attr.exclude_hv = true;
 
-    // Read all counters in a group in one read.
-    attr.read_format = PERF_FORMAT_GROUP;  //| PERF_FORMAT_TOTAL_TIME_ENABLED |
-                                           // PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // Read all counters in a group in one read, along with the times needed to
+    // scale the counts when the group is multiplexed.
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
 
     uint64_t base_config = attr.config;
     for (uint64_t pmu : GetPMUTypesForEvent(attr)) {
@@ -290,6 +304,28 @@ PerfCounters PerfCounters::Create(
                       std::move(leader_ids));
 }
 
+std::vector<std::vector<std::string>> PerfCounters::GroupNames() const {
+  std::vector<std::vector<std::string>> groups;
+  std::set<std::string> grouped;
+  size_t leader = 0;
+  for (size_t i = 0; i < counter_ids_.size(); ++i) {
+    if (leader < leader_ids_.size() && counter_ids_[i] == leader_ids_[leader]) {
+      groups.emplace_back();
+      ++leader;
+    }
+    if (!groups.empty() && grouped.insert(counter_names_[i]).second) {
+      groups.back().push_back(counter_names_[i]);
+    }
+  }
+  // Groups of replicas only.
+  groups.erase(std::remove_if(groups.begin(), groups.end(),
+                              [](const std::vector<std::string>& group) {
+                                return group.empty();
+                              }),
+               groups.end());
+  return groups;
+}
+
 void PerfCounters::CloseCounters() const {
   if (counter_ids_.empty()) {
     return;
@@ -318,6 +354,10 @@ PerfCounters PerfCounters::Create(
   return NoCounters();
 }
 
+std::vector<std::vector<std::string>> PerfCounters::GroupNames() const {
+  return {};
+}
+
 void PerfCounters::CloseCounters() const {}
 #endif  // defined HAVE_LIBPFM
 
@@ -327,6 +367,33 @@ PerfCountersMeasurement::PerfCountersMeasurement(
   counters_ = PerfCounters::Create(counter_names);
 }
 
+void PerfCountersMeasurement::Reopen() {
+  const std::vector<std::string> counter_names = counters_.names();
+  counters_ = PerfCounters::Create(counter_names);
+  valid_read_ = true;
+}
+
+void PerfCountersMeasurement::SplitIntoGroups() {
+  groups_ = counters_.GroupNames();
+  group_ = 0;
+  if (groups_.size() > 1) {
+    counters_ = PerfCounters::Create(groups_[group_]);
+    valid_read_ = true;
+  }
+}
+
+void PerfCountersMeasurement::SelectGroup(size_t index) {
+  if (groups_.size() <= 1 || index == group_) {
+    return;
+  }
+  group_ = index;
+  // Close the counters of the previous group first, or they would compete
+  // with the new ones for the PMU.
+  counters_ = PerfCounters::NoCounters();
+  counters_ = PerfCounters::Create(groups_[group_]);
+  valid_read_ = true;
+}
+
 PerfCounters& PerfCounters::operator=(PerfCounters&& other) noexcept {
   if (this != &other) {
     CloseCounters();
@@ -43,14 +43,15 @@ namespace benchmark {
 namespace internal {
 
 // Typically, we can only read a small number of counters. There is also a
-// padding preceding counter values, when reading multiple counters with one
+// header preceding counter values, when reading multiple counters with one
 // syscall (which is desirable). PerfCounterValues abstracts these details.
 // The implementation ensures the storage is inlined, and allows 0-based
 // indexing into the counter values.
 // The object is used in conjunction with a PerfCounters object, by passing it
 // to Snapshot(). The Read() method relocates individual reads, discarding
-// the initial padding from each group leader in the values buffer such that
-// all user accesses through the [] operator are correct.
+// the header of each group leader in the values buffer such that all user
+// accesses through the [] operator are correct. The times in the header are
+// kept for each counter of the group.
 class BENCHMARK_EXPORT PerfCounterValues {
  public:
   explicit PerfCounterValues(size_t nr_counters) : nr_counters_(nr_counters) {
@@ -60,6 +61,12 @@ class BENCHMARK_EXPORT PerfCounterValues {
   // We are reading correctly now so the values don't need to skip padding
   uint64_t operator[](size_t pos) const { return values_[pos]; }
 
+  // How long the group of the counter at `pos` was enabled, and how long it
+  // was actually counting, in nanoseconds. The latter is shorter when the
+  // kernel multiplexes groups that don't fit into the PMU at the same time.
+  uint64_t time_enabled(size_t pos) const { return time_enabled_[pos]; }
+  uint64_t time_running(size_t pos) const { return time_running_[pos]; }
+
   // Increased the maximum to 32 only since the buffer
   // is std::array<> backed
   static constexpr size_t kMaxCounters = 32;
@@ -78,10 +85,12 @@ class BENCHMARK_EXPORT PerfCounterValues {
   // a better place for it
   size_t Read(const std::vector<int>& leaders);
 
-  // Move the padding to 2 due to the reading algorithm (1st padding plus a
-  // current read padding)
-  static constexpr size_t kPadding = 2;
+  // The header of a group read: the number of counters, the time enabled and
+  // the time running.
+  static constexpr size_t kPadding = 3;
   std::array<uint64_t, kPadding + kMaxCounters> values_;
+  std::array<uint64_t, kMaxCounters> time_enabled_{};
+  std::array<uint64_t, kMaxCounters> time_running_{};
   const size_t nr_counters_;
 };
 
@@ -134,6 +143,11 @@ class BENCHMARK_EXPORT PerfCounters final {
   const std::vector<std::string>& names() const { return counter_names_; }
   size_t num_counters() const { return counter_names_.size(); }
 
+  // Returns the names of the counters of each group, in the order the groups
+  // were created. A name replicated on several PMUs is only listed in the
+  // first group it is in.
+  std::vector<std::vector<std::string>> GroupNames() const;
+
  private:
   PerfCounters(const std::vector<std::string>& counter_names,
                std::vector<int>&& counter_ids, std::vector<int>&& leader_ids)
@@ -157,6 +171,27 @@ class BENCHMARK_EXPORT PerfCountersMeasurement final {
 
   const std::vector<std::string>& names() const { return counters_.names(); }
 
+  // Opens the counters again, so that they count the calling process. This is
+  // needed after a fork(), as the inherited counters keep counting the parent.
+  void Reopen();
+
+  // Splits the counters into the groups the PMU can count at the same time,
+  // and from then on only opens one of them at a time, selected with
+  // SelectGroup(). The first group is selected.
+  void SplitIntoGroups();
+
+  // The number of groups SplitIntoGroups() made, or 1.
+  size_t num_groups() const { return groups_.empty() ? 1 : groups_.size(); }
+
+  // Opens the counters of the group `index`, if not opened already.
+  void SelectGroup(size_t index);
+
+  // The times the counters were enabled and running, summed over all
+  // counters and all Stop() calls, in nanoseconds. Their ratio is the fraction
+  // of the time the counters were actually counting.
+  double time_enabled() const { return time_enabled_; }
+  double time_running() const { return time_running_; }
+
   BENCHMARK_ALWAYS_INLINE bool Start() {
     if (num_counters() == 0) return true;
     // Tell the compiler to not move instructions above/below where we take
@@ -180,6 +215,19 @@ class BENCHMARK_EXPORT PerfCountersMeasurement final {
     for (size_t i = 0; i < counters_.names().size(); ++i) {
       double measurement = static_cast<double>(end_values_[i]) -
                            static_cast<double>(start_values_[i]);
+      const double enabled =
+          static_cast<double>(end_values_.time_enabled(i)) -
+          static_cast<double>(start_values_.time_enabled(i));
+      const double running =
+          static_cast<double>(end_values_.time_running(i)) -
+          static_cast<double>(start_values_.time_running(i));
+      // While multiplexed, the counter only saw part of the interval, so its
+      // count is extrapolated to all of it.
+      if (running > 0 && running < enabled) {
+        measurement *= enabled / running;
+      }
+      time_enabled_ += enabled;
+      time_running_ += running;
       measurements.push_back({counters_.names()[i], measurement});
     }
 
@@ -188,6 +236,10 @@ class BENCHMARK_EXPORT PerfCountersMeasurement final {
 
  private:
   PerfCounters counters_;
+  std::vector<std::vector<std::string>> groups_;
+  size_t group_ = 0;
+  double time_enabled_ = 0;
+  double time_running_ = 0;
   bool valid_read_ = true;
   PerfCounterValues start_values_;
   PerfCounterValues end_values_;
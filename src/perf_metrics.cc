@@ -0,0 +1,177 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perf_metrics.h"
+
+#include <algorithm>
+#include <map>
+
+#include "log.h"
+
+namespace benchmark {
+namespace internal {
+
+namespace {
+
+using Variant = PerfMetrics::Variant;
+
+double Ratio(double numerator, double denominator) {
+  return denominator > 0 ? numerator / denominator : 0.0;
+}
+
+// Events per thousand instructions.
+Variant PerKiloInstructions(const std::string& event,
+                            const std::string& metric) {
+  return {{event, "INSTRUCTIONS"},
+          [metric](const std::vector<double>& values, double,
+                   UserCounters* counters) {
+            (*counters)[metric] = Counter(1000 * Ratio(values[0], values[1]));
+          }};
+}
+
+// The top-down level 1 breakdown on Intel cores from Sandy Bridge to Cascade
+// Lake, which issue and retire up to 4 uops per cycle. See "A Top-Down Method
+// for Performance Analysis and Counters Architecture" by Ahmad Yasin.
+Variant IntelTopDown() {
+  return {{"UNHALTED_CORE_CYCLES", "IDQ_UOPS_NOT_DELIVERED:CORE",
+           "UOPS_ISSUED:ANY", "UOPS_RETIRED:RETIRE_SLOTS",
+           "INT_MISC:RECOVERY_CYCLES"},
+          [](const std::vector<double>& values, double,
+             UserCounters* counters) {
+            constexpr double kWidth = 4;
+            const double slots = kWidth * values[0];
+            const double frontend_bound = Ratio(values[1], slots);
+            const double bad_speculation =
+                std::max(Ratio(values[2] - values[3] + kWidth * values[4],
+                               slots),
+                         0.0);
+            const double retiring = Ratio(values[3], slots);
+            (*counters)["frontend_bound"] = Counter(frontend_bound);
+            (*counters)["bad_speculation"] = Counter(bad_speculation);
+            (*counters)["retiring"] = Counter(retiring);
+            (*counters)["backend_bound"] = Counter(std::max(
+                1 - frontend_bound - bad_speculation - retiring, 0.0));
+          }};
+}
+
+// The ways to compute each metric, in order of preference.
+const std::map<std::string, std::vector<Variant>>& GetVariants() {
+  static const auto* const variants =
+      new std::map<std::string, std::vector<Variant>>{
+          {"ipc",
+           {{{"INSTRUCTIONS", "CYCLES"},
+             [](const std::vector<double>& values, double,
+                UserCounters* counters) {
+               (*counters)["IPC"] = Counter(Ratio(values[0], values[1]));
+             }}}},
+          {"tma", {IntelTopDown()}},
+          {"cache_mpki", {PerKiloInstructions("CACHE-MISSES", "cache_MPKI")}},
+          {"branch_mpki",
+           {PerKiloInstructions("BRANCH-MISSES", "branch_MPKI")}},
+          {"frequency",
+           {{{"CYCLES"},
+             [](const std::vector<double>& values, double cpu_seconds,
+                UserCounters* counters) {
+               if (cpu_seconds > 0) {
+                 (*counters)["cpu_frequency"] =
+                     Counter(values[0] / cpu_seconds);
+               }
+             }}}},
+          {"cycles",
+           {{{"CYCLES"},
+             [](const std::vector<double>& values, double,
+                UserCounters* counters) {
+               (*counters)["cycles_per_iteration"] = Counter(values[0]);
+             }}}},
+      };
+  return *variants;
+}
+
+}  // namespace
+
+const std::vector<std::string>& PerfMetrics::Names() {
+  static const auto* const names = new std::vector<std::string>{
+      "ipc", "tma", "cache_mpki", "branch_mpki", "frequency", "cycles"};
+  return *names;
+}
+
+PerfMetrics PerfMetrics::Create(
+    const std::vector<std::string>& names,
+    const std::vector<std::string>& counter_names,
+    const std::function<bool(const std::string&)>& is_supported) {
+  std::vector<std::string> selected;
+  for (const std::string& name : names) {
+    if (name == "all") {
+      selected.insert(selected.end(), Names().begin(), Names().end());
+    } else if (GetVariants().count(name) != 0) {
+      selected.push_back(name);
+    } else {
+      GetErrorLogInstance() << "Unknown performance metric: " << name << "\n";
+    }
+  }
+
+  PerfMetrics metrics;
+  for (const std::string& name : selected) {
+    const std::vector<Variant>& variants = GetVariants().at(name);
+    auto variant = std::find_if(
+        variants.begin(), variants.end(), [&](const Variant& candidate) {
+          return std::all_of(candidate.events.begin(), candidate.events.end(),
+                             is_supported);
+        });
+    if (variant == variants.end()) {
+      GetErrorLogInstance() << "***WARNING*** The performance metric " << name
+                            << " is not supported on this CPU. Ignoring\n";
+      continue;
+    }
+    if (std::find(metrics.metrics_.begin(), metrics.metrics_.end(),
+                  &*variant) != metrics.metrics_.end()) {
+      continue;
+    }
+    metrics.metrics_.push_back(&*variant);
+    for (const std::string& event : variant->events) {
+      if (std::find(counter_names.begin(), counter_names.end(), event) ==
+              counter_names.end() &&
+          std::find(metrics.events_.begin(), metrics.events_.end(), event) ==
+              metrics.events_.end()) {
+        metrics.events_.push_back(event);
+      }
+    }
+  }
+  return metrics;
+}
+
+void PerfMetrics::Compute(UserCounters* counters,
+                          double cpu_seconds_per_iteration) const {
+  std::vector<double> values;
+  for (const Variant* metric : metrics_) {
+    values.clear();
+    for (const std::string& event : metric->events) {
+      auto it = counters->find(event);
+      if (it == counters->end()) {
+        break;
+      }
+      values.push_back(it->second.value);
+    }
+    // Not all events are counted together when they are rotated.
+    if (values.size() == metric->events.size()) {
+      metric->compute(values, cpu_seconds_per_iteration, counters);
+    }
+  }
+  for (const std::string& event : events_) {
+    counters->erase(event);
+  }
+}
+
+}  // namespace internal
+}  // namespace benchmark
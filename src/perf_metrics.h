@@ -0,0 +1,89 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_PERF_METRICS_H_
+#define BENCHMARK_PERF_METRICS_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "benchmark/counter.h"
+#include "benchmark/export.h"
+
+namespace benchmark {
+namespace internal {
+
+// Metrics derived from perf counters, such as the instructions per cycle or
+// the top-down breakdown of the pipeline slots. Each metric knows the events
+// to count for it on the CPUs it supports, and the first set of events that is
+// supported on this CPU is used.
+class BENCHMARK_EXPORT PerfMetrics {
+ public:
+  // The metrics that can be requested, "all" selecting all of them:
+  // - "ipc": IPC, the instructions retired per cycle.
+  // - "tma": frontend_bound, bad_speculation, retiring and backend_bound, the
+  //   fractions of the pipeline slots in each top-down category.
+  // - "cache_mpki": cache_MPKI, the last level cache misses per thousand
+  //   instructions.
+  // - "branch_mpki": branch_MPKI, the mispredicted branches per thousand
+  //   instructions.
+  // - "frequency": cpu_frequency, the effective clock of the CPU while running
+  //   the benchmark, i.e. the cycles per second of CPU time, which turbo and
+  //   thermal throttling move away from the nominal clock.
+  // - "cycles": cycles_per_iteration, the cycles of each iteration, which do
+  //   not depend on the clock.
+  static const std::vector<std::string>& Names();
+
+  // Returns the metrics in `names` that are supported by this CPU, warning
+  // about the others. `counter_names` are the counters requested by the user,
+  // which are still reported as they are. `is_supported` tells whether the
+  // perf counter of the given name can be counted.
+  static PerfMetrics Create(
+      const std::vector<std::string>& names,
+      const std::vector<std::string>& counter_names,
+      const std::function<bool(const std::string&)>& is_supported);
+
+  // The events to count for the metrics, other than the requested counters.
+  const std::vector<std::string>& events() const { return events_; }
+
+  bool empty() const { return metrics_.empty(); }
+
+  // Adds the metrics whose events were all counted to `counters`, and removes
+  // the events that were only counted for the metrics. The counters are per
+  // iteration, which took `cpu_seconds_per_iteration` of CPU time; metrics
+  // that need it are skipped if it is not positive.
+  void Compute(UserCounters* counters,
+               double cpu_seconds_per_iteration = 0) const;
+
+  // The part of a metric that depends on the CPU.
+  struct Variant {
+    // The libpfm names of the events.
+    std::vector<std::string> events;
+    // Adds the metric to `counters`, from the values of `events`, in order,
+    // and the CPU seconds they were counted over.
+    std::function<void(const std::vector<double>& values, double cpu_seconds,
+                       UserCounters* counters)>
+        compute;
+  };
+
+ private:
+  std::vector<const Variant*> metrics_;
+  std::vector<std::string> events_;
+};
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_PERF_METRICS_H_
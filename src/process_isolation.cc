@@ -0,0 +1,336 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "process_isolation.h"
+
+#include "internal_macros.h"
+
+#if defined(BENCHMARK_OS_LINUX) || defined(BENCHMARK_OS_MACOSX) ||     \
+    defined(BENCHMARK_OS_FREEBSD) || defined(BENCHMARK_OS_NETBSD) ||   \
+    defined(BENCHMARK_OS_OPENBSD) || defined(BENCHMARK_OS_DRAGONFLY) || \
+    defined(BENCHMARK_OS_SOLARIS)
+#define BENCHMARK_HAS_FORK
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "log.h"
+#include "string_util.h"
+
+namespace benchmark {
+namespace internal {
+
+namespace {
+
+// The encoding is only ever read back by a process forked from the writer, or
+// by the same binary resuming from a checkpoint, so plain native-endian copies
+// of the values are fine.
+template <typename T>
+void Put(T value, std::string* out) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  out->append(bytes, sizeof(T));
+}
+
+void PutString(const std::string& value, std::string* out) {
+  Put<uint32_t>(static_cast<uint32_t>(value.size()), out);
+  out->append(value);
+}
+
+class Reader {
+ public:
+  Reader(const char* pos, const char* end) : pos_(pos), end_(end) {}
+
+  template <typename T>
+  bool Get(T* value) {
+    if (static_cast<size_t>(end_ - pos_) < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(value, pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return true;
+  }
+
+  // Reads a value that was written as `Stored`.
+  template <typename Stored, typename T>
+  bool GetAs(T* value) {
+    Stored stored;
+    if (!Get(&stored)) {
+      return false;
+    }
+    *value = static_cast<T>(stored);
+    return true;
+  }
+
+  bool GetString(std::string* value) {
+    uint32_t size = 0;
+    if (!Get(&size) || static_cast<size_t>(end_ - pos_) < size) {
+      return false;
+    }
+    value->assign(pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+  const char* pos() const { return pos_; }
+
+ private:
+  const char* pos_;
+  const char* end_;
+};
+
+}  // namespace
+
+void EncodeRun(const BenchmarkReporter::Run& run, std::string* out) {
+  std::string payload;
+  Put<int64_t>(run.family_index, &payload);
+  Put<int64_t>(run.per_family_instance_index, &payload);
+  Put<int32_t>(static_cast<int32_t>(run.run_type), &payload);
+  PutString(run.aggregate_name, &payload);
+  Put<int32_t>(static_cast<int32_t>(run.aggregate_unit), &payload);
+  PutString(run.report_label, &payload);
+  Put<int32_t>(static_cast<int32_t>(run.skipped), &payload);
+  PutString(run.skip_message, &payload);
+  Put<int64_t>(run.iterations, &payload);
+  Put<int64_t>(run.threads, &payload);
+  Put<int64_t>(run.repetition_index, &payload);
+  Put<int64_t>(run.repetitions, &payload);
+  Put<int32_t>(static_cast<int32_t>(run.time_unit), &payload);
+  Put<double>(run.real_accumulated_time, &payload);
+  Put<double>(run.cpu_accumulated_time, &payload);
+  Put<double>(run.max_heapbytes_used, &payload);
+  Put<uint8_t>(run.use_real_time_for_initial_big_o ? 1 : 0, &payload);
+  Put<int32_t>(static_cast<int32_t>(run.complexity), &payload);
+  Put<int64_t>(run.complexity_n, &payload);
+  Put<uint8_t>(run.report_big_o ? 1 : 0, &payload);
+  Put<uint8_t>(run.report_rms ? 1 : 0, &payload);
+  Put<uint32_t>(static_cast<uint32_t>(run.counters.size()), &payload);
+  for (const auto& counter : run.counters) {
+    PutString(counter.first, &payload);
+    Put<double>(counter.second.value, &payload);
+    Put<int32_t>(static_cast<int32_t>(counter.second.flags), &payload);
+    Put<int32_t>(static_cast<int32_t>(counter.second.oneK), &payload);
+  }
+  Put<int64_t>(run.memory_result.num_allocs, &payload);
+  Put<int64_t>(run.memory_result.max_bytes_used, &payload);
+  Put<int64_t>(run.memory_result.total_allocated_bytes, &payload);
+  Put<int64_t>(run.memory_result.net_heap_growth, &payload);
+  Put<int64_t>(run.memory_result.memory_iterations, &payload);
+  Put<double>(run.allocs_per_iter, &payload);
+
+  Put<uint32_t>(static_cast<uint32_t>(payload.size()), out);
+  out->append(payload);
+}
+
+bool DecodeRun(const char** pos, const char* end, BenchmarkReporter::Run* run) {
+  Reader frame(*pos, end);
+  uint32_t size = 0;
+  if (!frame.Get(&size) || static_cast<size_t>(end - frame.pos()) < size) {
+    return false;
+  }
+  const char* payload_end = frame.pos() + size;
+  Reader r(frame.pos(), payload_end);
+
+  uint8_t use_real_time_for_initial_big_o = 0;
+  uint8_t report_big_o = 0;
+  uint8_t report_rms = 0;
+  uint32_t num_counters = 0;
+  bool ok = r.Get(&run->family_index) &&
+            r.Get(&run->per_family_instance_index) &&
+            r.GetAs<int32_t>(&run->run_type) &&
+            r.GetString(&run->aggregate_name) &&
+            r.GetAs<int32_t>(&run->aggregate_unit) &&
+            r.GetString(&run->report_label) &&
+            r.GetAs<int32_t>(&run->skipped) &&
+            r.GetString(&run->skip_message) &&
+            r.GetAs<int64_t>(&run->iterations) && r.Get(&run->threads) &&
+            r.Get(&run->repetition_index) && r.Get(&run->repetitions) &&
+            r.GetAs<int32_t>(&run->time_unit) &&
+            r.Get(&run->real_accumulated_time) &&
+            r.Get(&run->cpu_accumulated_time) &&
+            r.Get(&run->max_heapbytes_used) &&
+            r.Get(&use_real_time_for_initial_big_o) &&
+            r.GetAs<int32_t>(&run->complexity) &&
+            r.GetAs<int64_t>(&run->complexity_n) && r.Get(&report_big_o) &&
+            r.Get(&report_rms) && r.Get(&num_counters);
+  run->counters.clear();
+  for (uint32_t i = 0; ok && i < num_counters; ++i) {
+    std::string name;
+    Counter counter;
+    ok = r.GetString(&name) && r.Get(&counter.value) &&
+         r.GetAs<int32_t>(&counter.flags) && r.GetAs<int32_t>(&counter.oneK);
+    run->counters[name] = counter;
+  }
+  ok = ok && r.Get(&run->memory_result.num_allocs) &&
+       r.Get(&run->memory_result.max_bytes_used) &&
+       r.Get(&run->memory_result.total_allocated_bytes) &&
+       r.Get(&run->memory_result.net_heap_growth) &&
+       r.GetAs<int64_t>(&run->memory_result.memory_iterations) &&
+       r.Get(&run->allocs_per_iter) && r.pos() == payload_end;
+  if (!ok) {
+    return false;
+  }
+  run->use_real_time_for_initial_big_o = use_real_time_for_initial_big_o != 0;
+  run->report_big_o = report_big_o != 0;
+  run->report_rms = report_rms != 0;
+  *pos = payload_end;
+  return true;
+}
+
+bool ProcessIsolationSupported() {
+#ifdef BENCHMARK_HAS_FORK
+  return true;
+#else
+  return false;
+#endif
+}
+
+#ifdef BENCHMARK_HAS_FORK
+namespace {
+
+bool WriteAll(int fd, const std::string& data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    const ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    written += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+std::string ReadAll(int fd) {
+  std::string data;
+  char buffer[4096];
+  for (;;) {
+    const ssize_t n = read(fd, buffer, sizeof(buffer));
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return data;
+    }
+    data.append(buffer, static_cast<size_t>(n));
+  }
+}
+
+void FlushAllStreams() {
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+}
+
+BENCHMARK_NORETURN void RunChild(
+    BenchmarkRunner& runner, PerfCountersMeasurement* perf_counters_measurement,
+    int write_fd) {
+  if (perf_counters_measurement != nullptr &&
+      perf_counters_measurement->num_counters() > 0) {
+    perf_counters_measurement->Reopen();
+  }
+
+  // Each run is sent as soon as it is done, so that the parent still gets the
+  // repetitions before one that takes the process down.
+  bool ok = true;
+  size_t num_sent = 0;
+  while (ok && runner.HasRepeatsRemaining()) {
+    runner.DoOneRepetition();
+    const std::vector<BenchmarkReporter::Run>& runs =
+        runner.GetResults().non_aggregates;
+    std::string data;
+    for (; num_sent < runs.size(); ++num_sent) {
+      EncodeRun(runs[num_sent], &data);
+    }
+    ok = WriteAll(write_fd, data);
+  }
+  close(write_fd);
+  FlushAllStreams();
+  // Do not run the atexit handlers and static destructors of the parent.
+  _exit(ok ? 0 : 1);
+}
+
+}  // namespace
+#endif  // BENCHMARK_HAS_FORK
+
+void RunInChildProcess(BenchmarkRunner& runner,
+                       PerfCountersMeasurement* perf_counters_measurement) {
+#ifdef BENCHMARK_HAS_FORK
+  int pipe_fds[2];
+  if (pipe(pipe_fds) == 0) {
+    // Anything still buffered would otherwise be written by both processes.
+    FlushAllStreams();
+    const pid_t pid = fork();
+    if (pid == 0) {
+      close(pipe_fds[0]);
+      RunChild(runner, perf_counters_measurement, pipe_fds[1]);
+    }
+    close(pipe_fds[1]);
+    if (pid > 0) {
+      const std::string data = ReadAll(pipe_fds[0]);
+      close(pipe_fds[0]);
+      int status = 0;
+      while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+      }
+
+      // Keep the runs that made it through in full, even if the process died
+      // before sending the rest.
+      std::vector<BenchmarkReporter::Run> runs;
+      const char* pos = data.data();
+      const char* end = data.data() + data.size();
+      BenchmarkReporter::Run run;
+      while (pos != end && DecodeRun(&pos, end, &run)) {
+        runs.push_back(run);
+      }
+
+      std::string failure;
+      if (WIFSIGNALED(status)) {
+        failure = StrCat("benchmark process was killed by signal ",
+                         WTERMSIG(status));
+      } else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        failure = StrCat("benchmark process exited with status ",
+                         WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+      } else if (pos != end) {
+        failure = "benchmark process sent malformed results";
+      } else {
+        failure = "benchmark process did not report all repetitions";
+      }
+      runner.AdoptRuns(std::move(runs), failure);
+      return;
+    }
+    close(pipe_fds[0]);
+  }
+  BM_VLOG(0) << "Failed to start a process for "
+             << runner.GetBenchmarkInstance().name().str()
+             << ", running it in this one\n";
+#else
+  (void)perf_counters_measurement;
+#endif  // BENCHMARK_HAS_FORK
+  while (runner.HasRepeatsRemaining()) {
+    runner.DoOneRepetition();
+  }
+}
+
+}  // namespace internal
+}  // namespace benchmark
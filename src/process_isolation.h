@@ -0,0 +1,55 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_PROCESS_ISOLATION_H_
+#define BENCHMARK_PROCESS_ISOLATION_H_
+
+#include <string>
+
+#include "benchmark/export.h"
+#include "benchmark/reporter.h"
+#include "benchmark_runner.h"
+#include "perf_counters.h"
+
+namespace benchmark {
+namespace internal {
+
+// Appends a length-prefixed binary encoding of `run` to `out`. The fields that
+// refer to the benchmark registration (the name, statistics and complexity
+// lambda) are left out; the receiving side fills them in from its own
+// BenchmarkInstance. Checkpoint files use this encoding too, so changes to it
+// need a new checkpoint version.
+BENCHMARK_EXPORT
+void EncodeRun(const BenchmarkReporter::Run& run, std::string* out);
+
+// Decodes one run written by EncodeRun from [*pos, end) and advances *pos past
+// it. Returns false if the input is truncated or malformed.
+BENCHMARK_EXPORT
+bool DecodeRun(const char** pos, const char* end, BenchmarkReporter::Run* run);
+
+// Whether benchmarks can be run in a child process on this platform.
+bool ProcessIsolationSupported();
+
+// Runs all remaining repetitions of `runner` in a forked child process, which
+// streams the resulting runs back to this one over a pipe. Afterwards the
+// runner is in the same state as if it had run them itself, so its results
+// can be reported as usual. Repetitions that a crashing child could not
+// report are turned into errors.
+void RunInChildProcess(BenchmarkRunner& runner,
+                       PerfCountersMeasurement* perf_counters_measurement);
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_PROCESS_ISOLATION_H_
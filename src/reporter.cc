@@ -86,6 +86,28 @@ void BenchmarkReporter::PrintBasicContext(std::ostream* out,
     }
   }
 
+  if (!context.timer_overhead.empty()) {
+    Out << "Timer overhead per iteration / per PauseTiming+ResumeTiming"
+        << (context.timer_overhead_subtracted ? " (subtracted)" : "")
+        << ":\n";
+    for (const auto& kv : context.timer_overhead) {
+      const BenchmarkReporter::TimerOverhead& overhead = kv.second;
+      Out << StrFormat("  %s: real %.3g / %.3g ns, CPU %.3g / %.3g ns\n",
+                       kv.first.c_str(), overhead.real_time_per_iteration * 1e9,
+                       overhead.real_time_per_pause * 1e9,
+                       overhead.cpu_time_per_iteration * 1e9,
+                       overhead.cpu_time_per_pause * 1e9);
+    }
+  }
+
+  if (!context.machine_profile.empty()) {
+    Out << "Machine profile:\n";
+    for (const auto& kv : context.machine_profile) {
+      Out << "  " << kv.first << ": "
+          << HumanReadableNumber(kv.second, Counter::kIs1000) << "\n";
+    }
+  }
+
   if (CPUInfo::Scaling::ENABLED == info.scaling) {
     Out << "***WARNING*** CPU scaling is enabled, the benchmark "
            "real time measurements may be noisy and will incur extra "
@@ -110,6 +132,21 @@ const char* BenchmarkReporter::Context::executable_name;
 BenchmarkReporter::Context::Context()
     : cpu_info(CPUInfo::Get()), sys_info(SystemInfo::Get()) {}
 
+std::string BenchmarkReporter::Run::roofline_bound() const {
+  if (run_type == RT_Aggregate && aggregate_name != "mean" &&
+      aggregate_name != "median") {
+    return "";
+  }
+  auto memory = counters.find("memory_roof_pct");
+  auto compute = counters.find("compute_roof_pct");
+  if (memory == counters.end() || compute == counters.end()) {
+    return "";
+  }
+  // The ratio of the two is the ridge point of the roofline over the
+  // arithmetic intensity, so the larger one is the roof the run is under.
+  return memory->second.value >= compute->second.value ? "memory" : "compute";
+}
+
 std::string BenchmarkReporter::Run::benchmark_name() const {
   std::string name = run_name.str();
   if (run_type == RT_Aggregate) {
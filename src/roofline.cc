@@ -0,0 +1,84 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "roofline.h"
+
+#include <algorithm>
+
+#include "benchmark/sysinfo.h"
+
+namespace benchmark {
+namespace internal {
+
+namespace {
+
+double Find(const std::map<std::string, double>& profile,
+            const std::string& name) {
+  auto it = profile.find(name);
+  return it == profile.end() ? 0.0 : it->second;
+}
+
+}  // namespace
+
+Roofline Roofline::Create(double peak_bandwidth, double peak_flops,
+                          const std::map<std::string, double>& profile) {
+  Roofline roofline;
+  if (peak_bandwidth > 0) {
+    roofline.peak_bandwidth_ = peak_bandwidth;
+  } else {
+    roofline.peak_bandwidth_ = Find(profile, "triad_bandwidth");
+    roofline.peak_bandwidth_all_cpus_ =
+        Find(profile, "triad_bandwidth_all_cpus");
+  }
+  if (peak_flops > 0) {
+    roofline.peak_flops_ = peak_flops;
+  } else {
+    roofline.peak_flops_ = Find(profile, "simd_flops");
+    roofline.peak_flops_per_thread_ = true;
+  }
+  return roofline;
+}
+
+void Roofline::Compute(int threads, UserCounters* counters) const {
+  auto bytes = counters->find("bytes_per_second");
+  auto flops = counters->find("flops_per_second");
+  const bool has_bytes = bytes != counters->end() && bytes->second.value > 0;
+  const bool has_flops = flops != counters->end() && flops->second.value > 0;
+
+  // A thread per CPU saturates the memory, fewer threads may not.
+  double bandwidth = peak_bandwidth_;
+  if (threads > 1 && peak_bandwidth_all_cpus_ > 0) {
+    bandwidth = peak_bandwidth_all_cpus_;
+  }
+  double compute = peak_flops_;
+  if (peak_flops_per_thread_) {
+    compute *= std::min(threads, std::max(CPUInfo::Get().num_cpus, 1));
+  }
+
+  if (has_bytes && has_flops) {
+    (*counters)["arithmetic_intensity"] =
+        Counter(flops->second.value / bytes->second.value);
+  }
+  if (has_bytes && bandwidth > 0) {
+    (*counters)["memory_roof_pct"] =
+        Counter(100 * bytes->second.value / bandwidth);
+  }
+  if (has_flops && compute > 0) {
+    (*counters)["compute_roof_pct"] =
+        Counter(100 * flops->second.value / compute);
+  }
+}
+
+}  // namespace internal
+}  // namespace benchmark
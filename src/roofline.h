@@ -0,0 +1,58 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_ROOFLINE_H_
+#define BENCHMARK_ROOFLINE_H_
+
+#include <map>
+#include <string>
+
+#include "benchmark/counter.h"
+#include "benchmark/export.h"
+
+namespace benchmark {
+namespace internal {
+
+// The roofline model of the machine: a kernel doing I floating point
+// operations per byte of memory traffic attains at most
+// min(peak_flops, I * peak_bandwidth) operations per second.
+class BENCHMARK_EXPORT Roofline {
+ public:
+  // Uses `peak_bandwidth` bytes and `peak_flops` floating point operations per
+  // second where they are positive, and the ceilings measured for one thread
+  // and for all CPUs in the machine `profile` otherwise.
+  static Roofline Create(double peak_bandwidth, double peak_flops,
+                         const std::map<std::string, double>& profile);
+
+  bool empty() const { return peak_bandwidth_ <= 0 && peak_flops_ <= 0; }
+
+  // Adds the arithmetic intensity and the percentages of the memory and the
+  // compute roofs that the "bytes_per_second" and "flops_per_second" of a run
+  // with `threads` threads attain to `counters`, as far as they are known.
+  void Compute(int threads, UserCounters* counters) const;
+
+ private:
+  double peak_bandwidth_ = 0;
+  // The ceilings of a thread per CPU, 0 if unknown.
+  double peak_bandwidth_all_cpus_ = 0;
+  double peak_flops_ = 0;
+  // Whether peak_flops_ is the one of a single thread, and so scales with the
+  // number of threads.
+  bool peak_flops_per_thread_ = false;
+};
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_ROOFLINE_H_
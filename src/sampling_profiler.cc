@@ -0,0 +1,391 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sampling_profiler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "internal_macros.h"
+#include "log.h"
+#include "mutex.h"
+#include "string_util.h"
+
+#if defined(BENCHMARK_OS_LINUX)
+#include <cxxabi.h>
+#include <elf.h>
+#include <link.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace benchmark {
+namespace internal {
+
+#if defined(BENCHMARK_OS_LINUX)
+
+namespace {
+
+// 2 MiB, a few seconds worth of samples at the usual frequencies.
+constexpr size_t kDataPages = 512;
+
+// The functions of a loaded object, by the address they are loaded at.
+struct Module {
+  std::string path;
+  uintptr_t start = 0;
+  uintptr_t end = 0;
+  uintptr_t bias = 0;
+  bool loaded = false;
+  // Sorted by address.
+  std::vector<std::pair<uintptr_t, uintptr_t>> ranges;
+  std::vector<std::string> names;
+};
+
+template <typename T>
+bool ReadAt(std::ifstream& file, uint64_t offset, T* value, size_t count = 1) {
+  file.seekg(static_cast<std::streamoff>(offset));
+  file.read(reinterpret_cast<char*>(value),
+            static_cast<std::streamsize>(sizeof(T) * count));
+  return file.good();
+}
+
+std::string Demangle(const char* name) {
+  int status = 0;
+  std::unique_ptr<char, void (*)(void*)> demangled(
+      abi::__cxa_demangle(name, nullptr, nullptr, &status), std::free);
+  return status == 0 && demangled ? demangled.get() : name;
+}
+
+// Reads the function symbols of the ELF file of `module`, from its symbol
+// table if it was not stripped, and from its dynamic symbols otherwise.
+void LoadSymbols(Module* module) {
+  module->loaded = true;
+  std::ifstream file(module->path, std::ios::in | std::ios::binary);
+  ElfW(Ehdr) header;
+  if (!ReadAt(file, 0, &header) ||
+      std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 ||
+      header.e_shentsize != sizeof(ElfW(Shdr)) || header.e_shnum == 0) {
+    return;
+  }
+  std::vector<ElfW(Shdr)> sections(header.e_shnum);
+  if (!ReadAt(file, header.e_shoff, sections.data(), sections.size())) {
+    return;
+  }
+  std::vector<std::pair<uintptr_t, uintptr_t>> ranges;
+  std::vector<std::string> names;
+  for (const uint32_t type : {SHT_SYMTAB, SHT_DYNSYM}) {
+    for (const ElfW(Shdr) & section : sections) {
+      if (section.sh_type != type || section.sh_link >= sections.size() ||
+          section.sh_entsize != sizeof(ElfW(Sym))) {
+        continue;
+      }
+      const ElfW(Shdr)& strings_section = sections[section.sh_link];
+      std::vector<char> strings(strings_section.sh_size + 1, '\0');
+      std::vector<ElfW(Sym)> symbols(section.sh_size / sizeof(ElfW(Sym)));
+      if (!ReadAt(file, strings_section.sh_offset, strings.data(),
+                  strings_section.sh_size) ||
+          !ReadAt(file, section.sh_offset, symbols.data(), symbols.size())) {
+        continue;
+      }
+      for (const ElfW(Sym) & symbol : symbols) {
+        if (ELF64_ST_TYPE(symbol.st_info) != STT_FUNC ||
+            symbol.st_shndx == SHN_UNDEF || symbol.st_value == 0 ||
+            symbol.st_name >= strings_section.sh_size) {
+          continue;
+        }
+        ranges.emplace_back(module->bias + symbol.st_value,
+                            module->bias + symbol.st_value +
+                                std::max<uintptr_t>(symbol.st_size, 1));
+        names.push_back(Demangle(&strings[symbol.st_name]));
+      }
+    }
+    if (!ranges.empty()) {
+      break;
+    }
+  }
+  std::vector<size_t> order(ranges.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return ranges[a] < ranges[b];
+  });
+  for (size_t i : order) {
+    module->ranges.push_back(ranges[i]);
+    module->names.push_back(std::move(names[i]));
+  }
+}
+
+int AddModule(dl_phdr_info* info, size_t, void* data) {
+  Module module;
+  module.path = info->dlpi_name != nullptr && info->dlpi_name[0] != '\0'
+                    ? info->dlpi_name
+                    : "/proc/self/exe";
+  module.bias = info->dlpi_addr;
+  module.start = UINTPTR_MAX;
+  for (int i = 0; i < info->dlpi_phnum; ++i) {
+    const ElfW(Phdr)& segment = info->dlpi_phdr[i];
+    if (segment.p_type == PT_LOAD) {
+      module.start = std::min<uintptr_t>(module.start,
+                                         info->dlpi_addr + segment.p_vaddr);
+      module.end = std::max<uintptr_t>(
+          module.end, info->dlpi_addr + segment.p_vaddr + segment.p_memsz);
+    }
+  }
+  if (module.start < module.end) {
+    static_cast<std::vector<Module>*>(data)->push_back(std::move(module));
+  }
+  return 0;
+}
+
+class Symbolizer {
+ public:
+  std::string Symbolize(uintptr_t address) {
+    MutexLock l(mutex_);
+    Module* module = FindModule(address);
+    if (module == nullptr) {
+      // Maybe loaded since the modules were listed.
+      modules_.clear();
+      dl_iterate_phdr(AddModule, &modules_);
+      module = FindModule(address);
+      if (module == nullptr) {
+        return "[unknown]";
+      }
+    }
+    if (!module->loaded) {
+      LoadSymbols(module);
+    }
+    auto it = std::upper_bound(
+        module->ranges.begin(), module->ranges.end(),
+        std::make_pair(address, UINTPTR_MAX));
+    if (it != module->ranges.begin() && address < std::prev(it)->second) {
+      return module->names[static_cast<size_t>(
+          std::prev(it) - module->ranges.begin())];
+    }
+    const size_t slash = module->path.rfind('/');
+    return StrFormat("[%s+0x%llx]",
+                     module->path.substr(slash + 1).c_str(),
+                     static_cast<unsigned long long>(address - module->bias));
+  }
+
+ private:
+  Module* FindModule(uintptr_t address) REQUIRES(mutex_) {
+    for (Module& module : modules_) {
+      if (module.start <= address && address < module.end) {
+        return &module;
+      }
+    }
+    return nullptr;
+  }
+
+  Mutex mutex_;
+  std::vector<Module> modules_ GUARDED_BY(mutex_);
+};
+
+Symbolizer& GetSymbolizer() {
+  static Symbolizer* const symbolizer = new Symbolizer();
+  return *symbolizer;
+}
+
+}  // namespace
+
+const bool SamplingProfiler::kSupported = true;
+
+SamplingProfiler::SamplingProfiler(int frequency) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  // The CPU clock rather than a hardware event, so that it also works where
+  // there is no PMU, e.g. in virtual machines.
+  attr.type = PERF_TYPE_SOFTWARE;
+  attr.config = PERF_COUNT_SW_CPU_CLOCK;
+  attr.freq = 1;
+  attr.sample_freq = static_cast<uint64_t>(frequency);
+  attr.sample_type = PERF_SAMPLE_CALLCHAIN;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.exclude_callchain_kernel = 1;
+  const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+  if (fd < 0) {
+    static std::once_flag warned;
+    const int err = errno;
+    std::call_once(warned, [err] {
+      GetErrorLogInstance()
+          << "***WARNING*** Failed to start the sampling profiler: "
+          << ::strerror(err)
+          << ". Check /proc/sys/kernel/perf_event_paranoid.\n";
+    });
+    return;
+  }
+  fd_ = static_cast<int>(fd);
+  const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  buffer_size_ = (1 + kDataPages) * page_size;
+  buffer_ = mmap(nullptr, buffer_size_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                 fd_, 0);
+  if (buffer_ == MAP_FAILED) {
+    GetErrorLogInstance()
+        << "***WARNING*** Failed to map the sampling profiler's buffer: "
+        << ::strerror(errno) << "\n";
+    buffer_ = nullptr;
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  if (buffer_ != nullptr) {
+    munmap(buffer_, buffer_size_);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void SamplingProfiler::AfterSetupStart() {
+  if (fd_ >= 0) {
+    ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+void SamplingProfiler::BeforeTeardownStop() {
+  if (fd_ >= 0) {
+    ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    ReadSamples();
+  }
+}
+
+void SamplingProfiler::ReadSamples() {
+  auto* meta = static_cast<perf_event_mmap_page*>(buffer_);
+  const char* data = static_cast<const char*>(buffer_) + meta->data_offset;
+  const uint64_t data_size = meta->data_size;
+  const uint64_t head = __atomic_load_n(&meta->data_head, __ATOMIC_ACQUIRE);
+  uint64_t tail = meta->data_tail;
+
+  // Records may wrap around the end of the buffer, so each is copied out.
+  std::vector<uint64_t> record;
+  auto copy = [&](uint64_t offset, size_t size) {
+    record.assign((size + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+    char* out = reinterpret_cast<char*>(record.data());
+    for (size_t i = 0; i < size; ++i) {
+      out[i] = data[(offset + i) % data_size];
+    }
+  };
+  std::vector<uintptr_t> stack;
+  while (tail + sizeof(perf_event_header) <= head) {
+    perf_event_header header;
+    copy(tail, sizeof(header));
+    std::memcpy(&header, record.data(), sizeof(header));
+    if (header.size < sizeof(header) || tail + header.size > head) {
+      break;
+    }
+    copy(tail + sizeof(header), header.size - sizeof(header));
+    if (header.type == PERF_RECORD_SAMPLE && !record.empty()) {
+      // The number of entries, then the entries from the sampled instruction
+      // outwards, interleaved with markers of the context they are in.
+      const uint64_t nr = std::min<uint64_t>(record[0], record.size() - 1);
+      stack.clear();
+      for (uint64_t i = nr; i > 0; --i) {
+        const uint64_t address = record[i];
+        if (address < PERF_CONTEXT_MAX) {
+          stack.push_back(static_cast<uintptr_t>(address));
+        }
+      }
+      if (!stack.empty()) {
+        ++stacks_[stack];
+      }
+    } else if (header.type == PERF_RECORD_LOST && record.size() >= 2) {
+      num_lost_ += record[1];
+    }
+    tail += header.size;
+  }
+  __atomic_store_n(&meta->data_tail, head, __ATOMIC_RELEASE);
+}
+
+std::string SymbolizeAddress(uintptr_t address) {
+  return GetSymbolizer().Symbolize(address);
+}
+
+#else  // defined(BENCHMARK_OS_LINUX)
+
+const bool SamplingProfiler::kSupported = false;
+
+SamplingProfiler::SamplingProfiler(int) {
+  GetErrorLogInstance()
+      << "***WARNING*** The sampling profiler is not supported on this "
+         "platform.\n";
+}
+
+SamplingProfiler::~SamplingProfiler() {}
+
+void SamplingProfiler::AfterSetupStart() {}
+
+void SamplingProfiler::BeforeTeardownStop() {}
+
+void SamplingProfiler::ReadSamples() {}
+
+std::string SymbolizeAddress(uintptr_t) { return "[unknown]"; }
+
+#endif  // defined(BENCHMARK_OS_LINUX)
+
+bool SamplingProfiler::WriteFolded(const std::string& path,
+                                   std::string* error) const {
+  std::map<std::string, uint64_t> folded;
+  std::map<uintptr_t, std::string> names;
+  for (const auto& stack : stacks_) {
+    std::string line;
+    for (size_t i = 0; i < stack.first.size(); ++i) {
+      // All but the sampled instruction are return addresses, which may
+      // already be in the next function.
+      const uintptr_t address =
+          i + 1 == stack.first.size() ? stack.first[i] : stack.first[i] - 1;
+      auto it = names.find(address);
+      if (it == names.end()) {
+        std::string name = SymbolizeAddress(address);
+        std::replace(name.begin(), name.end(), ';', ':');
+        it = names.emplace(address, std::move(name)).first;
+      }
+      if (!line.empty()) {
+        line += ';';
+      }
+      line += it->second;
+    }
+    folded[line] += stack.second;
+  }
+
+  std::ofstream out(path, std::ios::out | std::ios::trunc);
+  if (!out.is_open()) {
+    *error = "cannot open file";
+    return false;
+  }
+  for (const auto& stack : folded) {
+    out << stack.first << ' ' << stack.second << '\n';
+  }
+  if (!out.good()) {
+    *error = "cannot write file";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,85 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_SAMPLING_PROFILER_H_
+#define BENCHMARK_SAMPLING_PROFILER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark/export.h"
+#include "benchmark/managers.h"
+
+namespace benchmark {
+namespace internal {
+
+// A profiler manager that samples the call stack of the calling thread while
+// the benchmark runs, from AfterSetupStart() to BeforeTeardownStop(). On
+// Linux, the samples are taken by the kernel, with perf_event_open and a
+// ring buffer; the call stacks are only complete for code built with frame
+// pointers.
+class BENCHMARK_EXPORT SamplingProfiler final : public ProfilerManager {
+ public:
+  // True iff this platform supports sampling.
+  static const bool kSupported;
+
+  // Prepares to take `frequency` samples per second of CPU time. Check ok()
+  // for whether this succeeded.
+  explicit SamplingProfiler(int frequency);
+  ~SamplingProfiler() override;
+
+  SamplingProfiler(const SamplingProfiler&) = delete;
+  SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+  void AfterSetupStart() override;
+  void BeforeTeardownStop() override;
+
+  bool ok() const { return fd_ >= 0; }
+
+  // The number of samples taken for each call stack, as return addresses
+  // from the outermost frame to the sampled instruction.
+  const std::map<std::vector<uintptr_t>, uint64_t>& stacks() const {
+    return stacks_;
+  }
+
+  // The number of samples dropped because the ring buffer was full.
+  uint64_t num_lost() const { return num_lost_; }
+
+  // Writes the symbolized call stacks in the folded format of flame graph
+  // tools: one line per call stack with the functions from the outermost one,
+  // separated by ';', and the number of samples.
+  bool WriteFolded(const std::string& path, std::string* error) const;
+
+ private:
+  void ReadSamples();
+
+  int fd_ = -1;
+  void* buffer_ = nullptr;
+  size_t buffer_size_ = 0;
+  std::map<std::vector<uintptr_t>, uint64_t> stacks_;
+  uint64_t num_lost_ = 0;
+};
+
+// Returns the demangled name of the function containing `address`, or the
+// module and offset if it has no symbol, or "[unknown]".
+BENCHMARK_EXPORT
+std::string SymbolizeAddress(uintptr_t address);
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_SAMPLING_PROFILER_H_
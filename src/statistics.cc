@@ -17,6 +17,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -107,6 +108,30 @@ double StatisticsCV(const std::vector<double>& v) {
   return stddev / mean;
 }
 
+double StatisticsMeanRelativeError(const std::vector<double>& v) {
+  // Two-sided 95% critical values of Student's t-distribution, indexed by the
+  // degrees of freedom minus one. Beyond the table the normal value is close
+  // enough.
+  static constexpr double kStudentT95[] = {
+      12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+      2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+      2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+  constexpr size_t kTableSize = sizeof(kStudentT95) / sizeof(kStudentT95[0]);
+
+  const auto mean = StatisticsMean(v);
+  if (v.size() < 2 || std::fpclassify(mean) == FP_ZERO) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  const size_t degrees_of_freedom = v.size() - 1;
+  const double t = degrees_of_freedom <= kTableSize
+                       ? kStudentT95[degrees_of_freedom - 1]
+                       : 1.960;
+  const double standard_error =
+      StatisticsStdDev(v) / std::sqrt(static_cast<double>(v.size()));
+  return t * standard_error / std::abs(mean);
+}
+
 std::vector<BenchmarkReporter::Run> ComputeStats(
     const std::vector<BenchmarkReporter::Run>& reports) {
   typedef BenchmarkReporter::Run Run;
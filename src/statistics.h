@@ -40,6 +40,12 @@ double StatisticsStdDev(const std::vector<double>& v);
 BENCHMARK_EXPORT
 double StatisticsCV(const std::vector<double>& v);
 
+// Returns the half-width of the 95% confidence interval of the mean of `v`,
+// relative to that mean, using Student's t-distribution. Returns infinity if
+// fewer than two samples are given or the mean is zero.
+BENCHMARK_EXPORT
+double StatisticsMeanRelativeError(const std::vector<double>& v);
+
 }  // end namespace benchmark
 
 #endif  // STATISTICS_H_
@@ -61,6 +61,11 @@
 #if defined(BENCHMARK_OS_LINUX)
 #include <sys/personality.h>
 #endif
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define BENCHMARK_HAS_CPUID
+#include <cpuid.h>
+#endif
 
 #include <algorithm>
 #include <array>
@@ -274,6 +279,28 @@ int CountSetBitsInCPUMap(std::string val) {
   return total;
 }
 
+// Parses a kernel CPU list such as "0-3,8,10-11".
+BENCHMARK_MAYBE_UNUSED
+std::vector<int> ParseCPUList(const std::string& list) {
+  std::vector<int> res;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    const size_t dash = range.find('-');
+    const int first = std::atoi(range.substr(0, dash).c_str());
+    const int last = dash == std::string::npos
+                         ? first
+                         : std::atoi(range.substr(dash + 1).c_str());
+    for (int cpu = first; cpu <= last; ++cpu) {
+      res.push_back(cpu);
+    }
+  }
+  return res;
+}
+
 BENCHMARK_MAYBE_UNUSED
 std::vector<CPUInfo::CacheInfo> GetCacheSizesFromKVFS() {
   std::vector<CPUInfo::CacheInfo> res;
@@ -454,6 +481,40 @@ std::vector<CPUInfo::CacheInfo> GetCacheSizes() {
 #endif
 }
 
+int64_t GetTLBReach() {
+#ifdef BENCHMARK_HAS_CPUID
+  constexpr int64_t kPageSize = 4096;
+  unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (__get_cpuid(0, &eax, &ebx, &ecx, &edx) == 0) {
+    return 0;
+  }
+  // Intel enumerates its TLBs in leaf 0x18, one per subleaf.
+  if (eax >= 0x18) {
+    __cpuid_count(0x18, 0, eax, ebx, ecx, edx);
+    const unsigned max_subleaf = eax;
+    int64_t reach = 0;
+    for (unsigned subleaf = 0; subleaf <= max_subleaf; ++subleaf) {
+      __cpuid_count(0x18, subleaf, eax, ebx, ecx, edx);
+      const unsigned type = edx & 0x1f;
+      const bool maps_data = type == 1 || type == 3 || type == 4;
+      const bool maps_4k_pages = (ebx & 1) != 0;
+      if (maps_data && maps_4k_pages) {
+        const int64_t entries = static_cast<int64_t>(ebx >> 16) * ecx;
+        reach = std::max(reach, entries * kPageSize);
+      }
+    }
+    if (reach > 0) {
+      return reach;
+    }
+  }
+  // AMD describes its L2 data TLB in leaf 0x80000006.
+  if (__get_cpuid(0x80000006, &eax, &ebx, &ecx, &edx) != 0) {
+    return static_cast<int64_t>((ebx >> 16) & 0xfff) * kPageSize;
+  }
+#endif
+  return 0;
+}
+
 std::string GetSystemName() {
 #if defined(BENCHMARK_OS_WINDOWS)
   std::string str;
@@ -887,6 +948,87 @@ std::vector<double> GetLoadAvg() {
 #endif
 }
 
+std::vector<CPUInfo::LogicalCPU> GetTopology() {
+  std::vector<CPUInfo::LogicalCPU> res;
+#if defined(BENCHMARK_OS_LINUX)
+  std::string online;
+  if (!ReadFromFile("/sys/devices/system/cpu/online", &online)) {
+    return res;
+  }
+  for (int cpu : ParseCPUList(online)) {
+    const std::string dir = StrCat("/sys/devices/system/cpu/cpu", cpu, "/");
+    CPUInfo::LogicalCPU info = {cpu, cpu, 0, -1, -1};
+    // Use the lowest numbered sibling as the id of a core or cache, as these
+    // are unique across packages, unlike topology/core_id.
+    std::string list;
+    if (ReadFromFile(StrCat(dir, "topology/thread_siblings_list"), &list) &&
+        !ParseCPUList(list).empty()) {
+      info.core = ParseCPUList(list).front();
+    }
+    ReadFromFile(StrCat(dir, "topology/physical_package_id"), &info.package);
+    for (int idx = 0;; ++idx) {
+      const std::string cache = StrCat(dir, "cache/index", idx, "/");
+      int level = 0;
+      if (!ReadFromFile(StrCat(cache, "level"), &level)) {
+        break;
+      }
+      if (level == 2 &&
+          ReadFromFile(StrCat(cache, "shared_cpu_list"), &list) &&
+          !ParseCPUList(list).empty()) {
+        info.l2_domain = ParseCPUList(list).front();
+        break;
+      }
+    }
+    res.push_back(info);
+  }
+
+  std::string nodes;
+  if (ReadFromFile("/sys/devices/system/node/online", &nodes)) {
+    for (int node : ParseCPUList(nodes)) {
+      std::string cpus;
+      if (!ReadFromFile(StrCat("/sys/devices/system/node/node", node,
+                               "/cpulist"),
+                        &cpus)) {
+        continue;
+      }
+      for (int cpu : ParseCPUList(cpus)) {
+        for (CPUInfo::LogicalCPU& info : res) {
+          if (info.cpu == cpu) {
+            info.numa_node = node;
+          }
+        }
+      }
+    }
+  }
+#endif
+  return res;
+}
+
+std::vector<std::vector<int>> GetNumaDistances() {
+  std::vector<std::vector<int>> res;
+#if defined(BENCHMARK_OS_LINUX)
+  std::string online;
+  if (!ReadFromFile("/sys/devices/system/node/online", &online)) {
+    return res;
+  }
+  const std::vector<int> nodes = ParseCPUList(online);
+  if (nodes.empty()) {
+    return res;
+  }
+  const size_t num_nodes = static_cast<size_t>(nodes.back()) + 1;
+  res.assign(num_nodes, std::vector<int>(num_nodes, -1));
+  for (int node : nodes) {
+    // One distance per online node, in the same order.
+    std::ifstream f(StrCat("/sys/devices/system/node/node", node, "/distance"));
+    int distance = 0;
+    for (size_t i = 0; i < nodes.size() && (f >> distance); ++i) {
+      res[static_cast<size_t>(node)][static_cast<size_t>(nodes[i])] = distance;
+    }
+  }
+#endif
+  return res;
+}
+
 }  // end namespace
 
 const CPUInfo& CPUInfo::Get() {
@@ -899,7 +1041,10 @@ CPUInfo::CPUInfo()
       scaling(CpuScaling(num_cpus)),
       cycles_per_second(GetCPUCyclesPerSecond(scaling)),
       caches(GetCacheSizes()),
-      load_avg(GetLoadAvg()) {}
+      tlb_reach(GetTLBReach()),
+      load_avg(GetLoadAvg()),
+      topology(GetTopology()),
+      numa_distances(GetNumaDistances()) {}
 
 const SystemInfo& SystemInfo::Get() {
   static const SystemInfo* info = new SystemInfo();
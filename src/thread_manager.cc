@@ -0,0 +1,58 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "thread_manager.h"
+
+#include <algorithm>
+
+#include "counter.h"
+
+namespace benchmark {
+namespace internal {
+
+ThreadManager::Result ThreadManager::GetResults() const {
+  Result results;
+  results.numa_distance = 0;
+  bool has_label = false;
+  for (const ThreadSlot& slot : thread_slots_) {
+    const Result& r = slot.result;
+    results.iterations += r.iterations;
+    results.cpu_time_used += r.cpu_time_used;
+    results.real_time_used += r.real_time_used;
+    results.manual_time_used += r.manual_time_used;
+    results.complexity_n += r.complexity_n;
+    Increment(&results.counters, r.counters);
+    results.latency_histogram.Merge(r.latency_histogram);
+    results.release_skew_cycles =
+        std::max(results.release_skew_cycles, r.release_skew_cycles);
+    results.numa_distance = results.numa_distance < 0 || r.numa_distance < 0
+                                ? -1
+                                : results.numa_distance + r.numa_distance;
+    results.perf_time_enabled += r.perf_time_enabled;
+    results.perf_time_running += r.perf_time_running;
+    // If several threads set a label, the one with the lowest index wins.
+    if (slot.has_label && !has_label) {
+      results.report_label_ = r.report_label_;
+      has_label = true;
+    }
+  }
+  if (skip_claimed_.load(std::memory_order_acquire)) {
+    results.skipped_ = skipped_;
+    results.skip_message_ = skip_message_;
+  }
+  return results;
+}
+
+}  // namespace internal
+}  // namespace benchmark
@@ -2,25 +2,41 @@
 #define BENCHMARK_THREAD_MANAGER_H
 
 #include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
 
 #include "benchmark/counter.h"
+#include "benchmark/export.h"
 #include "benchmark/statistics.h"
 #include "benchmark/types.h"
+#include "latency_histogram.h"
 #include "mutex.h"
 
 namespace benchmark {
 namespace internal {
 
-class ThreadManager {
- public:
-  explicit ThreadManager(int num_threads) : start_stop_barrier_(num_threads) {}
+// Large enough to keep data of different threads out of each other's cache
+// lines, including the pairs of lines fetched together by some prefetchers.
+constexpr size_t kCacheLineSize = 128;
 
-  Mutex& GetBenchmarkMutex() const RETURN_CAPABILITY(benchmark_mutex_) {
-    return benchmark_mutex_;
-  }
+class BENCHMARK_EXPORT ThreadManager {
+ public:
+  explicit ThreadManager(int num_threads)
+      : start_stop_barrier_(num_threads),
+        thread_slots_(static_cast<size_t>(num_threads)) {}
 
   bool StartStopBarrier() { return start_stop_barrier_.wait(); }
 
+  // Like StartStopBarrier(), but also records in the thread's result how late
+  // the thread got going after the barrier was released.
+  bool StartBarrier(int thread_id) {
+    int64_t release_delay = 0;
+    const bool released = start_stop_barrier_.wait(&release_delay);
+    GetThreadResult(thread_id).release_skew_cycles = release_delay;
+    return released;
+  }
+
   void NotifyThreadComplete() { start_stop_barrier_.removeThread(); }
 
   struct Result {
@@ -33,12 +49,61 @@ class ThreadManager {
     std::string skip_message_;
     internal::Skipped skipped_ = internal::NotSkipped;
     UserCounters counters;
+    // Per-iteration latencies in cycle clock ticks, merged over all threads.
+    // Only populated when the benchmark records its latency distribution.
+    LatencyHistogram latency_histogram;
+    // How much later than the first thread the last thread started measuring,
+    // in cycle clock ticks.
+    int64_t release_skew_cycles = 0;
+    // The NUMA distance between where the thread ran and where its memory
+    // policy placed its data, summed over all threads. Negative if unknown
+    // for any of them.
+    double numa_distance = -1;
+    // How long the perf counters were enabled, and actually counting, summed
+    // over all counters and threads, in nanoseconds.
+    double perf_time_enabled = 0;
+    double perf_time_running = 0;
   };
-  GUARDED_BY(GetBenchmarkMutex()) Result results;
+
+  // The result of a single thread. Every thread only ever touches its own
+  // slot, so threads never have to synchronize to record their results.
+  Result& GetThreadResult(int thread_id) {
+    return thread_slots_[static_cast<size_t>(thread_id)].result;
+  }
+
+  void SetLabel(int thread_id, const std::string& label) {
+    ThreadSlot& slot = thread_slots_[static_cast<size_t>(thread_id)];
+    slot.result.report_label_ = label;
+    slot.has_label = true;
+  }
+
+  // Records why the benchmark was skipped. Only the first call, from whichever
+  // thread, has any effect.
+  void Skip(internal::Skipped skipped, const std::string& msg) {
+    if (skip_claimed_.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+    skipped_ = skipped;
+    skip_message_ = msg;
+  }
+
+  // Combines the results of all threads. May only be called once all threads
+  // have finished, which orders it after all of their writes.
+  Result GetResults() const;
 
  private:
-  mutable Mutex benchmark_mutex_;
+  struct alignas(kCacheLineSize) ThreadSlot {
+    Result result;
+    bool has_label = false;
+  };
+
   Barrier start_stop_barrier_;
+  std::vector<ThreadSlot> thread_slots_;
+
+  std::atomic<bool> skip_claimed_{false};
+  // Only written by the thread that claimed the skip.
+  internal::Skipped skipped_ = internal::NotSkipped;
+  std::string skip_message_;
 };
 
 }  // namespace internal
@@ -0,0 +1,182 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "thread_pool.h"
+
+#include "internal_macros.h"
+
+#ifndef BENCHMARK_OS_WINDOWS
+#include <unistd.h>
+#endif
+
+#include "check.h"
+#include "cpu_affinity.h"
+
+namespace benchmark {
+namespace internal {
+
+struct ThreadPool::Worker {
+  explicit Worker(int id) : thread_id(id) {}
+
+  const int thread_id;
+  std::thread thread;
+
+  Mutex mutex;
+  Condition cv;
+  const std::function<void(int)>* task GUARDED_BY(mutex) = nullptr;
+  // The CPU to run the task on, or -1 to run with the original affinity.
+  int cpu GUARDED_BY(mutex) = -1;
+  bool stop GUARDED_BY(mutex) = false;
+};
+
+ThreadPool& ThreadPool::Get() {
+  static Mutex mutex;
+  static ThreadPool* pool = nullptr;
+#ifndef BENCHMARK_OS_WINDOWS
+  static pid_t owner = 0;
+#endif
+  MutexLock l(mutex);
+#ifndef BENCHMARK_OS_WINDOWS
+  if (pool != nullptr && owner != getpid()) {
+    // We are in a forked child. The workers of `pool` were not carried over,
+    // and its mutexes may have been held at the time of the fork, so leave it
+    // alone.
+    pool = nullptr;
+  }
+  if (pool == nullptr) {
+    owner = getpid();
+  }
+#endif
+  if (pool == nullptr) {
+    // Intentionally leaked: parked workers must outlive static destructors.
+    pool = new ThreadPool;
+  }
+  return *pool;
+}
+
+ThreadPool::ThreadPool() = default;
+
+ThreadPool::~ThreadPool() {
+  MutexLock l(run_mutex_);
+  for (auto& worker : workers_) {
+    {
+      MutexLock wl(worker->mutex);
+      worker->stop = true;
+    }
+    worker->cv.notify_one();
+  }
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+size_t ThreadPool::NumWorkers() {
+  MutexLock l(run_mutex_);
+  return workers_.size();
+}
+
+void ThreadPool::Run(int num_threads, const std::function<void(int)>& fn,
+                     const std::vector<int>& cpus) {
+  BM_CHECK_GE(num_threads, 1);
+  auto cpu_for = [&cpus](int thread_id) {
+    return cpus.empty() ? -1
+                        : cpus[static_cast<size_t>(thread_id) % cpus.size()];
+  };
+
+  // A single thread does not need the pool, which also keeps independent
+  // single-threaded runs from serializing on `run_mutex_`.
+  if (num_threads == 1 && cpus.empty()) {
+    fn(0);
+    return;
+  }
+
+  MutexLock l(run_mutex_);
+  const size_t num_workers = static_cast<size_t>(num_threads - 1);
+  while (workers_.size() < num_workers) {
+    workers_.emplace_back(new Worker(static_cast<int>(workers_.size()) + 1));
+    Worker* worker = workers_.back().get();
+    worker->thread = std::thread(&ThreadPool::WorkerLoop, this, worker);
+  }
+
+  {
+    MutexLock dl(done_mutex_);
+    pending_ = num_threads - 1;
+  }
+  for (size_t i = 0; i < num_workers; ++i) {
+    Worker* worker = workers_[i].get();
+    {
+      MutexLock wl(worker->mutex);
+      worker->task = &fn;
+      worker->cpu = cpu_for(worker->thread_id);
+    }
+    worker->cv.notify_one();
+  }
+
+  // Run the first thread here, like a freshly spawned set of threads would
+  // have the caller do.
+  std::vector<int> caller_affinity;
+  if (!cpus.empty()) {
+    caller_affinity = GetAllowedCPUs();
+    PinCurrentThreadToCPU(cpu_for(0));
+  }
+  fn(0);
+  if (!caller_affinity.empty()) {
+    SetCurrentThreadAffinity(caller_affinity);
+  }
+
+  MutexLock dl(done_mutex_);
+  done_cv_.wait(dl.native_handle(), [this]() { return pending_ == 0; });
+}
+
+void ThreadPool::WorkerLoop(Worker* worker) {
+  // Workers inherit the affinity of the thread that created them, which is
+  // what unpinned tasks run with.
+  const std::vector<int> original_affinity = GetAllowedCPUs();
+  int current_cpu = -1;
+  for (;;) {
+    const std::function<void(int)>* task = nullptr;
+    int cpu = -1;
+    {
+      MutexLock l(worker->mutex);
+      worker->cv.wait(l.native_handle(), [worker]() {
+        return worker->task != nullptr || worker->stop;
+      });
+      if (worker->task == nullptr) {
+        return;
+      }
+      task = worker->task;
+      worker->task = nullptr;
+      cpu = worker->cpu;
+    }
+
+    if (cpu != current_cpu) {
+      if (cpu >= 0) {
+        PinCurrentThreadToCPU(cpu);
+      } else if (!original_affinity.empty()) {
+        SetCurrentThreadAffinity(original_affinity);
+      }
+      current_cpu = cpu;
+    }
+
+    (*task)(worker->thread_id);
+
+    MutexLock l(done_mutex_);
+    if (--pending_ == 0) {
+      done_cv_.notify_one();
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace benchmark
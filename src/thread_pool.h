@@ -0,0 +1,78 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_THREAD_POOL_H_
+#define BENCHMARK_THREAD_POOL_H_
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark/export.h"
+#include "mutex.h"
+
+namespace benchmark {
+namespace internal {
+
+// A process-wide pool of parked worker threads, used to run the threads of
+// multithreaded benchmarks. Creating and joining threads for every run costs
+// tens of microseconds per thread and lets the threads of consecutive runs
+// land on different CPUs with cold caches; reusing the same workers avoids
+// both.
+//
+// The pool grows on demand and never shrinks. Idle workers sleep, so they do
+// not compete with single-threaded benchmarks for CPU time.
+class BENCHMARK_EXPORT ThreadPool {
+ public:
+  // Returns the pool of the current process. After a fork() the child gets a
+  // fresh pool, as the workers of the parent do not exist there.
+  static ThreadPool& Get();
+
+  ThreadPool();
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Calls `fn(0)` on the calling thread and `fn(1)` ... `fn(num_threads - 1)`
+  // on workers of the pool, and returns once all of them have returned.
+  //
+  // If `cpus` is not empty, thread `i` is pinned to `cpus[i % cpus.size()]`
+  // for the duration of the call. Otherwise the workers run with the affinity
+  // the pool was created with.
+  void Run(int num_threads, const std::function<void(int)>& fn,
+           const std::vector<int>& cpus = {});
+
+  // Returns the number of workers created so far.
+  size_t NumWorkers();
+
+ private:
+  struct Worker;
+
+  void WorkerLoop(Worker* worker);
+
+  // Held for the duration of Run(), so that concurrent callers take turns.
+  Mutex run_mutex_;
+  std::vector<std::unique_ptr<Worker>> workers_ GUARDED_BY(run_mutex_);
+
+  Mutex done_mutex_;
+  Condition done_cv_;
+  int pending_ GUARDED_BY(done_mutex_) = 0;
+};
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_THREAD_POOL_H_
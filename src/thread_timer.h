@@ -1,7 +1,10 @@
 #ifndef BENCHMARK_THREAD_TIMER_H
 #define BENCHMARK_THREAD_TIMER_H
 
+#include "benchmark/types.h"
 #include "check.h"
+#include "cycleclock.h"
+#include "latency_histogram.h"
 #include "timers.h"
 
 namespace benchmark {
@@ -22,19 +25,80 @@ class ThreadTimer {
   // Called by each thread
   void StartTimer() {
     running_ = true;
-    start_real_time_ = ChronoClockNow();
-    start_cpu_time_ = ReadCpuTimerOfChoice();
+    if (use_cycle_clock_) {
+      start_cycles_ = ReadCycles();
+    } else {
+      start_real_time_ = ChronoClockNow();
+      start_cpu_time_ = ReadCpuTimerOfChoice();
+    }
+    if (latency_histogram_ != nullptr && pause_start_cycles_ != 0) {
+      paused_cycles_ += cycleclock::Now() - pause_start_cycles_;
+      pause_start_cycles_ = 0;
+    }
   }
 
   // Called by each thread
   void StopTimer() {
     BM_CHECK(running_);
     running_ = false;
-    real_time_used_ += ChronoClockNow() - start_real_time_;
-    // Floating point error can result in the subtraction producing a negative
-    // time. Guard against that.
-    cpu_time_used_ +=
-        std::max<double>(ReadCpuTimerOfChoice() - start_cpu_time_, 0);
+    ++intervals_;
+    if (use_cycle_clock_) {
+      const int64_t cycles =
+          ReadCycles() - start_cycles_ - cycle_clock_.overhead_cycles;
+      const double seconds =
+          static_cast<double>(std::max<int64_t>(cycles, 0)) *
+          cycle_clock_.seconds_per_cycle;
+      real_time_used_ += seconds;
+      cpu_time_used_ += seconds;
+    } else {
+      real_time_used_ += ChronoClockNow() - start_real_time_;
+      // Floating point error can result in the subtraction producing a
+      // negative time. Guard against that.
+      cpu_time_used_ +=
+          std::max<double>(ReadCpuTimerOfChoice() - start_cpu_time_, 0);
+    }
+    if (latency_histogram_ != nullptr) {
+      pause_start_cycles_ = cycleclock::Now();
+    }
+  }
+
+  // Makes the timer measure with the cycle clock instead of the chrono and CPU
+  // clocks, minus the cost of reading it. Both the real and the CPU time are
+  // then the time measured with it. Must be called before the timer is first
+  // started.
+  void UseCycleClock() { UseCycleClock(GetCycleClockCalibration(), nullptr); }
+
+  // Like UseCycleClock(), but with the given calibration, and reading the
+  // cycles from `read_cycles` unless it is null. For testing.
+  void UseCycleClock(const CycleClockCalibration& calibration,
+                     int64_t (*read_cycles)()) {
+    BM_CHECK(!running_);
+    use_cycle_clock_ = true;
+    cycle_clock_ = calibration;
+    read_cycles_ = read_cycles;
+  }
+
+  // Makes the timer record the duration of every iteration into `histogram`,
+  // in cycle clock ticks. Must be called before the timer is first started.
+  void RecordLatencyInto(LatencyHistogram* histogram) {
+    BM_CHECK(!running_);
+    latency_histogram_ = histogram;
+  }
+
+  LatencyHistogram* latency_histogram() const { return latency_histogram_; }
+
+  // Called by each thread at every iteration (or batch) boundary when latency
+  // recording is enabled. `iterations` is the number of iterations that ran
+  // since the previous mark; the first mark of a run passes 0. Time spent
+  // with the timer paused is not attributed to the iterations.
+  void MarkIterations(IterationCount iterations) {
+    const int64_t now = cycleclock::Now();
+    if (iterations > 0) {
+      const int64_t elapsed = now - last_mark_cycles_ - paused_cycles_;
+      latency_histogram_->Record(elapsed / iterations, iterations);
+    }
+    last_mark_cycles_ = now;
+    paused_cycles_ = 0;
   }
 
   // Called by each thread
@@ -42,6 +106,9 @@ class ThreadTimer {
 
   bool running() const { return running_; }
 
+  // The number of times the timer was stopped.
+  int64_t intervals() const { return intervals_; }
+
   // REQUIRES: timer is not running
   double real_time_used() const {
     BM_CHECK(!running_);
@@ -61,6 +128,13 @@ class ThreadTimer {
   }
 
  private:
+  int64_t ReadCycles() const {
+    if (BENCHMARK_BUILTIN_EXPECT(read_cycles_ != nullptr, false)) {
+      return read_cycles_();
+    }
+    return cycleclock::NowSerialized();
+  }
+
   double ReadCpuTimerOfChoice() const {
     if (measure_process_cpu_time) return ProcessCPUUsage();
     return ThreadCPUUsage();
@@ -72,12 +146,25 @@ class ThreadTimer {
   bool running_ = false;        // Is the timer running
   double start_real_time_ = 0;  // If running_
   double start_cpu_time_ = 0;   // If running_
+  int64_t start_cycles_ = 0;    // If running_ and use_cycle_clock_
+
+  // See UseCycleClock().
+  bool use_cycle_clock_ = false;
+  CycleClockCalibration cycle_clock_ = {};
+  int64_t (*read_cycles_)() = nullptr;
 
   // Accumulated time so far (does not contain current slice if running_)
   double real_time_used_ = 0;
   double cpu_time_used_ = 0;
   // Manually set iteration time. User sets this with SetIterationTime(seconds).
   double manual_time_used_ = 0;
+  int64_t intervals_ = 0;
+
+  // Per-iteration latency recording, see RecordLatencyInto().
+  LatencyHistogram* latency_histogram_ = nullptr;
+  int64_t last_mark_cycles_ = 0;
+  int64_t pause_start_cycles_ = 0;
+  int64_t paused_cycles_ = 0;
 };
 
 }  // namespace internal
@@ -0,0 +1,138 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "timer_overhead.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/state.h"
+#include "benchmark/utils.h"
+#include "statistics.h"
+#include "thread_manager.h"
+#include "thread_timer.h"
+
+namespace benchmark {
+namespace internal {
+
+namespace {
+
+// Enough iterations for a measurement to take about a millisecond, and the
+// median of several measurements to filter out interruptions.
+constexpr IterationCount kLoopIterations = 1 << 20;
+constexpr IterationCount kPauseIterations = 1 << 11;
+constexpr int kMeasurements = 5;
+
+// The compiler removes an entirely empty loop, but the loop of a benchmark
+// that does anything at all stays.
+void EmptyLoop(State& state) {
+  for (auto _ : state) {
+    ClobberMemory();
+  }
+}
+
+void PauseResumeLoop(State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    state.ResumeTiming();
+  }
+}
+
+// Returns the median real and CPU time per iteration of running `function`
+// with a timer created by `create_timer`.
+template <class CreateTimer>
+std::pair<double, double> TimePerIteration(Function* function,
+                                           IterationCount iterations,
+                                           CreateTimer create_timer) {
+  FunctionBenchmark benchmark("timer_overhead", function);
+  benchmark.Args({});
+  BenchmarkInstance instance(&benchmark, /*family_idx=*/-1,
+                             /*per_family_instance_idx=*/0, /*args_index=*/0,
+                             /*thread_count=*/1);
+  std::vector<double> real_times;
+  std::vector<double> cpu_times;
+  for (int i = 0; i < kMeasurements; ++i) {
+    ThreadTimer timer = create_timer();
+    ThreadManager manager(1);
+    instance.Run(iterations, /*thread_id=*/0, &timer, &manager,
+                 /*perf_counters_measurement=*/nullptr,
+                 /*profiler_manager=*/nullptr);
+    real_times.push_back(timer.real_time_used());
+    cpu_times.push_back(timer.cpu_time_used());
+  }
+  const double n = static_cast<double>(iterations);
+  return {StatisticsMedian(real_times) / n, StatisticsMedian(cpu_times) / n};
+}
+
+template <class CreateTimer>
+BenchmarkReporter::TimerOverhead MeasureTimerOverhead(
+    CreateTimer create_timer) {
+  const std::pair<double, double> loop =
+      TimePerIteration(EmptyLoop, kLoopIterations, create_timer);
+  const std::pair<double, double> pause =
+      TimePerIteration(PauseResumeLoop, kPauseIterations, create_timer);
+  BenchmarkReporter::TimerOverhead overhead;
+  overhead.real_time_per_iteration = loop.first;
+  overhead.cpu_time_per_iteration = loop.second;
+  overhead.real_time_per_pause = std::max(pause.first - loop.first, 0.0);
+  overhead.cpu_time_per_pause = std::max(pause.second - loop.second, 0.0);
+  return overhead;
+}
+
+std::map<std::string, BenchmarkReporter::TimerOverhead>
+MeasureTimerOverheads() {
+  std::map<std::string, BenchmarkReporter::TimerOverhead> overheads;
+  overheads["thread_cpu_time"] = MeasureTimerOverhead(ThreadTimer::Create);
+  overheads["process_cpu_time"] =
+      MeasureTimerOverhead(ThreadTimer::CreateProcessCpuTime);
+  overheads["cycle_clock"] = MeasureTimerOverhead([] {
+    ThreadTimer timer = ThreadTimer::Create();
+    timer.UseCycleClock();
+    return timer;
+  });
+  return overheads;
+}
+
+}  // namespace
+
+const std::map<std::string, BenchmarkReporter::TimerOverhead>&
+GetTimerOverhead() {
+  static const std::map<std::string, BenchmarkReporter::TimerOverhead>
+      overheads = MeasureTimerOverheads();
+  return overheads;
+}
+
+void SubtractTimerOverhead(const BenchmarkInstance& b,
+                           IterationCount iterations, int64_t intervals,
+                           double* real_time, double* cpu_time) {
+  const char* timing = b.use_cycle_clock()            ? "cycle_clock"
+                       : b.measure_process_cpu_time() ? "process_cpu_time"
+                                                      : "thread_cpu_time";
+  const BenchmarkReporter::TimerOverhead& overhead =
+      GetTimerOverhead().at(timing);
+  const double n = static_cast<double>(iterations);
+  const double pauses = static_cast<double>(intervals);
+  *real_time = std::max(*real_time - n * overhead.real_time_per_iteration -
+                            pauses * overhead.real_time_per_pause,
+                        0.0);
+  *cpu_time = std::max(*cpu_time - n * overhead.cpu_time_per_iteration -
+                           pauses * overhead.cpu_time_per_pause,
+                       0.0);
+}
+
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,46 @@
+// Copyright 2026 Google Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BENCHMARK_TIMER_OVERHEAD_H_
+#define BENCHMARK_TIMER_OVERHEAD_H_
+
+#include <map>
+#include <string>
+
+#include "benchmark/reporter.h"
+#include "benchmark/types.h"
+#include "benchmark_api_internal.h"
+
+namespace benchmark {
+namespace internal {
+
+// Returns the timer overhead of each way of timing, see
+// BenchmarkReporter::Context::timer_overhead. It is measured the first time
+// this is called, which takes a few dozen milliseconds, and must not overlap
+// with a running benchmark.
+BENCHMARK_EXPORT
+const std::map<std::string, BenchmarkReporter::TimerOverhead>&
+GetTimerOverhead();
+
+// Subtracts the timer overhead of the way `b` is timed from the times of one
+// of its threads, which ran `iterations` iterations and stopped its timer
+// `intervals` times. The times do not become negative.
+void SubtractTimerOverhead(const BenchmarkInstance& b,
+                           IterationCount iterations, int64_t intervals,
+                           double* real_time, double* cpu_time);
+
+}  // namespace internal
+}  // namespace benchmark
+
+#endif  // BENCHMARK_TIMER_OVERHEAD_H_
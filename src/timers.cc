@@ -48,6 +48,7 @@
 #include <emscripten.h>
 #endif
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdint>
 #include <cstdio>
@@ -58,7 +59,9 @@
 #include <limits>
 #include <mutex>
 
+#include "benchmark/sysinfo.h"
 #include "check.h"
+#include "cycleclock.h"
 #include "log.h"
 #include "string_util.h"
 
@@ -223,6 +226,43 @@ double ThreadCPUUsage() {
 #endif
 }
 
+namespace {
+
+CycleClockCalibration CalibrateCycleClock() {
+  CycleClockCalibration calibration;
+  // The cheapest of many readings is what the clock itself costs; the others
+  // were interrupted or missed a cache.
+  int64_t overhead = std::numeric_limits<int64_t>::max();
+  for (int i = 0; i < 1000; ++i) {
+    const int64_t start = cycleclock::NowSerialized();
+    const int64_t stop = cycleclock::NowSerialized();
+    overhead = std::min(overhead, stop - start);
+  }
+  calibration.overhead_cycles = std::max<int64_t>(overhead, 0);
+
+  // The cycle clock does not run at CPUInfo::cycles_per_second on every
+  // platform, e.g. it is the fixed-rate timer on ARMv8 and the TSC can tick
+  // at a different rate than the maximum frequency. So its rate is measured,
+  // and the reported frequency is only used if that fails.
+  const double start_time = ChronoClockNow();
+  const int64_t start_cycles = cycleclock::NowSerialized();
+  double elapsed = 0;
+  while ((elapsed = ChronoClockNow() - start_time) < 0.01) {
+  }
+  const int64_t cycles = cycleclock::NowSerialized() - start_cycles;
+  calibration.seconds_per_cycle =
+      cycles > 0 ? elapsed / static_cast<double>(cycles)
+                 : 1.0 / CPUInfo::Get().cycles_per_second;
+  return calibration;
+}
+
+}  // end namespace
+
+const CycleClockCalibration& GetCycleClockCalibration() {
+  static const CycleClockCalibration calibration = CalibrateCycleClock();
+  return calibration;
+}
+
 std::string LocalDateTimeString() {
   // Write the local time in RFC3339 format yyyy-mm-ddTHH:MM:SS+/-HH:MM.
   typedef std::chrono::system_clock Clock;
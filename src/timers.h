@@ -2,6 +2,7 @@
 #define BENCHMARK_TIMERS_H
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 
 namespace benchmark {
@@ -70,6 +71,17 @@ inline double ChronoClockNow() {
 
 std::string LocalDateTimeString();
 
+// How to turn readings of cycleclock::NowSerialized() into time.
+struct CycleClockCalibration {
+  double seconds_per_cycle;
+  // What a pair of back-to-back readings adds to the difference between them.
+  int64_t overhead_cycles;
+};
+
+// Measures the cycle clock the first time it is called, which takes about
+// 10ms.
+const CycleClockCalibration& GetCycleClockCalibration();
+
 }  // end namespace benchmark
 
 #endif  // BENCHMARK_TIMERS_H
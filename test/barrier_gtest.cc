@@ -0,0 +1,86 @@
+//===---------------------------------------------------------------------===//
+// barrier_gtest - Unit tests for the Barrier in src/mutex.h
+//===---------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "../src/mutex.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace {
+
+TEST(BarrierTest, SingleThread) {
+  Barrier barrier(1);
+  int64_t delay = -1;
+  EXPECT_TRUE(barrier.wait(&delay));
+  EXPECT_EQ(delay, 0);
+  EXPECT_TRUE(barrier.wait());
+}
+
+TEST(BarrierTest, NoThreadPassesBeforeAllArrived) {
+  constexpr int kNumThreads = 6;
+  constexpr int kNumPhases = 200;
+  Barrier barrier(kNumThreads);
+  std::atomic<int> arrived{0};
+  std::atomic<int> released{0};
+  std::atomic<bool> failed{false};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&]() {
+      for (int phase = 0; phase < kNumPhases; ++phase) {
+        arrived.fetch_add(1);
+        if (barrier.wait()) {
+          released.fetch_add(1);
+        }
+        if (arrived.load() < (phase + 1) * kNumThreads) {
+          failed = true;
+        }
+        // Keep the next phase from starting before everyone has checked.
+        barrier.wait();
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(failed.load());
+  EXPECT_EQ(released.load(), kNumPhases);
+}
+
+TEST(BarrierTest, RemoveThreadReleasesWaiters) {
+  Barrier barrier(3);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; ++t) {
+    threads.emplace_back([&barrier]() { barrier.wait(); });
+  }
+  // The waiters can only leave once the third thread is gone.
+  barrier.removeThread();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  // The remaining two threads keep using the barrier.
+  std::thread other([&barrier]() { barrier.wait(); });
+  barrier.wait();
+  other.join();
+}
+
+TEST(BarrierTest, ReportsReleaseDelay) {
+  Barrier barrier(2);
+  int64_t waiter_delay = -1;
+  std::thread waiter([&]() { barrier.wait(&waiter_delay); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  int64_t releaser_delay = -1;
+  barrier.wait(&releaser_delay);
+  waiter.join();
+  EXPECT_EQ(releaser_delay, 0);
+  EXPECT_GE(waiter_delay, 0);
+}
+
+}  // namespace
+}  // namespace benchmark
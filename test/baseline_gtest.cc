@@ -0,0 +1,168 @@
+//===---------------------------------------------------------------------===//
+// baseline_gtest - Unit tests for src/baseline.cc and src/json_reader.cc
+//===---------------------------------------------------------------------===//
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "../src/baseline.h"
+#include "../src/json_reader.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+// The expected p-values are those of scipy.stats.mannwhitneyu.
+TEST(MannWhitneyUTest, ExactWithoutTies) {
+  EXPECT_NEAR(MannWhitneyUTest({1, 2, 3}, {4, 5, 6}), 0.1, 1e-12);
+  EXPECT_NEAR(MannWhitneyUTest({4, 5, 6}, {1, 2, 3}), 0.1, 1e-12);
+  EXPECT_NEAR(MannWhitneyUTest({19, 22, 16, 29, 24}, {20, 11, 17, 12}),
+              0.1111111111111111, 1e-12);
+}
+
+TEST(MannWhitneyUTest, AsymptoticForLargeSamples) {
+  std::vector<double> x;
+  std::vector<double> y;
+  for (int i = 0; i < 10; ++i) {
+    x.push_back(i);
+    y.push_back(i + 10);
+  }
+  EXPECT_NEAR(MannWhitneyUTest(x, y), 0.0001826717911095504, 1e-12);
+}
+
+TEST(MannWhitneyUTest, AsymptoticWithTies) {
+  // Identical samples are as similar as they get.
+  EXPECT_NEAR(MannWhitneyUTest({1, 1, 2, 2}, {1, 1, 2, 2}), 1.0, 1e-12);
+  const double p = MannWhitneyUTest({1, 2, 2, 3}, {2, 3, 4, 5});
+  EXPECT_GT(p, 0.05);
+  EXPECT_LT(p, 0.5);
+}
+
+TEST(MannWhitneyUTest, EmptySample) {
+  EXPECT_NEAR(MannWhitneyUTest({}, {1, 2}), 1.0, 1e-12);
+}
+
+TEST(ParseJson, Document) {
+  JsonValue value;
+  std::string error;
+  ASSERT_TRUE(ParseJson(
+      "{\"a\": [1, -2.5e3, true, null], \"b\": \"x\\n\\u00e9\", "
+      "\"c\": NaN, \"d\": -Infinity}",
+      &value, &error))
+      << error;
+  ASSERT_EQ(value.type, JsonValue::kObject);
+  const JsonValue* a = value.Find("a");
+  ASSERT_NE(a, nullptr);
+  ASSERT_EQ(a->array.size(), 4u);
+  EXPECT_NEAR(a->array[1].number, -2500, 1e-9);
+  EXPECT_TRUE(a->array[2].boolean);
+  EXPECT_EQ(a->array[3].type, JsonValue::kNull);
+  EXPECT_EQ(value.Find("b")->string, "x\n\xc3\xa9");
+  EXPECT_TRUE(std::isnan(value.Find("c")->number));
+  EXPECT_LT(value.Find("d")->number, 0);
+  EXPECT_EQ(value.Find("e"), nullptr);
+}
+
+TEST(ParseJson, Errors) {
+  JsonValue value;
+  std::string error;
+  EXPECT_FALSE(ParseJson("{\"a\": 1", &value, &error));
+  EXPECT_FALSE(error.empty());
+  EXPECT_FALSE(ParseJson("[1, 2] 3", &value, &error));
+  EXPECT_FALSE(ParseJson("[1.2.3]", &value, &error));
+  EXPECT_FALSE(ParseJson(std::string(100, '['), &value, &error));
+}
+
+const char kBaselineJson[] = R"({
+  "context": {},
+  "benchmarks": [
+    {"name": "BM_Foo", "run_type": "iteration", "real_time": 10,
+     "cpu_time": 20, "time_unit": "us"},
+    {"name": "BM_Foo", "run_type": "iteration", "real_time": 12,
+     "cpu_time": 22, "time_unit": "us"},
+    {"name": "BM_Foo_mean", "run_type": "aggregate", "real_time": 11,
+     "cpu_time": 21, "time_unit": "us"},
+    {"name": "BM_Bar", "run_type": "iteration", "error_occurred": true,
+     "error_message": "oops"}
+  ]
+})";
+
+TEST(Baseline, Parse) {
+  Baseline baseline;
+  std::string error;
+  ASSERT_TRUE(baseline.Parse(kBaselineJson, &error)) << error;
+  const BaselineTimes* times = baseline.Find("BM_Foo");
+  ASSERT_NE(times, nullptr);
+  ASSERT_EQ(times->real_time.size(), 2u);
+  EXPECT_NEAR(times->real_time[1], 12e-6, 1e-15);
+  EXPECT_NEAR(times->cpu_time[0], 20e-6, 1e-15);
+  EXPECT_EQ(baseline.Find("BM_Foo_mean"), nullptr);
+  EXPECT_EQ(baseline.Find("BM_Bar"), nullptr);
+
+  EXPECT_FALSE(baseline.Parse("{}", &error));
+  EXPECT_FALSE(baseline.Load("does/not/exist.json", &error));
+}
+
+BaselineTimes MakeTimes(double first, int count) {
+  BaselineTimes times;
+  for (int i = 0; i < count; ++i) {
+    times.real_time.push_back(first + i);
+    times.cpu_time.push_back(2 * (first + i));
+  }
+  return times;
+}
+
+TEST(CompareToBaseline, Regression) {
+  const BaselineComparison comparison =
+      CompareToBaseline(MakeTimes(0, 9), MakeTimes(100, 9), true, 0.05);
+  EXPECT_EQ(comparison.verdict, BaselineComparison::kRegression);
+  EXPECT_LT(comparison.p_value, 0.05);
+  EXPECT_NEAR(comparison.real_time_change, 25.0, 1e-9);
+  EXPECT_EQ(comparison.repetitions, 9u);
+}
+
+TEST(CompareToBaseline, Improvement) {
+  const BaselineComparison comparison =
+      CompareToBaseline(MakeTimes(100, 9), MakeTimes(0, 9), false, 0.05);
+  EXPECT_EQ(comparison.verdict, BaselineComparison::kImprovement);
+  EXPECT_LT(comparison.cpu_time_change, 0);
+}
+
+TEST(CompareToBaseline, AmbiguousUntilEnoughRepetitions) {
+  EXPECT_EQ(
+      CompareToBaseline(MakeTimes(0, 3), MakeTimes(0, 3), true, 0.05).verdict,
+      BaselineComparison::kAmbiguous);
+  EXPECT_EQ(
+      CompareToBaseline(MakeTimes(0, 9), MakeTimes(0, 9), true, 0.05).verdict,
+      BaselineComparison::kNoChange);
+  // Too few repetitions for a test at all.
+  const BaselineComparison comparison =
+      CompareToBaseline(MakeTimes(0, 1), MakeTimes(100, 9), true, 0.05);
+  EXPECT_EQ(comparison.verdict, BaselineComparison::kAmbiguous);
+  EXPECT_NEAR(comparison.p_value, 1.0, 1e-12);
+}
+
+TEST(CreateBaselineReport, Aggregate) {
+  BenchmarkReporter::Run run;
+  run.run_name.function_name = "BM_Foo";
+  run.repetitions = 9;
+  BaselineComparison comparison;
+  comparison.verdict = BaselineComparison::kRegression;
+  comparison.p_value = 0.001;
+  comparison.real_time_change = 0.25;
+  comparison.baseline_repetitions = 5;
+  comparison.repetitions = 9;
+  const BenchmarkReporter::Run report =
+      CreateBaselineReport({run}, comparison);
+  EXPECT_EQ(report.benchmark_name(), "BM_Foo_vs_baseline");
+  EXPECT_EQ(report.run_type, BenchmarkReporter::Run::RT_Aggregate);
+  EXPECT_EQ(report.aggregate_unit, StatisticUnit::kPercentage);
+  EXPECT_NEAR(report.real_accumulated_time, 0.25, 1e-12);
+  EXPECT_EQ(report.report_label, "regression, p=0.0010, 5 vs 9 repetitions");
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,99 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/registration.h"
+#include "benchmark/reporter.h"
+#include "benchmark/state.h"
+#include "benchmark/utils.h"
+
+// Tests that a benchmark much slower than the baseline is reported as a
+// regression, and that repetitions are added while the comparison is
+// inconclusive.
+
+namespace {
+
+void BM_Slower(benchmark::State& state) {
+  int sum = 0;
+  for (auto _ : state) {
+    for (int i = 0; i < 100; ++i) {
+      benchmark::DoNotOptimize(sum += i);
+    }
+  }
+}
+BENCHMARK(BM_Slower)->Iterations(10)->Repetitions(2);
+
+// Not in the baseline.
+void BM_New(benchmark::State& state) {
+  for (auto _ : state) {
+  }
+}
+BENCHMARK(BM_New)->Iterations(10)->Repetitions(2);
+
+const char kBaseline[] = R"({
+  "context": {},
+  "benchmarks": [
+    {"name": "BM_Slower/iterations:10/repeats:2", "run_type": "iteration",
+     "real_time": 0.001, "cpu_time": 0.001, "time_unit": "ns"},
+    {"name": "BM_Slower/iterations:10/repeats:2", "run_type": "iteration",
+     "real_time": 0.002, "cpu_time": 0.002, "time_unit": "ns"}
+  ]
+})";
+
+class TestReporter : public benchmark::ConsoleReporter {
+ public:
+  void ReportRuns(const std::vector<Run>& reports) override {
+    for (const Run& run : reports) {
+      if (run.run_type == Run::RT_Iteration) {
+        ++repetitions[run.benchmark_name()];
+      } else if (run.aggregate_name == "vs_baseline") {
+        comparisons.push_back(run);
+      }
+    }
+    ConsoleReporter::ReportRuns(reports);
+  }
+
+  std::map<std::string, int> repetitions;
+  std::vector<Run> comparisons;
+};
+
+}  // end namespace
+
+int main(int argc, char** argv) {
+  benchmark::MaybeReenterWithoutASLR(argc, argv);
+  const std::string baseline = std::string(argv[0]) + ".baseline.json";
+  {
+    std::ofstream out(baseline);
+    out << kBaseline;
+  }
+
+  std::string baseline_flag = "--benchmark_baseline=" + baseline;
+  std::vector<char*> args(argv, argv + argc);
+  args.push_back(&baseline_flag[0]);
+  int num_args = static_cast<int>(args.size());
+  benchmark::Initialize(&num_args, args.data());
+
+  TestReporter reporter;
+  assert(benchmark::RunSpecifiedBenchmarks(&reporter) == 2);
+  std::remove(baseline.c_str());
+
+  // Two repetitions against two of the baseline can never be significant, so
+  // seven more were run, which are.
+  assert(reporter.repetitions["BM_Slower/iterations:10/repeats:2"] == 9);
+  assert(reporter.repetitions["BM_New/iterations:10/repeats:2"] == 2);
+  assert(reporter.comparisons.size() == 1);
+  const benchmark::BenchmarkReporter::Run& comparison =
+      reporter.comparisons.front();
+  assert(comparison.benchmark_name() ==
+         "BM_Slower/iterations:10/repeats:2_vs_baseline");
+  assert(comparison.report_label.find("regression") == 0);
+  assert(comparison.cpu_accumulated_time > 1);
+  assert(benchmark::GetNumBaselineRegressions() == 1);
+  return 0;
+}
@@ -1,7 +1,9 @@
 #include <map>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include "../src/benchmark_api_internal.h"
 #include "../src/benchmark_register.h"
 #include "benchmark/benchmark_api.h"
 #include "gmock/gmock.h"
@@ -135,6 +137,82 @@ TEST(AddRangeTest, Simple8) {
               testing::ElementsAre(int8_t{1}, int8_t{2}, int8_t{4}, int8_t{8}));
 }
 
+std::vector<CPUInfo::CacheInfo> TestCaches() {
+  return {{"Data", 1, 32 << 10, 2},
+          {"Instruction", 1, 32 << 10, 2},
+          {"Unified", 2, 1 << 20, 2},
+          {"Unified", 3, 32 << 20, 16}};
+}
+
+TEST(CacheSweepTest, Levels) {
+  const std::vector<CacheSweepLevel> levels =
+      GetCacheSweepLevels(TestCaches(), 6 << 20);
+  ASSERT_EQ(levels.size(), 4u);
+  EXPECT_EQ(levels[0].name, "L1");
+  EXPECT_EQ(levels[0].bytes, 32 << 10);
+  EXPECT_EQ(levels[1].name, "L2");
+  EXPECT_EQ(levels[2].name, "TLB");
+  EXPECT_EQ(levels[2].bytes, 6 << 20);
+  EXPECT_EQ(levels[3].name, "L3");
+}
+
+TEST(CacheSweepTest, AssumesTypicalCaches) {
+  const std::vector<CacheSweepLevel> levels = GetCacheSweepLevels({}, 0);
+  ASSERT_EQ(levels.size(), 3u);
+  EXPECT_EQ(levels[2].name, "L3");
+}
+
+TEST(CacheSweepTest, Points) {
+  const std::vector<CacheSweepLevel> levels = {
+      {"L1", 32 << 10}, {"L2", 64 << 10}, {"L3", 1 << 20}};
+  // above_L1 and L2 are the same working set.
+  EXPECT_THAT(CreateCacheSweep(levels, 8),
+              testing::ElementsAre(testing::Pair("below_L1", 2048),
+                                   testing::Pair("L1", 4096),
+                                   testing::Pair("above_L1", 8192),
+                                   testing::Pair("above_L2", 16384),
+                                   testing::Pair("below_L3", 65536),
+                                   testing::Pair("L3", 131072),
+                                   testing::Pair("above_L3", 262144)));
+}
+
+TEST(CacheSweepTest, DescribeWorkingSet) {
+  const std::vector<CacheSweepLevel> levels =
+      GetCacheSweepLevels(TestCaches(), 6 << 20);
+  EXPECT_EQ(DescribeWorkingSet(levels, 32 << 10), "fits in L1");
+  EXPECT_EQ(DescribeWorkingSet(levels, 2 << 20), "fits in L3");
+  EXPECT_EQ(DescribeWorkingSet(levels, 8 << 20),
+            "fits in L3, exceeds TLB reach");
+  EXPECT_EQ(DescribeWorkingSet(levels, 64 << 20),
+            "exceeds L3, exceeds TLB reach");
+}
+
+void BM_Sweep(State& state) {
+  for (auto _ : state) {
+  }
+}
+
+TEST(CacheSweepTest, NamesInstances) {
+  RegisterBenchmark("BM_Sweep", BM_Sweep)
+      ->ArgName("n")
+      ->Arg(1)
+      ->CacheSweep(4)
+      ->Arg(2);
+  std::vector<BenchmarkInstance> instances;
+  std::ostringstream err_stream;
+  ASSERT_TRUE(FindBenchmarksInternal("BM_Sweep", &instances, &err_stream));
+  ClearRegisteredBenchmarks();
+  // The working sets are inserted where CacheSweep() was called.
+  ASSERT_GT(instances.size(), 3u);
+  EXPECT_EQ(instances.front().name().str(), "BM_Sweep/n:1");
+  EXPECT_EQ(instances.front().working_set_description(), "");
+  EXPECT_THAT(instances[1].name().str(),
+              testing::MatchesRegex("BM_Sweep/n:[0-9]+/below_L1"));
+  EXPECT_EQ(instances[1].working_set_description(), "fits in L1");
+  EXPECT_EQ(instances.back().name().str(), "BM_Sweep/n:2");
+  EXPECT_EQ(instances.back().working_set_description(), "");
+}
+
 TEST(AddCustomContext, Simple) {
   std::map<std::string, std::string>*& global_context = GetGlobalContext();
   EXPECT_THAT(global_context, nullptr);
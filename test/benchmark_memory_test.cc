@@ -0,0 +1,76 @@
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/registration.h"
+#include "benchmark/reporter.h"
+#include "benchmark/state.h"
+#include "benchmark/utils.h"
+
+// Tests that linking benchmark_memory counts the allocations made by the
+// benchmarks, without registering a memory manager.
+namespace {
+
+constexpr int kIterations = 4;
+
+class MemoryReporter : public benchmark::BenchmarkReporter {
+ public:
+  bool ReportContext(const Context& /*context*/) override { return true; }
+  void ReportRuns(const std::vector<Run>& report) override {
+    for (const Run& run : report) {
+      results[run.benchmark_name()] = run.memory_result;
+    }
+  }
+
+  std::map<std::string, benchmark::MemoryManager::Result> results;
+};
+
+void BM_Empty(benchmark::State& state) {
+  for (auto _ : state) {
+  }
+}
+BENCHMARK(BM_Empty)->Iterations(kIterations);
+
+// Two allocations per iteration, of which both are live at the same time.
+void BM_Allocate(benchmark::State& state) {
+  for (auto _ : state) {
+    char* small = new char[1000];
+    benchmark::DoNotOptimize(small);
+    char* large = new char[3000];
+    benchmark::DoNotOptimize(large);
+    delete[] large;
+    delete[] small;
+  }
+}
+BENCHMARK(BM_Allocate)->Iterations(kIterations);
+
+}  // end namespace
+
+int main(int argc, char** argv) {
+  benchmark::MaybeReenterWithoutASLR(argc, argv);
+  benchmark::Initialize(&argc, argv);
+
+  MemoryReporter reporter;
+  const size_t returned_count = benchmark::RunSpecifiedBenchmarks(&reporter);
+  assert(returned_count == 2);
+
+  // The allocations made by the library itself while the benchmark runs are
+  // the same for both benchmarks.
+  const benchmark::MemoryManager::Result& empty =
+      reporter.results.at("BM_Empty/iterations:4");
+  const benchmark::MemoryManager::Result& allocate =
+      reporter.results.at("BM_Allocate/iterations:4");
+  assert(allocate.memory_iterations == kIterations);
+  assert(allocate.num_allocs - empty.num_allocs == 2 * kIterations);
+  assert(allocate.total_allocated_bytes - empty.total_allocated_bytes >=
+         4000 * kIterations);
+  assert(allocate.max_bytes_used >= 4000);
+  assert(allocate.net_heap_growth == empty.net_heap_growth);
+  (void)returned_count;
+  (void)empty;
+  (void)allocate;
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/registration.h"
+#include "benchmark/reporter.h"
+#include "benchmark/state.h"
+#include "benchmark/utils.h"
+
+// Tests that --benchmark_target_rel_error stops a stable benchmark long before
+// --benchmark_min_time, leaves explicit iteration counts alone, and keeps the
+// iteration count, the aggregates and the user counters of repetitions
+// consistent.
+namespace {
+
+class TestReporter : public benchmark::ConsoleReporter {
+ public:
+  void ReportRuns(const std::vector<Run>& report) override {
+    runs_.insert(runs_.end(), report.begin(), report.end());
+    ConsoleReporter::ReportRuns(report);
+  }
+
+  const std::vector<Run>& GetRuns() const { return runs_; }
+
+ private:
+  std::vector<Run> runs_;
+};
+
+void BM_Stable(benchmark::State& state) {
+  int x = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(++x);
+  }
+}
+BENCHMARK(BM_Stable);
+BENCHMARK(BM_Stable)->Name("BM_StableExplicitIters")->Iterations(1234);
+
+// Each run (and so each sub-batch) is randomly fast or slow, so that every
+// repetition would need a different number of sub-batches on its own.
+void BM_Noisy(benchmark::State& state) {
+  static std::mt19937 rng(42);
+  const int work = (rng() % 2 == 0) ? 1 : 10;
+  int x = 0;
+  for (auto _ : state) {
+    for (int i = 0; i < work; ++i) {
+      benchmark::DoNotOptimize(++x);
+    }
+  }
+  state.counters["plain"] = 42;
+  state.counters["per_thread"] =
+      benchmark::Counter(42, benchmark::Counter::kAvgThreads);
+  state.counters["per_iteration"] =
+      benchmark::Counter(3 * static_cast<double>(state.iterations()),
+                         benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_Noisy)->Repetitions(4);
+
+bool Near(double value, double expected) {
+  return std::abs(value - expected) < 1e-9 * std::abs(expected);
+}
+
+}  // end namespace
+
+int main(int argc, char** argv) {
+  benchmark::MaybeReenterWithoutASLR(argc, argv);
+
+  std::vector<char*> fake_argv(argv, argv + argc);
+  std::string min_time = "--benchmark_min_time=30s";
+  std::string target = "--benchmark_target_rel_error=0.5";
+  std::string max_time = "--benchmark_max_time=0.5";
+  fake_argv.push_back(&min_time[0]);
+  fake_argv.push_back(&target[0]);
+  fake_argv.push_back(&max_time[0]);
+  int fake_argc = static_cast<int>(fake_argv.size());
+  benchmark::Initialize(&fake_argc, fake_argv.data());
+
+  TestReporter test_reporter;
+  const size_t returned_count =
+      benchmark::RunSpecifiedBenchmarks(&test_reporter);
+  assert(returned_count == 3);
+
+  using Run = benchmark::BenchmarkReporter::Run;
+  std::vector<Run> stable;
+  std::vector<Run> noisy;
+  std::map<std::string, Run> noisy_aggregates;
+  for (const Run& run : test_reporter.GetRuns()) {
+    if (run.run_name.function_name != "BM_Noisy") {
+      stable.push_back(run);
+    } else if (run.run_type == Run::RT_Iteration) {
+      noisy.push_back(run);
+    } else {
+      noisy_aggregates[run.aggregate_name] = run;
+    }
+  }
+
+  // A +/-50% interval is reached after the minimum number of sub-batches, far
+  // below --benchmark_min_time.
+  assert(stable.size() == 2);
+  assert(stable[0].skipped == 0);
+  assert(stable[0].iterations > 0);
+  assert(stable[0].real_accumulated_time < 1.0);
+
+  assert(stable[1].iterations == 1234);
+
+  // All repetitions run as many iterations as the first.
+  assert(noisy.size() == 4);
+  double fastest = noisy[0].GetAdjustedRealTime();
+  double slowest = fastest;
+  for (const Run& run : noisy) {
+    assert(run.iterations == noisy[0].iterations);
+    fastest = std::min(fastest, run.GetAdjustedRealTime());
+    slowest = std::max(slowest, run.GetAdjustedRealTime());
+    // Merging the sub-batches leaves the counters as they are for one run.
+    assert(Near(run.counters.at("plain"), 42));
+    assert(Near(run.counters.at("per_thread"), 42));
+    assert(Near(run.counters.at("per_iteration"), 3));
+  }
+
+  // So the aggregates are over the time per iteration of each repetition.
+  for (const char* name : {"mean", "median"}) {
+    const Run& aggregate = noisy_aggregates.at(name);
+    assert(aggregate.GetAdjustedRealTime() >= fastest * (1 - 1e-9));
+    assert(aggregate.GetAdjustedRealTime() <= slowest * (1 + 1e-9));
+    assert(Near(aggregate.counters.at("plain"), 42));
+  }
+
+  (void)fastest;
+  (void)slowest;
+  return 0;
+}
@@ -0,0 +1,125 @@
+//===---------------------------------------------------------------------===//
+// checkpoint_gtest - Unit tests for src/checkpoint.cc
+//===---------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../src/checkpoint.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+const char kPath[] = "checkpoint_gtest.checkpoint";
+
+BenchmarkReporter::Run MakeRun(int64_t repetition_index) {
+  BenchmarkReporter::Run run;
+  run.run_name.function_name = "BM_Foo";
+  run.family_index = 1;
+  run.per_family_instance_index = 2;
+  run.repetition_index = repetition_index;
+  run.repetitions = 2;
+  run.iterations = 100 + repetition_index;
+  return run;
+}
+
+std::string ReadFile(const std::string& path) {
+  std::string data;
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if (file != nullptr) {
+    char buffer[256];
+    size_t n = 0;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+      data.append(buffer, n);
+    }
+    std::fclose(file);
+  }
+  return data;
+}
+
+void WriteFile(const std::string& path, const std::string& data) {
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  std::fwrite(data.data(), 1, data.size(), file);
+  std::fclose(file);
+}
+
+class CheckpointTest : public ::testing::Test {
+ protected:
+  void SetUp() override { std::remove(kPath); }
+  void TearDown() override { std::remove(kPath); }
+};
+
+TEST_F(CheckpointTest, MissingFileIsEmpty) {
+  Checkpoint checkpoint(kPath);
+  ASSERT_TRUE(checkpoint.Load());
+  std::vector<BenchmarkReporter::Run> runs;
+  EXPECT_FALSE(checkpoint.TakeRuns("BM_Foo", 1, 2, 2, &runs));
+}
+
+TEST_F(CheckpointTest, RejectsOtherFiles) {
+  WriteFile(kPath, "{\"context\": {}}\n");
+  Checkpoint checkpoint(kPath);
+  EXPECT_FALSE(checkpoint.Load());
+}
+
+TEST_F(CheckpointTest, RestoresCompletedInstances) {
+  {
+    Checkpoint checkpoint(kPath);
+    ASSERT_TRUE(checkpoint.Load());
+    ASSERT_TRUE(checkpoint.Start());
+    checkpoint.Record(MakeRun(1));
+    checkpoint.Record(MakeRun(0));
+  }
+
+  Checkpoint checkpoint(kPath);
+  ASSERT_TRUE(checkpoint.Load());
+  std::vector<BenchmarkReporter::Run> runs;
+  // Runs of a different instance are never handed out.
+  EXPECT_FALSE(checkpoint.TakeRuns("BM_Bar", 1, 2, 2, &runs));
+  EXPECT_FALSE(checkpoint.TakeRuns("BM_Foo", 0, 2, 2, &runs));
+  EXPECT_FALSE(checkpoint.TakeRuns("BM_Foo", 1, 2, 3, &runs));
+  ASSERT_TRUE(checkpoint.TakeRuns("BM_Foo", 1, 2, 2, &runs));
+  ASSERT_EQ(runs.size(), 2u);
+  EXPECT_EQ(runs[0].repetition_index, 0);
+  EXPECT_EQ(runs[0].iterations, 100);
+  EXPECT_EQ(runs[1].repetition_index, 1);
+  EXPECT_EQ(runs[1].iterations, 101);
+  EXPECT_FALSE(checkpoint.TakeRuns("BM_Foo", 1, 2, 2, &runs));
+}
+
+TEST_F(CheckpointTest, DropsIncompleteInstancesAndTruncatedRecords) {
+  {
+    Checkpoint checkpoint(kPath);
+    ASSERT_TRUE(checkpoint.Load());
+    ASSERT_TRUE(checkpoint.Start());
+    checkpoint.Record(MakeRun(0));
+    checkpoint.Record(MakeRun(1));
+  }
+  // Cut the last record short, as if the process died while writing it.
+  const std::string data = ReadFile(kPath);
+  WriteFile(kPath, data.substr(0, data.size() - 3));
+
+  {
+    Checkpoint checkpoint(kPath);
+    ASSERT_TRUE(checkpoint.Load());
+    std::vector<BenchmarkReporter::Run> runs;
+    EXPECT_FALSE(checkpoint.TakeRuns("BM_Foo", 1, 2, 2, &runs));
+    // Starting over only keeps the runs that were taken.
+    ASSERT_TRUE(checkpoint.Start());
+  }
+
+  Checkpoint checkpoint(kPath);
+  ASSERT_TRUE(checkpoint.Load());
+  std::vector<BenchmarkReporter::Run> runs;
+  EXPECT_FALSE(checkpoint.TakeRuns("BM_Foo", 1, 2, 1, &runs));
+  checkpoint.Remove();
+  EXPECT_TRUE(ReadFile(kPath).empty());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,135 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/registration.h"
+#include "benchmark/reporter.h"
+#include "benchmark/state.h"
+#include "benchmark/utils.h"
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Tests that a run interrupted halfway through can be resumed from its
+// checkpoint: the benchmarks completed before the interruption are reported
+// from the checkpoint instead of being run again.
+
+namespace {
+
+bool crash = false;
+int first_runs = 0;
+int last_runs = 0;
+
+void BM_First(benchmark::State& state) {
+  ++first_runs;
+  for (auto _ : state) {
+  }
+  state.counters["answer"] = 42;
+}
+BENCHMARK(BM_First)->Repetitions(2)->Iterations(7);
+
+void BM_Crash(benchmark::State& state) {
+  for (auto _ : state) {
+    if (crash) {
+      std::_Exit(1);
+    }
+  }
+}
+BENCHMARK(BM_Crash)->Iterations(1);
+
+void BM_Last(benchmark::State& state) {
+  ++last_runs;
+  for (auto _ : state) {
+  }
+}
+BENCHMARK(BM_Last)->Iterations(1);
+
+class TestReporter : public benchmark::ConsoleReporter {
+ public:
+  void ReportRuns(const std::vector<Run>& report) override {
+    for (const Run& run : report) {
+      names.push_back(run.benchmark_name());
+      if (run.run_name.function_name == "BM_First" &&
+          run.run_type == Run::RT_Iteration) {
+        assert(run.iterations == 7);
+        assert(run.counters.at("answer").value > 41.5);
+      }
+    }
+    ConsoleReporter::ReportRuns(report);
+  }
+
+  std::vector<std::string> names;
+};
+
+bool FileExists(const std::string& path) {
+  std::FILE* file = std::fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return false;
+  }
+  std::fclose(file);
+  return true;
+}
+
+}  // end namespace
+
+int main(int argc, char** argv) {
+#if !defined(_WIN32)
+  benchmark::MaybeReenterWithoutASLR(argc, argv);
+  const std::string checkpoint = std::string(argv[0]) + ".checkpoint";
+  std::remove(checkpoint.c_str());
+
+  std::string checkpoint_flag = "--benchmark_checkpoint=" + checkpoint;
+  std::vector<char*> args(argv, argv + argc);
+  args.push_back(&checkpoint_flag[0]);
+  int num_args = static_cast<int>(args.size());
+  benchmark::Initialize(&num_args, args.data());
+
+  // The first run dies in the middle of BM_Crash.
+  const pid_t pid = fork();
+  assert(pid >= 0);
+  if (pid == 0) {
+    crash = true;
+    std::stringstream out;
+    benchmark::ConsoleReporter reporter;
+    reporter.SetOutputStream(&out);
+    reporter.SetErrorStream(&out);
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    std::_Exit(0);
+  }
+  int status = 0;
+  assert(waitpid(pid, &status, 0) == pid);
+  assert(WIFEXITED(status) && WEXITSTATUS(status) == 1);
+  assert(FileExists(checkpoint));
+
+  // The second one only runs what is left, but reports everything.
+  TestReporter reporter;
+  assert(benchmark::RunSpecifiedBenchmarks(&reporter) == 3);
+  assert(first_runs == 0);
+  assert(last_runs == 1);
+  const std::vector<std::string> expected = {
+      "BM_First/iterations:7/repeats:2",
+      "BM_First/iterations:7/repeats:2",
+      "BM_First/iterations:7/repeats:2_mean",
+      "BM_First/iterations:7/repeats:2_median",
+      "BM_First/iterations:7/repeats:2_stddev",
+      "BM_First/iterations:7/repeats:2_cv",
+      "BM_Crash/iterations:1",
+      "BM_Last/iterations:1"};
+  assert(reporter.names == expected);
+
+  // Once everything is reported, the checkpoint is gone.
+  assert(!FileExists(checkpoint));
+#else
+  (void)argc;
+  (void)argv;
+#endif
+  return 0;
+}
@@ -0,0 +1,185 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/registration.h"
+#include "benchmark/reporter.h"
+#include "benchmark/state.h"
+#include "benchmark/utils.h"
+
+// Tests that the columnar output can be decoded back into the fields of the
+// JSON output, also when it is split over several batches.
+
+namespace {
+
+void BM_Counters(benchmark::State& state) {
+  for (auto _ : state) {
+  }
+  state.counters["foo"] = 1.5;
+  state.counters["memory_roof_pct"] = 80;
+  state.counters["compute_roof_pct"] = 20;
+  state.SetLabel("some label");
+}
+BENCHMARK(BM_Counters)->Repetitions(2)->Iterations(3);
+
+void BM_Error(benchmark::State& state) {
+  state.SkipWithError("oops");
+  for (auto _ : state) {
+  }
+}
+BENCHMARK(BM_Error);
+
+// Enough instances for more than one batch.
+void BM_Many(benchmark::State& state) {
+  for (auto _ : state) {
+  }
+}
+BENCHMARK(BM_Many)->DenseRange(0, 16999)->Iterations(1);
+
+class Decoder {
+ public:
+  explicit Decoder(std::string data) : data_(std::move(data)) {}
+
+  uint64_t Get(size_t width) {
+    assert(pos_ + width <= data_.size());
+    uint64_t value = 0;
+    for (size_t i = 0; i < width; ++i) {
+      value |= static_cast<uint64_t>(static_cast<unsigned char>(data_[pos_++]))
+               << (8 * i);
+    }
+    return value;
+  }
+
+  std::string GetBytes(size_t size) {
+    assert(pos_ + size <= data_.size());
+    std::string bytes = data_.substr(pos_, size);
+    pos_ += size;
+    return bytes;
+  }
+
+  std::string GetString() { return GetBytes(Get(4)); }
+
+  bool done() const { return pos_ == data_.size(); }
+
+ private:
+  std::string data_;
+  size_t pos_ = 0;
+};
+
+using Row = std::map<std::string, std::string>;
+
+// Decodes the rows, with every value turned into a string.
+std::vector<Row> Decode(const std::string& data, size_t* num_batches) {
+  Decoder d(data);
+  assert(d.GetBytes(8) == "GBCOLUMN");
+  assert(d.Get(4) == 1);
+  const std::string context = d.GetString();
+  assert(context.front() == '{' && context.back() == '}');
+  assert(context.find("\"date\": ") != std::string::npos);
+
+  std::vector<std::string> dictionary;
+  std::vector<Row> rows;
+  *num_batches = 0;
+  for (;;) {
+    const char tag = d.GetBytes(1)[0];
+    if (tag == 'E') {
+      break;
+    }
+    if (tag == 'D') {
+      for (uint64_t n = d.Get(4); n > 0; --n) {
+        dictionary.push_back(d.GetString());
+      }
+      continue;
+    }
+    assert(tag == 'B');
+    ++*num_batches;
+    const size_t first_row = rows.size();
+    const size_t num_rows = d.Get(4);
+    rows.resize(first_row + num_rows);
+    for (uint64_t num_columns = d.Get(4); num_columns > 0; --num_columns) {
+      const std::string name = d.GetString();
+      const char type = d.GetBytes(1)[0];
+      const std::string validity = d.GetBytes((num_rows + 7) / 8);
+      for (size_t i = 0; i < num_rows; ++i) {
+        const bool valid = ((validity[i / 8] >> (i % 8)) & 1) != 0;
+        std::string value;
+        if (type == 'i') {
+          value = std::to_string(static_cast<int64_t>(d.Get(8)));
+        } else if (type == 'f') {
+          const uint64_t bits = d.Get(8);
+          double v = 0;
+          std::memcpy(&v, &bits, sizeof(v));
+          value = std::to_string(v);
+        } else if (type == 'b') {
+          value = d.Get(1) != 0 ? "true" : "false";
+        } else {
+          assert(type == 's');
+          value = dictionary.at(d.Get(4));
+        }
+        if (valid) {
+          rows[first_row + i][name] = value;
+        }
+      }
+    }
+  }
+  assert(d.done());
+  return rows;
+}
+
+}  // end namespace
+
+int main(int argc, char** argv) {
+  benchmark::MaybeReenterWithoutASLR(argc, argv);
+  benchmark::Initialize(&argc, argv);
+
+  std::stringstream out;
+  benchmark::ColumnarReporter reporter;
+  reporter.SetOutputStream(&out);
+  benchmark::RunSpecifiedBenchmarks(&reporter);
+
+  size_t num_batches = 0;
+  const std::vector<Row> rows = Decode(out.str(), &num_batches);
+  // Two repetitions and four aggregates, the error and the many instances.
+  assert(rows.size() == 2 + 4 + 1 + 17000);
+  assert(num_batches == 2);
+
+  const Row& repetition = rows[1];
+  assert(repetition.at("name") == "BM_Counters/iterations:3/repeats:2");
+  assert(repetition.at("run_type") == "iteration");
+  assert(repetition.at("repetition_index") == "1");
+  assert(repetition.at("iterations") == "3");
+  assert(repetition.at("time_unit") == "ns");
+  assert(repetition.at("foo") == std::to_string(1.5));
+  assert(repetition.at("label") == "some label");
+  assert(repetition.at("roofline_bound") == "memory");
+  assert(repetition.count("aggregate_name") == 0);
+
+  const Row& mean = rows[2];
+  assert(mean.at("name") == "BM_Counters/iterations:3/repeats:2_mean");
+  assert(mean.at("run_type") == "aggregate");
+  assert(mean.at("aggregate_name") == "mean");
+  assert(mean.count("repetition_index") == 0);
+  assert(mean.at("roofline_bound") == "memory");
+  assert(rows[4].at("aggregate_name") == "stddev");
+  assert(rows[4].count("roofline_bound") == 0);
+
+  const Row& error = rows[6];
+  assert(error.at("name") == "BM_Error");
+  assert(error.at("error_occurred") == "true");
+  assert(error.at("error_message") == "oops");
+  assert(error.count("foo") == 0);
+  assert(error.count("roofline_bound") == 0);
+
+  // Names first seen in the second batch are in the dictionary too.
+  assert(rows.back().at("name") == "BM_Many/16999/iterations:1");
+  assert(rows.back().at("family_index") == "2");
+  assert(rows.back().at("per_family_instance_index") == "16999");
+  return 0;
+}
@@ -0,0 +1,132 @@
+//===---------------------------------------------------------------------===//
+// cpu_affinity_gtest - Unit tests for src/cpu_affinity.cc
+//===---------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "../src/cpu_affinity.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Two packages with two cores each, every core has two SMT siblings and its
+// own L2 cache. CPUs n and n + 4 are siblings.
+std::vector<CPUInfo::LogicalCPU> TwoPackagesWithSMT() {
+  std::vector<CPUInfo::LogicalCPU> topology;
+  for (int cpu = 0; cpu < 8; ++cpu) {
+    const int core = cpu % 4;
+    topology.push_back({cpu, core, core / 2, core, core / 2});
+  }
+  return topology;
+}
+
+std::vector<int> AllCPUs(int n) {
+  std::vector<int> res;
+  for (int cpu = 0; cpu < n; ++cpu) {
+    res.push_back(cpu);
+  }
+  return res;
+}
+
+TEST(CPUAffinityTest, AvoidsSMTSiblings) {
+  EXPECT_THAT(PickIsolatedCPUs(TwoPackagesWithSMT(), AllCPUs(8), 8),
+              ElementsAre(0, 2, 1, 3));
+}
+
+TEST(CPUAffinityTest, SpreadsOverPackages) {
+  EXPECT_THAT(PickIsolatedCPUs(TwoPackagesWithSMT(), AllCPUs(8), 2),
+              ElementsAre(0, 2));
+}
+
+TEST(CPUAffinityTest, AvoidsSharedL2) {
+  // Pairs of cores share an L2 cache.
+  std::vector<CPUInfo::LogicalCPU> topology;
+  for (int cpu = 0; cpu < 8; ++cpu) {
+    topology.push_back({cpu, cpu, 0, cpu / 2, 0});
+  }
+  EXPECT_THAT(PickIsolatedCPUs(topology, AllCPUs(8), 8),
+              ElementsAre(0, 2, 4, 6));
+}
+
+TEST(CPUAffinityTest, OnlyUsesAllowedCPUs) {
+  EXPECT_THAT(PickIsolatedCPUs(TwoPackagesWithSMT(), {4, 5, 7}, 8),
+              ElementsAre(4, 7, 5));
+  EXPECT_TRUE(PickIsolatedCPUs(TwoPackagesWithSMT(), {}, 8).empty());
+}
+
+TEST(CPUAffinityTest, UnknownL2) {
+  std::vector<CPUInfo::LogicalCPU> topology;
+  for (int cpu = 0; cpu < 4; ++cpu) {
+    topology.push_back({cpu, cpu, 0, -1, -1});
+  }
+  EXPECT_THAT(PickIsolatedCPUs(topology, AllCPUs(4), 3), ElementsAre(0, 1, 2));
+}
+
+TEST(CPUAffinityTest, CompactFillsCoresFirst) {
+  EXPECT_THAT(
+      PickAffinityCPUs(kAffinityCompact, TwoPackagesWithSMT(), AllCPUs(8), 8),
+      ElementsAre(0, 4, 1, 5, 2, 6, 3, 7));
+  EXPECT_THAT(
+      PickAffinityCPUs(kAffinityCompact, TwoPackagesWithSMT(), AllCPUs(8), 3),
+      ElementsAre(0, 4, 1));
+}
+
+TEST(CPUAffinityTest, ScatterSpreadsOverPackagesFirst) {
+  EXPECT_THAT(
+      PickAffinityCPUs(kAffinityScatter, TwoPackagesWithSMT(), AllCPUs(8), 8),
+      ElementsAre(0, 2, 1, 3, 4, 6, 5, 7));
+}
+
+TEST(CPUAffinityTest, OneThreadPerPhysicalCore) {
+  EXPECT_THAT(PickAffinityCPUs(kAffinityPhysicalCore, TwoPackagesWithSMT(),
+                               AllCPUs(8), 8),
+              ElementsAre(0, 1, 2, 3));
+  // A core is still used if only its second sibling is allowed.
+  EXPECT_THAT(PickAffinityCPUs(kAffinityPhysicalCore, TwoPackagesWithSMT(),
+                               {1, 4, 5}, 8),
+              ElementsAre(1, 4));
+}
+
+TEST(CPUAffinityTest, OneThreadPerNumaNode) {
+  EXPECT_THAT(
+      PickAffinityCPUs(kAffinityNumaNode, TwoPackagesWithSMT(), AllCPUs(8), 8),
+      ElementsAre(0, 2));
+
+  // Without NUMA information every package counts as a node.
+  std::vector<CPUInfo::LogicalCPU> topology;
+  for (int cpu = 0; cpu < 4; ++cpu) {
+    topology.push_back({cpu, cpu, cpu / 2, -1, -1});
+  }
+  EXPECT_THAT(PickAffinityCPUs(kAffinityNumaNode, topology, AllCPUs(4), 8),
+              ElementsAre(0, 2));
+}
+
+TEST(CPUAffinityTest, AffinityWithoutTopology) {
+  EXPECT_THAT(PickAffinityCPUs(kAffinityCompact, {}, AllCPUs(4), 2),
+              ElementsAre(0, 1));
+  EXPECT_TRUE(PickAffinityCPUs(kAffinityNone, {}, AllCPUs(4), 2).empty());
+  EXPECT_TRUE(PickAffinityCPUs(kAffinityCompact, {}, {}, 2).empty());
+}
+
+TEST(CPUAffinityTest, PolicyNames) {
+  for (ThreadAffinityPolicy policy :
+       {kAffinityNone, kAffinityCompact, kAffinityScatter,
+        kAffinityPhysicalCore, kAffinityNumaNode}) {
+    ThreadAffinityPolicy parsed = kAffinityNone;
+    EXPECT_TRUE(
+        ParseThreadAffinityPolicy(ThreadAffinityPolicyName(policy), &parsed));
+    EXPECT_EQ(parsed, policy);
+  }
+  ThreadAffinityPolicy parsed = kAffinityCompact;
+  EXPECT_FALSE(ParseThreadAffinityPolicy("spread", &parsed));
+  EXPECT_EQ(parsed, kAffinityCompact);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,104 @@
+#undef NDEBUG
+
+#include <chrono>
+#include <thread>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/registration.h"
+#include "benchmark/state.h"
+#include "benchmark/utils.h"
+#include "output_test.h"
+
+namespace {
+
+void BM_LatencyRangeFor(benchmark::State& state) {
+  int x = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(++x);
+  }
+}
+BENCHMARK(BM_LatencyRangeFor)->RecordLatencyDistribution();
+
+ADD_CASES(TC_ConsoleOut,
+          {{"^BM_LatencyRangeFor %console_report latency_p50=%hrfloat "
+            "latency_p99=%hrfloat latency_p99.9=%hrfloat$"}});
+ADD_CASES(TC_JSONOut, {{"\"name\": \"BM_LatencyRangeFor\",$"},
+                       {"\"family_index\": 0,$", MR_Next},
+                       {"\"per_family_instance_index\": 0,$", MR_Next},
+                       {"\"run_name\": \"BM_LatencyRangeFor\",$", MR_Next},
+                       {"\"run_type\": \"iteration\",$", MR_Next},
+                       {"\"repetitions\": 1,$", MR_Next},
+                       {"\"repetition_index\": 0,$", MR_Next},
+                       {"\"threads\": 1,$", MR_Next},
+                       {"\"iterations\": %int,$", MR_Next},
+                       {"\"real_time\": %float,$", MR_Next},
+                       {"\"cpu_time\": %float,$", MR_Next},
+                       {"\"time_unit\": \"ns\",$", MR_Next},
+                       {"\"latency_p50\": %float,$", MR_Next},
+                       {"\"latency_p99\": %float,$", MR_Next},
+                       {"\"latency_p99.9\": %float$", MR_Next},
+                       {"}", MR_Next}});
+ADD_CASES(TC_CSVOut,
+          {{"^\"BM_LatencyRangeFor\",%csv_report,%float,%float,%float$"}});
+
+void CheckPercentilesAreOrdered(Results const& e) {
+  const double p50 = e.GetCounterAs<double>("latency_p50");
+  const double p99 = e.GetCounterAs<double>("latency_p99");
+  const double p999 = e.GetCounterAs<double>("latency_p99.9");
+  BM_CHECK_GT(p50, 0.0) << e.name;
+  BM_CHECK_LE(p50, p99) << e.name;
+  BM_CHECK_LE(p99, p999) << e.name;
+}
+CHECK_BENCHMARK_RESULTS("BM_LatencyRangeFor", &CheckPercentilesAreOrdered);
+
+// Every 100th iteration sleeps, so the tail is far above the median.
+void BM_LatencyKeepRunning(benchmark::State& state) {
+  int64_t i = 0;
+  while (state.KeepRunning()) {
+    if (++i % 100 == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  }
+}
+BENCHMARK(BM_LatencyKeepRunning)->Iterations(1000)->RecordLatencyDistribution();
+
+void CheckTailLatency(Results const& e) {
+  CheckPercentilesAreOrdered(e);
+  BM_CHECK_EQ(e.GetAs<int64_t>("iterations"), 1000) << e.name;
+  BM_CHECK_GE(e.GetCounterAs<double>("latency_p99.9"), 100e-6) << e.name;
+  BM_CHECK_LT(e.GetCounterAs<double>("latency_p50"), 100e-6) << e.name;
+}
+CHECK_BENCHMARK_RESULTS("BM_LatencyKeepRunning", &CheckTailLatency);
+
+// Paused time must not be attributed to the iteration.
+void BM_LatencyPaused(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(BM_LatencyPaused)->Iterations(50)->RecordLatencyDistribution();
+
+void CheckPausedLatency(Results const& e) {
+  CheckPercentilesAreOrdered(e);
+  BM_CHECK_LT(e.GetCounterAs<double>("latency_p50"), 100e-6) << e.name;
+}
+CHECK_BENCHMARK_RESULTS("BM_LatencyPaused", &CheckPausedLatency);
+
+void BM_LatencyBatch(benchmark::State& state) {
+  while (state.KeepRunningBatch(7)) {
+  }
+}
+BENCHMARK(BM_LatencyBatch)
+    ->Iterations(100)
+    ->RecordLatencyDistribution()
+    ->ThreadRange(1, 2);
+CHECK_BENCHMARK_RESULTS("BM_LatencyBatch", &CheckPercentilesAreOrdered);
+
+}  // end namespace
+
+int main(int argc, char* argv[]) {
+  benchmark::MaybeReenterWithoutASLR(argc, argv);
+  RunOutputTests(argc, argv);
+}
@@ -0,0 +1,94 @@
+//===---------------------------------------------------------------------===//
+// latency_histogram_gtest - Unit tests for src/latency_histogram.cc
+//===---------------------------------------------------------------------===//
+
+#include "../src/latency_histogram.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+  LatencyHistogram h;
+  EXPECT_TRUE(h.empty());
+  EXPECT_EQ(h.count(), 0);
+  EXPECT_DOUBLE_EQ(h.ValueAtPercentile(50.0), 0.0);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  LatencyHistogram h;
+  for (int64_t v = 1; v <= 10; ++v) {
+    h.Record(v);
+  }
+  EXPECT_EQ(h.count(), 10);
+  EXPECT_EQ(h.min(), 1);
+  EXPECT_EQ(h.max(), 10);
+  EXPECT_DOUBLE_EQ(h.ValueAtPercentile(0.0), 1.0);
+  EXPECT_DOUBLE_EQ(h.ValueAtPercentile(50.0), 5.0);
+  EXPECT_DOUBLE_EQ(h.ValueAtPercentile(90.0), 9.0);
+  EXPECT_DOUBLE_EQ(h.ValueAtPercentile(100.0), 10.0);
+}
+
+TEST(LatencyHistogramTest, LargeValuesHaveBoundedRelativeError) {
+  const double max_relative_error =
+      1.0 / static_cast<double>(LatencyHistogram::kSubBucketCount);
+  for (int64_t v : {int64_t{100}, int64_t{12345}, int64_t{987654321},
+                    int64_t{1} << 40, (int64_t{1} << 62) + 12345}) {
+    LatencyHistogram h;
+    // Record a neighbour too, so the reported value is not clamped to the
+    // observed min/max.
+    h.Record(v);
+    h.Record(v / 2);
+    h.Record(v + v / 2);
+    const double reported = h.ValueAtPercentile(50.0);
+    EXPECT_NEAR(reported, static_cast<double>(v),
+                static_cast<double>(v) * max_relative_error)
+        << "value " << v;
+  }
+}
+
+TEST(LatencyHistogramTest, WeightedRecordAndTail) {
+  LatencyHistogram h;
+  h.Record(10, 990);
+  h.Record(1000, 9);
+  h.Record(100000, 1);
+  EXPECT_EQ(h.count(), 1000);
+  EXPECT_DOUBLE_EQ(h.ValueAtPercentile(50.0), 10.0);
+  EXPECT_DOUBLE_EQ(h.ValueAtPercentile(99.0), 10.0);
+  EXPECT_NEAR(h.ValueAtPercentile(99.5), 1000.0, 1000.0 / 64);
+  EXPECT_DOUBLE_EQ(h.ValueAtPercentile(99.99), 100000.0);
+}
+
+TEST(LatencyHistogramTest, NegativeValuesAreClamped) {
+  LatencyHistogram h;
+  h.Record(-5);
+  EXPECT_EQ(h.min(), 0);
+  EXPECT_DOUBLE_EQ(h.ValueAtPercentile(100.0), 0.0);
+}
+
+TEST(LatencyHistogramTest, Merge) {
+  LatencyHistogram a;
+  LatencyHistogram b;
+  LatencyHistogram empty;
+  a.Record(1, 50);
+  b.Record(3, 50);
+  a.Merge(b);
+  a.Merge(empty);
+  EXPECT_EQ(a.count(), 100);
+  EXPECT_EQ(a.min(), 1);
+  EXPECT_EQ(a.max(), 3);
+  EXPECT_DOUBLE_EQ(a.ValueAtPercentile(50.0), 1.0);
+  EXPECT_DOUBLE_EQ(a.ValueAtPercentile(51.0), 3.0);
+
+  empty.Merge(a);
+  EXPECT_EQ(empty.count(), 100);
+  EXPECT_DOUBLE_EQ(empty.ValueAtPercentile(51.0), 3.0);
+
+  empty.Reset();
+  EXPECT_TRUE(empty.empty());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
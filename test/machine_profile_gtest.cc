@@ -0,0 +1,81 @@
+#include <string>
+#include <vector>
+
+#include "../src/json_reader.h"
+#include "../src/machine_profile.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+TEST(MachineProfileTest, ParsesValues) {
+  MachineProfile profile;
+  std::string error;
+  ASSERT_TRUE(profile.Parse(
+      R"({"triad_bandwidth": 1.5e10, "L1_latency": 1e-9})", &error))
+      << error;
+  ASSERT_EQ(profile.values().size(), 2u);
+  EXPECT_DOUBLE_EQ(profile.values().at("triad_bandwidth"), 1.5e10);
+  EXPECT_DOUBLE_EQ(profile.values().at("L1_latency"), 1e-9);
+}
+
+TEST(MachineProfileTest, RejectsNonNumbers) {
+  MachineProfile profile;
+  std::string error;
+  EXPECT_FALSE(profile.Parse(R"({"simd_flops": "fast"})", &error));
+  EXPECT_FALSE(profile.Parse("[1, 2]", &error));
+  EXPECT_FALSE(profile.Parse("{", &error));
+}
+
+TEST(MachineProfileTest, RoundTrips) {
+  MachineProfile profile;
+  profile.values()["scalar_flops"] = 4.5e9;
+  profile.values()["memory_latency"] = 9.87654321e-8;
+  MachineProfile parsed;
+  std::string error;
+  ASSERT_TRUE(parsed.Parse(profile.ToJson(), &error)) << error;
+  EXPECT_EQ(parsed.values(), profile.values());
+}
+
+TEST(CoreToCoreLatenciesTest, KeepsLowestOfBothDirections) {
+  CoreToCoreLatencies latencies({0, 2, 5});
+  latencies.Add(0, 2, 2e-7);
+  latencies.Add(2, 0, 1e-7);
+  latencies.Add(5, 2, 3e-7);
+  latencies.Add(5, 2, 4e-7);
+  latencies.Add(0, 7, 1e-7);
+  EXPECT_DOUBLE_EQ(latencies.Get(0, 2), 1e-7);
+  EXPECT_DOUBLE_EQ(latencies.Get(2, 0), 1e-7);
+  EXPECT_DOUBLE_EQ(latencies.Get(2, 5), 3e-7);
+  EXPECT_DOUBLE_EQ(latencies.Get(0, 5), 0.0);
+  EXPECT_DOUBLE_EQ(latencies.Get(0, 7), 0.0);
+}
+
+TEST(CoreToCoreLatenciesTest, WritesMatrixWithTopology) {
+  CoreToCoreLatencies latencies({0, 1});
+  latencies.Add(0, 1, 5e-8);
+  std::vector<CPUInfo::LogicalCPU> topology = {{1, 0, 0, 0, 0}};
+  const std::string json = latencies.ToJson(topology);
+
+  JsonValue document;
+  std::string error;
+  ASSERT_TRUE(ParseJson(json, &document, &error)) << error << "\n" << json;
+  const JsonValue* cpus = document.Find("cpus");
+  ASSERT_NE(cpus, nullptr);
+  ASSERT_EQ(cpus->array.size(), 2u);
+  EXPECT_EQ(cpus->array[0].Find("core"), nullptr);
+  ASSERT_NE(cpus->array[1].Find("core"), nullptr);
+  EXPECT_DOUBLE_EQ(cpus->array[1].Find("package")->number, 0.0);
+
+  const JsonValue* matrix = document.Find("round_trip_latency");
+  ASSERT_NE(matrix, nullptr);
+  ASSERT_EQ(matrix->array.size(), 2u);
+  EXPECT_EQ(matrix->array[0].array[0].type, JsonValue::kNull);
+  EXPECT_DOUBLE_EQ(matrix->array[0].array[1].number, 5e-8);
+  EXPECT_DOUBLE_EQ(matrix->array[1].array[0].number, 5e-8);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,48 @@
+//===---------------------------------------------------------------------===//
+// numa_gtest - Unit tests for src/numa.cc
+//===---------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "../src/numa.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+// Two nodes, each 10 away from itself and 20 from the other; node 1 is not
+// online.
+std::vector<std::vector<int>> TwoNodes() {
+  return {{10, -1, 20}, {-1, -1, -1}, {20, -1, 10}};
+}
+
+TEST(NumaTest, DistanceToLocalMemory) {
+  EXPECT_EQ(NumaDistanceToData(NumaPolicy::Local(), 0, {}, TwoNodes()), 10);
+  EXPECT_EQ(NumaDistanceToData(NumaPolicy::Local(), 2, {}, TwoNodes()), 10);
+}
+
+TEST(NumaTest, DistanceToBoundMemory) {
+  EXPECT_EQ(NumaDistanceToData(NumaPolicy::Node(2), 0, {}, TwoNodes()), 20);
+  EXPECT_EQ(NumaDistanceToData(NumaPolicy::Node(0), 0, {}, TwoNodes()), 10);
+  EXPECT_LT(NumaDistanceToData(NumaPolicy::Node(1), 0, {}, TwoNodes()), 0);
+  EXPECT_LT(NumaDistanceToData(NumaPolicy::Node(7), 0, {}, TwoNodes()), 0);
+}
+
+TEST(NumaTest, DistanceToInterleavedMemory) {
+  EXPECT_DOUBLE_EQ(
+      NumaDistanceToData(NumaPolicy::Interleave(), 0, {0, 2}, TwoNodes()),
+      15.0);
+  EXPECT_LT(NumaDistanceToData(NumaPolicy::Interleave(), 0, {}, TwoNodes()),
+            0);
+}
+
+TEST(NumaTest, UnknownDistances) {
+  EXPECT_LT(NumaDistanceToData(NumaPolicy(), 0, {}, TwoNodes()), 0);
+  EXPECT_LT(NumaDistanceToData(NumaPolicy::Local(), -1, {}, TwoNodes()), 0);
+  EXPECT_LT(NumaDistanceToData(NumaPolicy::Local(), 0, {}, {}), 0);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
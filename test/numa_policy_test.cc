@@ -0,0 +1,67 @@
+#undef NDEBUG
+
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/registration.h"
+#include "benchmark/state.h"
+#include "benchmark/sysinfo.h"
+#include "benchmark/utils.h"
+#include "output_test.h"
+
+namespace {
+
+std::vector<char>* data = nullptr;
+
+void Allocate(const benchmark::State&) {
+  data = new std::vector<char>(1 << 20, 1);
+}
+
+void Free(const benchmark::State&) {
+  delete data;
+  data = nullptr;
+}
+
+void BM_Memory(benchmark::State& state) {
+  for (auto _ : state) {
+    for (size_t i = 0; i < data->size(); i += 4096) {
+      benchmark::DoNotOptimize((*data)[i]);
+    }
+  }
+}
+// The CSV columns are taken from the first run, so the one with a placement
+// goes first.
+BENCHMARK(BM_Memory)
+    ->Name("BM_LocalMemory")
+    ->Setup(Allocate)
+    ->Teardown(Free)
+    ->MemoryPolicy(benchmark::NumaPolicy::Local())
+    ->Iterations(10);
+BENCHMARK(BM_Memory)
+    ->Name("BM_DefaultMemory")
+    ->Setup(Allocate)
+    ->Teardown(Free)
+    ->Iterations(10);
+
+// Local memory is at the smallest distance there is, if the distances are
+// known at all.
+void CheckLocalDistance(Results const& e) {
+  if (benchmark::CPUInfo::Get().numa_distances.empty()) {
+    return;
+  }
+  BM_CHECK_EQ(e.GetCounterAs<int>("numa_distance"), 10) << e.name;
+}
+CHECK_BENCHMARK_RESULTS("BM_LocalMemory", &CheckLocalDistance);
+
+void CheckNoDistance(Results const& e) {
+  const std::string* distance = e.Get("numa_distance");
+  BM_CHECK(distance == nullptr || distance->empty()) << e.name;
+}
+CHECK_BENCHMARK_RESULTS("BM_DefaultMemory", &CheckNoDistance);
+
+}  // end namespace
+
+int main(int argc, char* argv[]) {
+  benchmark::MaybeReenterWithoutASLR(argc, argv);
+  RunOutputTests(argc, argv);
+}
@@ -40,6 +40,7 @@ BENCHMARK(BM_basic)->MinTime(0.7);
 BENCHMARK(BM_basic)->MinWarmUpTime(0.8);
 BENCHMARK(BM_basic)->MinTime(0.1)->MinWarmUpTime(0.2);
 BENCHMARK(BM_basic)->UseRealTime();
+BENCHMARK(BM_basic)->UseCycleClock();
 BENCHMARK(BM_basic)->ThreadRange(2, 4);
 BENCHMARK(BM_basic)->ThreadPerCpu();
 BENCHMARK(BM_basic)->Repetitions(3);
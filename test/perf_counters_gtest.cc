@@ -360,6 +360,59 @@ TEST(PerfCountersTest, MultiThreaded) {
   EXPECT_THAT(Elapsed4Threads[1] / Elapsed2Threads[1], AllOf(Gt(0.1), Lt(10)));
 }
 
+TEST(PerfCountersTest, GroupNames) {
+  if (!HasRequiredPerfCounters({kGenericPerfEvent1, kGenericPerfEvent2})) {
+    GTEST_SKIP() << "Requested performance counters are not available.";
+  }
+  auto counters =
+      PerfCounters::Create({kGenericPerfEvent1, kGenericPerfEvent2});
+  std::vector<std::string> names;
+  for (const auto& group : counters.GroupNames()) {
+    EXPECT_FALSE(group.empty());
+    names.insert(names.end(), group.begin(), group.end());
+  }
+  EXPECT_THAT(names, ::testing::UnorderedElementsAre(kGenericPerfEvent1,
+                                                     kGenericPerfEvent2));
+}
+
+TEST(PerfCountersTest, TimeRunning) {
+  if (!HasRequiredPerfCounters({kGenericPerfEvent1})) {
+    GTEST_SKIP() << "Requested performance counters are not available.";
+  }
+  PerfCountersMeasurement counter({kGenericPerfEvent1});
+  std::vector<std::pair<std::string, double>> measurements;
+  EXPECT_TRUE(counter.Start());
+  do_work();
+  EXPECT_TRUE(counter.Stop(measurements));
+  EXPECT_GT(counter.time_enabled(), 0);
+  EXPECT_GT(counter.time_running(), 0);
+  EXPECT_LE(counter.time_running(), counter.time_enabled());
+}
+
+TEST(PerfCountersTest, RotatingGroups) {
+  PerfCountersMeasurement no_counters({});
+  no_counters.SplitIntoGroups();
+  EXPECT_EQ(no_counters.num_groups(), 1);
+
+  if (!HasRequiredPerfCounters({kGenericPerfEvent1, kGenericPerfEvent2})) {
+    GTEST_SKIP() << "Requested performance counters are not available.";
+  }
+  PerfCountersMeasurement counter({kGenericPerfEvent1, kGenericPerfEvent2});
+  counter.SplitIntoGroups();
+  std::set<std::string> names;
+  for (size_t group = 0; group < counter.num_groups(); ++group) {
+    counter.SelectGroup(group);
+    EXPECT_GT(counter.num_counters(), 0);
+    names.insert(counter.names().begin(), counter.names().end());
+    std::vector<std::pair<std::string, double>> measurements;
+    EXPECT_TRUE(counter.Start());
+    do_work();
+    EXPECT_TRUE(counter.Stop(measurements));
+  }
+  EXPECT_THAT(names, ::testing::UnorderedElementsAre(kGenericPerfEvent1,
+                                                     kGenericPerfEvent2));
+}
+
 TEST(PerfCountersTest, HardwareLimits) {
   // The test works (i.e. causes read to fail) for the assumptions
   // about hardware capabilities (i.e. small number (3-4) hardware
@@ -15,6 +15,7 @@
 namespace benchmark {
 
 BM_DECLARE_string(benchmark_perf_counters);
+BM_DECLARE_bool(benchmark_perf_counters_per_thread);
 
 }  // namespace benchmark
 namespace {
@@ -87,6 +88,21 @@ BENCHMARK(BM_WithPauseResume);
 
 ADD_CASES(TC_JSONOut, {{"\"name\": \"BM_WithPauseResume\",$"}});
 
+void BM_Threaded(benchmark::State& state) {
+  int n = 0;
+  for (auto _ : state) {
+    for (auto i = 0; i < kIters; ++i) {
+      n = 1 - n;
+      benchmark::DoNotOptimize(n);
+    }
+  }
+}
+
+BENCHMARK(BM_Threaded)->Threads(2)->Iterations(10);
+
+ADD_CASES(TC_JSONOut,
+          {{"\"name\": \"BM_Threaded/iterations:10/threads:2\",$"}});
+
 static void CheckSimple(Results const& e) {
   CHECK_COUNTER_VALUE(e, double, kGenericPerfEvent1, GT, 0);
 }
@@ -102,7 +118,22 @@ void SaveInstrCountWithResume(Results const& e) {
   withPauseResumeInstrCount = e.GetAs<double>(kGenericPerfEvent2);
 }
 
+// Every thread runs the same loop, so each of them, and the average over both,
+// must count about the instructions of one run of it.
+void CheckThreaded(Results const& e) {
+  const double total = e.GetAs<double>(kGenericPerfEvent2);
+  const double thread0 =
+      e.GetAs<double>(std::string(kGenericPerfEvent2) + "/thread:0");
+  const double thread1 =
+      e.GetAs<double>(std::string(kGenericPerfEvent2) + "/thread:1");
+  BM_CHECK_GT(thread0, kIters);
+  BM_CHECK_GT(thread1, kIters);
+  BM_CHECK_GT(total, 0.5 * thread0);
+  BM_CHECK_LT(total, 2 * thread0);
+}
+
 CHECK_BENCHMARK_RESULTS("BM_Simple", &CheckSimple);
+CHECK_BENCHMARK_RESULTS("BM_Threaded", &CheckThreaded);
 CHECK_BENCHMARK_RESULTS("BM_WithoutPauseResume", &SaveInstrCountWithoutResume);
 CHECK_BENCHMARK_RESULTS("BM_WithPauseResume", &SaveInstrCountWithResume);
 }  // end namespace
@@ -114,6 +145,7 @@ int main(int argc, char* argv[]) {
   }
   benchmark::FLAGS_benchmark_perf_counters =
       std::string(kGenericPerfEvent1) + "," + kGenericPerfEvent2;
+  benchmark::FLAGS_benchmark_perf_counters_per_thread = true;
   benchmark::internal::PerfCounters::Initialize();
   RunOutputTests(argc, argv);
 
@@ -0,0 +1,110 @@
+//===---------------------------------------------------------------------===//
+// perf_metrics_gtest - Unit tests for src/perf_metrics.cc
+//===---------------------------------------------------------------------===//
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../src/perf_metrics.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::UnorderedElementsAre;
+
+bool AllSupported(const std::string&) { return true; }
+
+TEST(PerfMetricsTest, SelectsEventsNotRequestedAlready) {
+  const PerfMetrics metrics = PerfMetrics::Create(
+      {"ipc", "branch_mpki", "ipc"}, {"CYCLES"}, AllSupported);
+  EXPECT_FALSE(metrics.empty());
+  EXPECT_THAT(metrics.events(), ElementsAre("INSTRUCTIONS", "BRANCH-MISSES"));
+}
+
+TEST(PerfMetricsTest, SkipsUnknownAndUnsupportedMetrics) {
+  // Only the generic events, as on a CPU without a top-down variant.
+  const PerfMetrics metrics = PerfMetrics::Create(
+      {"no_such_metric", "tma", "ipc"}, {}, [](const std::string& name) {
+        return name.find(':') == std::string::npos;
+      });
+  EXPECT_THAT(metrics.events(), ElementsAre("INSTRUCTIONS", "CYCLES"));
+
+  EXPECT_TRUE(PerfMetrics::Create({"all"}, {}, [](const std::string&) {
+                return false;
+              }).empty());
+}
+
+TEST(PerfMetricsTest, ComputesMetricsAndHidesTheirEvents) {
+  const PerfMetrics metrics =
+      PerfMetrics::Create({"ipc", "cache_mpki"}, {"CYCLES"}, AllSupported);
+  UserCounters counters;
+  counters["CYCLES"] = Counter(200);
+  counters["INSTRUCTIONS"] = Counter(500);
+  counters["CACHE-MISSES"] = Counter(2);
+  metrics.Compute(&counters);
+  EXPECT_DOUBLE_EQ(counters["IPC"].value, 2.5);
+  EXPECT_DOUBLE_EQ(counters["cache_MPKI"].value, 4.0);
+  // Requested by the user, so still reported.
+  EXPECT_EQ(counters.count("CYCLES"), 1u);
+  EXPECT_EQ(counters.count("INSTRUCTIONS"), 0u);
+  EXPECT_EQ(counters.count("CACHE-MISSES"), 0u);
+}
+
+TEST(PerfMetricsTest, TopDown) {
+  const PerfMetrics metrics = PerfMetrics::Create({"tma"}, {}, AllSupported);
+  UserCounters counters;
+  counters["UNHALTED_CORE_CYCLES"] = Counter(100);
+  counters["IDQ_UOPS_NOT_DELIVERED:CORE"] = Counter(40);
+  counters["UOPS_ISSUED:ANY"] = Counter(220);
+  counters["UOPS_RETIRED:RETIRE_SLOTS"] = Counter(200);
+  counters["INT_MISC:RECOVERY_CYCLES"] = Counter(5);
+  metrics.Compute(&counters);
+  // Out of 400 slots.
+  EXPECT_DOUBLE_EQ(counters["frontend_bound"].value, 0.1);
+  EXPECT_DOUBLE_EQ(counters["bad_speculation"].value, 0.1);
+  EXPECT_DOUBLE_EQ(counters["retiring"].value, 0.5);
+  EXPECT_DOUBLE_EQ(counters["backend_bound"].value, 0.3);
+  std::set<std::string> names;
+  for (const auto& counter : counters) {
+    names.insert(counter.first);
+  }
+  EXPECT_THAT(names, UnorderedElementsAre("frontend_bound", "bad_speculation",
+                                          "retiring", "backend_bound"));
+}
+
+TEST(PerfMetricsTest, Frequency) {
+  const PerfMetrics metrics =
+      PerfMetrics::Create({"frequency", "cycles"}, {}, AllSupported);
+  EXPECT_THAT(metrics.events(), ElementsAre("CYCLES"));
+  UserCounters counters;
+  counters["CYCLES"] = Counter(3000);
+  metrics.Compute(&counters, 1e-6);
+  EXPECT_DOUBLE_EQ(counters["cpu_frequency"].value, 3e9);
+  EXPECT_DOUBLE_EQ(counters["cycles_per_iteration"].value, 3000);
+  EXPECT_EQ(counters.count("CYCLES"), 0u);
+
+  // Without the CPU time, only the cycles are known.
+  counters.clear();
+  counters["CYCLES"] = Counter(3000);
+  metrics.Compute(&counters);
+  EXPECT_EQ(counters.count("cpu_frequency"), 0u);
+  EXPECT_EQ(counters.count("cycles_per_iteration"), 1u);
+}
+
+TEST(PerfMetricsTest, SkipsMetricsMissingEvents) {
+  const PerfMetrics metrics = PerfMetrics::Create({"ipc"}, {}, AllSupported);
+  UserCounters counters;
+  counters["CYCLES"] = Counter(200);
+  metrics.Compute(&counters);
+  EXPECT_THAT(counters, IsEmpty());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,95 @@
+//===---------------------------------------------------------------------===//
+// process_isolation_gtest - Unit tests for src/process_isolation.cc
+//===---------------------------------------------------------------------===//
+
+#include <string>
+
+#include "../src/process_isolation.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+BenchmarkReporter::Run MakeRun() {
+  BenchmarkReporter::Run run;
+  run.family_index = 3;
+  run.per_family_instance_index = 1;
+  run.report_label = "label";
+  run.iterations = 12345;
+  run.threads = 2;
+  run.repetition_index = 1;
+  run.repetitions = 4;
+  run.time_unit = kMicrosecond;
+  run.real_accumulated_time = 1.5;
+  run.cpu_accumulated_time = 2.5;
+  run.complexity = oNLogN;
+  run.complexity_n = 77;
+  run.counters["foo"] = Counter(42.0, Counter::kIsRate, Counter::kIs1024);
+  run.counters["bar"] = Counter(-1.0);
+  run.memory_result.num_allocs = 10;
+  run.memory_result.max_bytes_used = 2048;
+  run.memory_result.memory_iterations = 16;
+  run.allocs_per_iter = 0.625;
+  return run;
+}
+
+TEST(ProcessIsolationTest, RoundTrip) {
+  std::string data;
+  BenchmarkReporter::Run skipped;
+  skipped.skipped = SkippedWithError;
+  skipped.skip_message = "oops";
+  EncodeRun(MakeRun(), &data);
+  EncodeRun(skipped, &data);
+
+  const char* pos = data.data();
+  const char* end = data.data() + data.size();
+  BenchmarkReporter::Run run;
+  ASSERT_TRUE(DecodeRun(&pos, end, &run));
+  const BenchmarkReporter::Run expected = MakeRun();
+  EXPECT_EQ(run.family_index, expected.family_index);
+  EXPECT_EQ(run.per_family_instance_index, expected.per_family_instance_index);
+  EXPECT_EQ(run.report_label, expected.report_label);
+  EXPECT_EQ(run.skipped, NotSkipped);
+  EXPECT_EQ(run.iterations, expected.iterations);
+  EXPECT_EQ(run.threads, expected.threads);
+  EXPECT_EQ(run.repetition_index, expected.repetition_index);
+  EXPECT_EQ(run.repetitions, expected.repetitions);
+  EXPECT_EQ(run.time_unit, expected.time_unit);
+  EXPECT_DOUBLE_EQ(run.real_accumulated_time, expected.real_accumulated_time);
+  EXPECT_DOUBLE_EQ(run.cpu_accumulated_time, expected.cpu_accumulated_time);
+  EXPECT_EQ(run.complexity, expected.complexity);
+  EXPECT_EQ(run.complexity_n, expected.complexity_n);
+  ASSERT_EQ(run.counters.size(), 2u);
+  EXPECT_DOUBLE_EQ(run.counters["foo"].value, 42.0);
+  EXPECT_EQ(run.counters["foo"].flags, Counter::kIsRate);
+  EXPECT_EQ(run.counters["foo"].oneK, Counter::kIs1024);
+  EXPECT_DOUBLE_EQ(run.counters["bar"].value, -1.0);
+  EXPECT_EQ(run.memory_result.num_allocs, 10);
+  EXPECT_EQ(run.memory_result.max_bytes_used, 2048);
+  EXPECT_EQ(run.memory_result.total_allocated_bytes,
+            MemoryManager::TombstoneValue);
+  EXPECT_EQ(run.memory_result.memory_iterations, 16);
+  EXPECT_DOUBLE_EQ(run.allocs_per_iter, 0.625);
+
+  ASSERT_TRUE(DecodeRun(&pos, end, &run));
+  EXPECT_EQ(run.skipped, SkippedWithError);
+  EXPECT_EQ(run.skip_message, "oops");
+  EXPECT_TRUE(run.counters.empty());
+  EXPECT_EQ(pos, end);
+}
+
+TEST(ProcessIsolationTest, RejectsTruncatedInput) {
+  std::string data;
+  EncodeRun(MakeRun(), &data);
+  for (size_t size = 0; size < data.size(); ++size) {
+    const char* pos = data.data();
+    BenchmarkReporter::Run run;
+    EXPECT_FALSE(DecodeRun(&pos, data.data() + size, &run)) << size;
+    EXPECT_EQ(pos, data.data());
+  }
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,88 @@
+#undef NDEBUG
+
+#include <cstdlib>
+#include <string>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/registration.h"
+#include "benchmark/state.h"
+#include "benchmark/utils.h"
+#include "output_test.h"
+
+namespace {
+
+// Each instance runs in a fresh process, so it never sees the runs of the
+// instances before it.
+int num_runs = 0;
+
+void BM_FreshState(benchmark::State& state) {
+  ++num_runs;
+  for (auto _ : state) {
+  }
+  state.SetLabel("runs_seen=" + std::to_string(num_runs));
+}
+BENCHMARK(BM_FreshState)->Arg(1)->Arg(2)->Iterations(1);
+
+ADD_CASES(TC_ConsoleOut, {{"^BM_FreshState/1/iterations:1 %console_report "
+                           "runs_seen=1$"},
+                          {"^BM_FreshState/2/iterations:1 %console_report "
+                           "runs_seen=1$"}});
+
+// Aggregates are still computed from the repetitions of the child.
+void BM_Repeated(benchmark::State& state) {
+  for (auto _ : state) {
+  }
+}
+BENCHMARK(BM_Repeated)->Repetitions(2)->Iterations(3);
+
+ADD_CASES(TC_JSONOut,
+          {{"\"name\": \"BM_Repeated/iterations:3/repeats:2\",$"},
+           {"\"repetition_index\": 0,$"},
+           {"\"name\": \"BM_Repeated/iterations:3/repeats:2\",$"},
+           {"\"repetition_index\": 1,$"},
+           {"\"name\": \"BM_Repeated/iterations:3/repeats:2_mean\",$"},
+           {"\"iterations\": 2,$"}});
+
+// A benchmark taking its process down is reported as an error.
+void BM_Exits(benchmark::State& state) {
+  for (auto _ : state) {
+    std::_Exit(3);
+  }
+}
+BENCHMARK(BM_Exits)->Iterations(1);
+
+ADD_CASES(TC_ConsoleOut,
+          {{"^BM_Exits/iterations:1[ ]+ERROR OCCURRED: 'benchmark process "
+            "exited with status 3'$"}});
+
+// The repetitions before the one taking the process down are kept.
+int num_late_exit_runs = 0;
+
+void BM_ExitsLate(benchmark::State& state) {
+  const bool exit = ++num_late_exit_runs == 3;
+  for (auto _ : state) {
+    if (exit) {
+      std::_Exit(3);
+    }
+  }
+}
+BENCHMARK(BM_ExitsLate)->Repetitions(3)->Iterations(1);
+
+ADD_CASES(TC_ConsoleOut,
+          {{"^BM_ExitsLate/iterations:1/repeats:3 %console_report$"},
+           {"^BM_ExitsLate/iterations:1/repeats:3 %console_report$"},
+           {"^BM_ExitsLate/iterations:1/repeats:3[ ]+ERROR OCCURRED: "
+            "'benchmark process exited with status 3'$"}});
+
+// Benchmarks after it are unaffected.
+BENCHMARK(BM_FreshState)->Name("BM_FreshStateAfterExit")->Iterations(1);
+
+ADD_CASES(TC_ConsoleOut, {{"^BM_FreshStateAfterExit/iterations:1 "
+                           "%console_report runs_seen=1$"}});
+
+}  // end namespace
+
+int main(int argc, char* argv[]) {
+  benchmark::MaybeReenterWithoutASLR(argc, argv);
+  RunOutputTests(argc, argv);
+}
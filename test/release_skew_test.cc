@@ -0,0 +1,38 @@
+#undef NDEBUG
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/registration.h"
+#include "benchmark/state.h"
+#include "benchmark/utils.h"
+#include "output_test.h"
+
+namespace {
+
+void BM_ReleaseSkew(benchmark::State& state) {
+  for (auto _ : state) {
+  }
+}
+// The CSV columns are taken from the first run, so the multi-threaded one
+// goes first.
+BENCHMARK(BM_ReleaseSkew)->Threads(2)->Threads(1)->Iterations(100);
+
+// Single-threaded runs have no skew to report.
+ADD_CASES(TC_ConsoleOut,
+          {{"^BM_ReleaseSkew/iterations:100/threads:2 %console_report "
+            "release_skew=%hrfloat$"},
+           {"^BM_ReleaseSkew/iterations:100/threads:1 %console_report$"}});
+
+void CheckReleaseSkew(Results const& e) {
+  BM_CHECK_GE(e.GetCounterAs<double>("release_skew"), 0.0) << e.name;
+  // Even on a loaded machine, the threads start within a second.
+  BM_CHECK_LT(e.GetCounterAs<double>("release_skew"), 1.0) << e.name;
+}
+CHECK_BENCHMARK_RESULTS("BM_ReleaseSkew/iterations:100/threads:2",
+                        &CheckReleaseSkew);
+
+}  // end namespace
+
+int main(int argc, char* argv[]) {
+  benchmark::MaybeReenterWithoutASLR(argc, argv);
+  RunOutputTests(argc, argv);
+}
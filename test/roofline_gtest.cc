@@ -0,0 +1,66 @@
+#include <map>
+#include <string>
+
+#include "../src/roofline.h"
+#include "benchmark/benchmark.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+TEST(RooflineTest, EmptyWithoutCeilings) {
+  EXPECT_TRUE(Roofline::Create(0, 0, {}).empty());
+  EXPECT_FALSE(Roofline::Create(1e10, 0, {}).empty());
+  EXPECT_FALSE(Roofline::Create(0, 0, {{"simd_flops", 1e10}}).empty());
+}
+
+TEST(RooflineTest, ComputesPercentages) {
+  const Roofline roofline = Roofline::Create(1e10, 1e11, {});
+  UserCounters counters;
+  counters["bytes_per_second"] = Counter(5e9);
+  counters["flops_per_second"] = Counter(1e10);
+  roofline.Compute(1, &counters);
+  EXPECT_DOUBLE_EQ(counters.at("arithmetic_intensity").value, 2.0);
+  EXPECT_DOUBLE_EQ(counters.at("memory_roof_pct").value, 50.0);
+  EXPECT_DOUBLE_EQ(counters.at("compute_roof_pct").value, 10.0);
+}
+
+TEST(RooflineTest, FlagsTakePrecedenceOverProfile) {
+  const Roofline roofline = Roofline::Create(
+      2e10, 0, {{"triad_bandwidth", 1e10}, {"simd_flops", 4e10}});
+  UserCounters counters;
+  counters["bytes_per_second"] = Counter(1e10);
+  counters["flops_per_second"] = Counter(1e10);
+  roofline.Compute(1, &counters);
+  EXPECT_DOUBLE_EQ(counters.at("memory_roof_pct").value, 50.0);
+  EXPECT_DOUBLE_EQ(counters.at("compute_roof_pct").value, 25.0);
+}
+
+TEST(RooflineTest, UsesAllCpusBandwidthForThreads) {
+  const Roofline roofline = Roofline::Create(
+      0, 0, {{"triad_bandwidth", 1e10}, {"triad_bandwidth_all_cpus", 4e10}});
+  UserCounters counters;
+  counters["bytes_per_second"] = Counter(2e10);
+  roofline.Compute(2, &counters);
+  EXPECT_DOUBLE_EQ(counters.at("memory_roof_pct").value, 50.0);
+  EXPECT_EQ(counters.count("compute_roof_pct"), 0u);
+  EXPECT_EQ(counters.count("arithmetic_intensity"), 0u);
+}
+
+TEST(RooflineTest, ReportsBound) {
+  BenchmarkReporter::Run run;
+  EXPECT_EQ(run.roofline_bound(), "");
+  run.counters["memory_roof_pct"] = Counter(80);
+  run.counters["compute_roof_pct"] = Counter(20);
+  EXPECT_EQ(run.roofline_bound(), "memory");
+  run.counters["compute_roof_pct"] = Counter(90);
+  EXPECT_EQ(run.roofline_bound(), "compute");
+  run.run_type = BenchmarkReporter::Run::RT_Aggregate;
+  run.aggregate_name = "stddev";
+  EXPECT_EQ(run.roofline_bound(), "");
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,78 @@
+//===---------------------------------------------------------------------===//
+// sampling_profiler_gtest - Unit tests for src/sampling_profiler.cc
+//===---------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../src/sampling_profiler.h"
+#include "../src/timers.h"
+#include "benchmark/utils.h"
+#include "gtest/gtest.h"
+
+// Not static, so that it has a symbol even without a symbol table.
+BENCHMARK_DONT_OPTIMIZE void SamplingProfilerTestSpin(double seconds) {
+  const double start = benchmark::ThreadCPUUsage();
+  int n = 0;
+  while (benchmark::ThreadCPUUsage() - start < seconds) {
+    for (int i = 0; i < 1000; ++i) {
+      benchmark::DoNotOptimize(n += i);
+    }
+  }
+}
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+TEST(SymbolizeAddressTest, FunctionName) {
+  const uintptr_t address =
+      reinterpret_cast<uintptr_t>(&SamplingProfilerTestSpin);
+  if (!SamplingProfiler::kSupported) {
+    EXPECT_EQ(SymbolizeAddress(address), "[unknown]");
+    return;
+  }
+  EXPECT_EQ(SymbolizeAddress(address), "SamplingProfilerTestSpin(double)");
+  EXPECT_EQ(SymbolizeAddress(address + 1), "SamplingProfilerTestSpin(double)");
+  EXPECT_EQ(SymbolizeAddress(0), "[unknown]");
+}
+
+TEST(SamplingProfilerTest, SamplesTheTimedRegion) {
+  SamplingProfiler profiler(997);
+  if (!profiler.ok()) {
+    GTEST_SKIP() << "Sampling is not available.";
+  }
+  // Not sampled.
+  SamplingProfilerTestSpin(0.05);
+  EXPECT_TRUE(profiler.stacks().empty());
+
+  profiler.AfterSetupStart();
+  SamplingProfilerTestSpin(0.1);
+  profiler.BeforeTeardownStop();
+  uint64_t num_samples = 0;
+  for (const auto& stack : profiler.stacks()) {
+    EXPECT_FALSE(stack.first.empty());
+    num_samples += stack.second;
+  }
+  // About 100, but the machine may be busy.
+  EXPECT_GT(num_samples, 10u);
+  EXPECT_EQ(profiler.num_lost(), 0u);
+
+  const std::string path =
+      ::testing::TempDir() + "sampling_profiler_gtest.folded";
+  std::string error;
+  ASSERT_TRUE(profiler.WriteFolded(path, &error)) << error;
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  std::remove(path.c_str());
+  EXPECT_NE(contents.str().find("SamplingProfilerTestSpin(double) "),
+            std::string::npos)
+      << contents.str();
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
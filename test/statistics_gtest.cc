@@ -2,6 +2,9 @@
 // statistics_test - Unit tests for src/statistics.cc
 //===---------------------------------------------------------------------===//
 
+#include <limits>
+#include <vector>
+
 #include "../src/statistics.h"
 #include "gtest/gtest.h"
 
@@ -32,4 +35,22 @@ TEST(StatisticsTest, CV) {
               0.32888184094918121, 1e-15);
 }
 
+TEST(StatisticsTest, MeanRelativeError) {
+  EXPECT_DOUBLE_EQ(benchmark::StatisticsMeanRelativeError({42}),
+                   std::numeric_limits<double>::infinity());
+  EXPECT_DOUBLE_EQ(benchmark::StatisticsMeanRelativeError({0, 0, 0}),
+                   std::numeric_limits<double>::infinity());
+  EXPECT_DOUBLE_EQ(benchmark::StatisticsMeanRelativeError({7, 7, 7, 7}), 0.0);
+  // mean 2, stddev 1, n 3: 4.303 * 1 / sqrt(3) / 2
+  ASSERT_NEAR(benchmark::StatisticsMeanRelativeError({1, 2, 3}),
+              1.24216910416148, 1e-12);
+  // Past the end of the t table the normal quantile is used.
+  std::vector<double> many(100, 1.0);
+  many[0] = 0.0;
+  many[1] = 2.0;
+  const double stddev = benchmark::StatisticsStdDev(many);
+  ASSERT_NEAR(benchmark::StatisticsMeanRelativeError(many),
+              1.96 * stddev / 10.0, 1e-12);
+}
+
 }  // end namespace
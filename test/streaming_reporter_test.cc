@@ -0,0 +1,83 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/registration.h"
+#include "benchmark/reporter.h"
+#include "benchmark/state.h"
+#include "benchmark/utils.h"
+
+// Tests that every repetition reaches the reporter as soon as it is done,
+// before the next repetition runs, and that the NDJSON reporter writes one
+// record per line.
+
+namespace {
+
+int repetitions_started = 0;
+
+void BM_Repeated(benchmark::State& state) {
+  ++repetitions_started;
+  for (auto _ : state) {
+  }
+}
+BENCHMARK(BM_Repeated)->Repetitions(3)->Iterations(10);
+
+class TestReporter : public benchmark::ConsoleReporter {
+ public:
+  void ReportRepetition(const Run& run) override {
+    // Nothing of the next repetition may have run yet.
+    assert(run.repetition_index + 1 == repetitions_started);
+    assert(run.run_type == Run::RT_Iteration);
+    assert(runs_reported == 0);
+    ++repetitions_streamed;
+  }
+
+  void ReportRuns(const std::vector<Run>& report) override {
+    // All repetitions were streamed before the runs are reported.
+    assert(repetitions_streamed == 3);
+    runs_reported += static_cast<int>(report.size());
+    ConsoleReporter::ReportRuns(report);
+  }
+
+  int repetitions_streamed = 0;
+  int runs_reported = 0;
+};
+
+}  // end namespace
+
+int main(int argc, char** argv) {
+  benchmark::MaybeReenterWithoutASLR(argc, argv);
+  benchmark::Initialize(&argc, argv);
+
+  TestReporter test_reporter;
+  assert(benchmark::RunSpecifiedBenchmarks(&test_reporter) == 1);
+  assert(test_reporter.repetitions_streamed == 3);
+  // The repetitions, then the mean, median, stddev and cv.
+  assert(test_reporter.runs_reported == 3 + 4);
+
+  std::stringstream out;
+  benchmark::NDJSONReporter ndjson_reporter;
+  ndjson_reporter.SetOutputStream(&out);
+  repetitions_started = 0;
+  assert(benchmark::RunSpecifiedBenchmarks(&ndjson_reporter) == 1);
+
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(out, line);) {
+    assert(line.front() == '{' && line.back() == '}');
+    lines.push_back(line);
+  }
+  // The context, three repetitions and four aggregates, each exactly once.
+  assert(lines.size() == 1 + 3 + 4);
+  assert(lines[0].find("{\"type\": \"context\", \"date\": ") == 0);
+  for (size_t i = 1; i < lines.size(); ++i) {
+    assert(lines[i].find("{\"type\": \"run\", \"name\": \"BM_Repeated") == 0);
+    const bool aggregate =
+        lines[i].find("\"run_type\": \"aggregate\"") != std::string::npos;
+    assert(aggregate == (i > 3));
+  }
+  return 0;
+}
@@ -0,0 +1,54 @@
+#undef NDEBUG
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/registration.h"
+#include "benchmark/state.h"
+#include "benchmark/utils.h"
+#include "output_test.h"
+
+namespace {
+
+// Returns how many CPUs the calling thread may run on, or 1 where this cannot
+// be queried.
+int NumAllowedCPUs() {
+#if defined(__linux__)
+  cpu_set_t affinity;
+  CPU_ZERO(&affinity);
+  if (sched_getaffinity(0, sizeof(affinity), &affinity) == 0) {
+    return CPU_COUNT(&affinity);
+  }
+#endif
+  return 1;
+}
+
+// Picks up its policy from --benchmark_affinity.
+void BM_Pinned(benchmark::State& state) {
+  for (auto _ : state) {
+  }
+  state.counters["allowed_cpus"] = benchmark::Counter(
+      NumAllowedCPUs(), benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(BM_Pinned)->Threads(1)->Threads(2)->Iterations(10);
+
+void CheckPinned(Results const& e) {
+  BM_CHECK_EQ(e.GetCounterAs<int>("allowed_cpus"), 1) << e.name;
+}
+CHECK_BENCHMARK_RESULTS("BM_Pinned", &CheckPinned);
+
+#if defined(__linux__)
+ADD_CASES(TC_JSONOut,
+          {{"\"thread_affinity/compact/threads:1\": \"[0-9]+\",$"},
+           {"\"thread_affinity/compact/threads:2\": \"[0-9]+(,[0-9]+)?\"$",
+            MR_Next}});
+#endif
+
+}  // end namespace
+
+int main(int argc, char* argv[]) {
+  benchmark::MaybeReenterWithoutASLR(argc, argv);
+  RunOutputTests(argc, argv);
+}
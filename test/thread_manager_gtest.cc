@@ -0,0 +1,82 @@
+//===---------------------------------------------------------------------===//
+// thread_manager_gtest - Unit tests for src/thread_manager.cc
+//===---------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/thread_manager.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+TEST(ThreadManagerTest, SlotsDoNotShareCacheLines) {
+  ThreadManager manager(2);
+  const char* first =
+      reinterpret_cast<const char*>(&manager.GetThreadResult(0));
+  const char* second =
+      reinterpret_cast<const char*>(&manager.GetThreadResult(1));
+  EXPECT_GE(static_cast<size_t>(second - first), kCacheLineSize);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % kCacheLineSize, 0u);
+}
+
+TEST(ThreadManagerTest, ReducesAllThreads) {
+  constexpr int kNumThreads = 8;
+  ThreadManager manager(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&manager, t]() {
+      ThreadManager::Result& result = manager.GetThreadResult(t);
+      result.iterations = 10;
+      result.real_time_used = 0.5;
+      result.cpu_time_used = 0.25;
+      result.complexity_n = t;
+      result.counters["foo"] = Counter(1.0);
+      if (t % 2 == 1) {
+        result.counters["odd"] = Counter(static_cast<double>(t));
+      }
+      manager.NotifyThreadComplete();
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  const ThreadManager::Result results = manager.GetResults();
+  EXPECT_EQ(results.iterations, 10 * kNumThreads);
+  EXPECT_DOUBLE_EQ(results.real_time_used, 0.5 * kNumThreads);
+  EXPECT_DOUBLE_EQ(results.cpu_time_used, 0.25 * kNumThreads);
+  EXPECT_EQ(results.complexity_n, 28);
+  EXPECT_DOUBLE_EQ(results.counters.at("foo").value, kNumThreads);
+  EXPECT_DOUBLE_EQ(results.counters.at("odd").value, 1 + 3 + 5 + 7);
+  EXPECT_EQ(results.skipped_, NotSkipped);
+}
+
+TEST(ThreadManagerTest, FirstSkipWins) {
+  ThreadManager manager(2);
+  manager.Skip(SkippedWithError, "first");
+  manager.Skip(SkippedWithMessage, "second");
+  const ThreadManager::Result results = manager.GetResults();
+  EXPECT_EQ(results.skipped_, SkippedWithError);
+  EXPECT_EQ(results.skip_message_, "first");
+}
+
+TEST(ThreadManagerTest, LabelOfLowestThreadWins) {
+  ThreadManager manager(3);
+  manager.SetLabel(2, "two");
+  manager.SetLabel(1, "one");
+  EXPECT_EQ(manager.GetResults().report_label_, "one");
+
+  ThreadManager cleared(2);
+  cleared.SetLabel(0, "");
+  cleared.SetLabel(1, "one");
+  EXPECT_EQ(cleared.GetResults().report_label_, "");
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
@@ -0,0 +1,87 @@
+//===---------------------------------------------------------------------===//
+// thread_pool_gtest - Unit tests for src/thread_pool.cc
+//===---------------------------------------------------------------------===//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "../src/cpu_affinity.h"
+#include "../src/thread_pool.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+TEST(ThreadPoolTest, RunsEveryThreadIndexOnce) {
+  ThreadPool pool;
+  for (int num_threads : {1, 4, 2, 8}) {
+    std::vector<std::atomic<int>> calls(static_cast<size_t>(num_threads));
+    pool.Run(num_threads,
+             [&](int i) { calls[static_cast<size_t>(i)].fetch_add(1); });
+    for (int i = 0; i < num_threads; ++i) {
+      EXPECT_EQ(calls[static_cast<size_t>(i)].load(), 1)
+          << "thread " << i << " of " << num_threads;
+    }
+  }
+  EXPECT_EQ(pool.NumWorkers(), 7u);
+}
+
+TEST(ThreadPoolTest, FirstThreadRunsOnCaller) {
+  ThreadPool pool;
+  std::thread::id first;
+  pool.Run(3, [&](int i) {
+    if (i == 0) {
+      first = std::this_thread::get_id();
+    }
+  });
+  EXPECT_EQ(first, std::this_thread::get_id());
+}
+
+TEST(ThreadPoolTest, ReusesWorkers) {
+  ThreadPool pool;
+  std::vector<std::thread::id> before(4);
+  std::vector<std::thread::id> after(4);
+  pool.Run(4, [&](int i) {
+    before[static_cast<size_t>(i)] = std::this_thread::get_id();
+  });
+  pool.Run(4, [&](int i) {
+    after[static_cast<size_t>(i)] = std::this_thread::get_id();
+  });
+  EXPECT_EQ(before, after);
+  EXPECT_EQ(pool.NumWorkers(), 3u);
+}
+
+TEST(ThreadPoolTest, PinnedRunRestoresCallerAffinity) {
+  const std::vector<int> allowed = GetAllowedCPUs();
+  if (allowed.empty()) {
+    GTEST_SKIP() << "thread affinity is not supported";
+  }
+  ThreadPool pool;
+  std::vector<std::vector<int>> affinity(3);
+  pool.Run(
+      3,
+      [&](int i) { affinity[static_cast<size_t>(i)] = GetAllowedCPUs(); },
+      {allowed.front()});
+  for (const auto& cpus : affinity) {
+    EXPECT_EQ(cpus, std::vector<int>{allowed.front()});
+  }
+  EXPECT_EQ(GetAllowedCPUs(), allowed);
+
+  // Unpinned runs go back to the affinity the workers started with.
+  pool.Run(3, [&](int i) {
+    affinity[static_cast<size_t>(i)] = GetAllowedCPUs();
+  });
+  for (const auto& cpus : affinity) {
+    EXPECT_EQ(cpus, allowed);
+  }
+}
+
+TEST(ThreadPoolTest, SharedPoolIsStable) {
+  EXPECT_EQ(&ThreadPool::Get(), &ThreadPool::Get());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
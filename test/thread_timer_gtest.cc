@@ -0,0 +1,78 @@
+//===---------------------------------------------------------------------===//
+// thread_timer_gtest - Unit tests for the cycle clock mode of ThreadTimer
+//===---------------------------------------------------------------------===//
+
+#include <cstdint>
+
+#include "../src/thread_timer.h"
+#include "../src/timers.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+TEST(CycleClockCalibrationTest, IsPlausible) {
+  const CycleClockCalibration& calibration = GetCycleClockCalibration();
+  EXPECT_GT(calibration.seconds_per_cycle, 0.0);
+  // Faster than 1 Hz and slower than 1 THz.
+  EXPECT_LT(calibration.seconds_per_cycle, 1.0);
+  EXPECT_GT(calibration.seconds_per_cycle, 1e-12);
+  EXPECT_GE(calibration.overhead_cycles, 0);
+  // Same measurement every time.
+  EXPECT_EQ(&GetCycleClockCalibration(), &calibration);
+}
+
+TEST(ThreadTimerTest, CycleClockMeasuresElapsedTime) {
+  ThreadTimer timer = ThreadTimer::Create();
+  timer.UseCycleClock();
+  timer.StartTimer();
+  const double start = ChronoClockNow();
+  while (ChronoClockNow() - start < 0.02) {
+  }
+  timer.StopTimer();
+  EXPECT_GT(timer.real_time_used(), 0.01);
+  EXPECT_LT(timer.real_time_used(), 1.0);
+  // The CPU time is the same measurement.
+  EXPECT_DOUBLE_EQ(timer.cpu_time_used(), timer.real_time_used());
+}
+
+// A cycle clock that advances by `fake_cycles_per_read` on every reading.
+int64_t fake_cycles = 0;
+int64_t fake_cycles_per_read = 0;
+
+int64_t ReadFakeCycles() { return fake_cycles += fake_cycles_per_read; }
+
+TEST(ThreadTimerTest, CycleClockSubtractsItsOverhead) {
+  CycleClockCalibration calibration;
+  calibration.seconds_per_cycle = 0.5;
+  calibration.overhead_cycles = 3;
+  fake_cycles_per_read = 10;
+
+  ThreadTimer timer = ThreadTimer::Create();
+  timer.UseCycleClock(calibration, &ReadFakeCycles);
+  for (int i = 0; i < 4; ++i) {
+    timer.StartTimer();
+    timer.StopTimer();
+  }
+  // Every interval is one reading, i.e. 10 cycles, of which 3 are overhead.
+  EXPECT_DOUBLE_EQ(timer.real_time_used(), 4 * (10 - 3) * 0.5);
+  EXPECT_DOUBLE_EQ(timer.cpu_time_used(), timer.real_time_used());
+}
+
+TEST(ThreadTimerTest, CycleClockNeverGoesBackwards) {
+  CycleClockCalibration calibration;
+  calibration.seconds_per_cycle = 1.0;
+  calibration.overhead_cycles = 15;
+  fake_cycles_per_read = 10;
+
+  ThreadTimer timer = ThreadTimer::Create();
+  timer.UseCycleClock(calibration, &ReadFakeCycles);
+  timer.StartTimer();
+  timer.StopTimer();
+  EXPECT_DOUBLE_EQ(timer.real_time_used(), 0.0);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
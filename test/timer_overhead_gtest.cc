@@ -0,0 +1,74 @@
+//===---------------------------------------------------------------------===//
+// timer_overhead_gtest - Unit tests for src/timer_overhead.cc
+//===---------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "../src/benchmark_api_internal.h"
+#include "../src/timer_overhead.h"
+#include "benchmark/state.h"
+#include "gtest/gtest.h"
+
+namespace benchmark {
+namespace internal {
+namespace {
+
+void BM_Nothing(State& state) {
+  for (auto _ : state) {
+  }
+}
+
+TEST(TimerOverheadTest, MeasuresEveryWayOfTiming) {
+  const auto& overheads = GetTimerOverhead();
+  ASSERT_EQ(overheads.size(), 3u);
+  for (const char* timing :
+       {"thread_cpu_time", "process_cpu_time", "cycle_clock"}) {
+    ASSERT_EQ(overheads.count(timing), 1u) << timing;
+    const BenchmarkReporter::TimerOverhead& overhead = overheads.at(timing);
+    EXPECT_GT(overhead.real_time_per_iteration, 0.0) << timing;
+    EXPECT_LT(overhead.real_time_per_iteration, 1e-6) << timing;
+    EXPECT_GE(overhead.cpu_time_per_iteration, 0.0) << timing;
+    EXPECT_GE(overhead.real_time_per_pause, 0.0) << timing;
+    EXPECT_GE(overhead.cpu_time_per_pause, 0.0) << timing;
+  }
+  // Measured only once.
+  EXPECT_EQ(&GetTimerOverhead(), &overheads);
+}
+
+TEST(TimerOverheadTest, SubtractsTheOverheadOfTheWayOfTiming) {
+  FunctionBenchmark thread_cpu_time("BM_Nothing", BM_Nothing);
+  FunctionBenchmark cycle_clock("BM_Nothing", BM_Nothing);
+  cycle_clock.UseCycleClock();
+  for (Benchmark* benchmark : {static_cast<Benchmark*>(&thread_cpu_time),
+                               static_cast<Benchmark*>(&cycle_clock)}) {
+    benchmark->Args({});
+    const BenchmarkInstance instance(benchmark, 0, 0, 0, 1);
+    const BenchmarkReporter::TimerOverhead& overhead =
+        GetTimerOverhead().at(instance.use_cycle_clock() ? "cycle_clock"
+                                                         : "thread_cpu_time");
+    double real_time = 1.0;
+    double cpu_time = 2.0;
+    SubtractTimerOverhead(instance, 1000, 3, &real_time, &cpu_time);
+    EXPECT_NEAR(real_time,
+                1.0 - 1000 * overhead.real_time_per_iteration -
+                    3 * overhead.real_time_per_pause,
+                1e-12);
+    EXPECT_NEAR(cpu_time,
+                2.0 - 1000 * overhead.cpu_time_per_iteration -
+                    3 * overhead.cpu_time_per_pause,
+                1e-12);
+
+    // Times never become negative.
+    real_time = 0.0;
+    cpu_time = 1e-12;
+    SubtractTimerOverhead(instance, 1000000, 1, &real_time, &cpu_time);
+    EXPECT_GE(real_time, 0.0);
+    EXPECT_LE(real_time, 0.0);
+    EXPECT_GE(cpu_time, 0.0);
+    EXPECT_LE(cpu_time, 0.0);
+  }
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace benchmark
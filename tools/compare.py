@@ -37,15 +37,15 @@ def check_inputs(in1, in2, flags):
             )
             % output_file
         )
-    if in1_kind == util.IT_JSON and in2_kind == util.IT_JSON:
-        # When both sides are JSON the only supported flag is
-        # --benchmark_filter=
+    if in1_kind != util.IT_Executable and in2_kind != util.IT_Executable:
+        # When both sides are JSON or columnar output the only supported flag
+        # is --benchmark_filter=
         for flag in util.remove_benchmark_flags("--benchmark_filter=", flags):
             print(
                 "WARNING: passing %s has no effect since both "
-                "inputs are JSON" % flag
+                "inputs are benchmark output" % flag
             )
-    if output_type is not None and output_type != "json":
+    if output_type is not None and output_type not in ("json", "columnar"):
         print(
             (
                 "ERROR: passing '--benchmark_out_format=%s' to 'compare.py`"
@@ -139,7 +139,7 @@ def create_parser():
         metavar="test_baseline",
         type=argparse.FileType("r"),
         nargs=1,
-        help="A benchmark executable or JSON output file",
+        help="A benchmark executable or JSON or columnar output file",
     )
     contender = parser_a.add_argument_group(
         "contender", "The benchmark that will be compared against the baseline"
@@ -149,7 +149,7 @@ def create_parser():
         metavar="test_contender",
         type=argparse.FileType("r"),
         nargs=1,
-        help="A benchmark executable or JSON output file",
+        help="A benchmark executable or JSON or columnar output file",
     )
     parser_a.add_argument(
         "benchmark_options",
@@ -167,7 +167,7 @@ def create_parser():
         metavar="test",
         type=argparse.FileType("r"),
         nargs=1,
-        help="A benchmark executable or JSON output file",
+        help="A benchmark executable or JSON or columnar output file",
     )
     baseline.add_argument(
         "filter_baseline",
@@ -206,7 +206,7 @@ def create_parser():
         metavar="test_baseline",
         type=argparse.FileType("r"),
         nargs=1,
-        help="A benchmark executable or JSON output file",
+        help="A benchmark executable or JSON or columnar output file",
     )
     baseline.add_argument(
         "filter_baseline",
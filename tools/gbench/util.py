@@ -2,9 +2,11 @@
 benchmarks
 """
 
+import array
 import json
 import os
 import re
+import struct
 import subprocess
 import sys
 import tempfile
@@ -13,9 +15,20 @@ import tempfile
 IT_Invalid = 0
 IT_JSON = 1
 IT_Executable = 2
+IT_Columnar = 3
 
 _num_magic_bytes = 2 if sys.platform.startswith("win") else 4
 
+_columnar_magic = b"GBCOLUMN"
+_columnar_version = 1
+# The array typecode and size in bytes of each column type.
+_columnar_types = {
+    b"i": ("q", 8),
+    b"f": ("d", 8),
+    b"b": ("B", 1),
+    b"s": ("I", 4),
+}
+
 
 def is_executable_file(filename):
     """
@@ -56,6 +69,87 @@ def is_json_file(filename):
     return False
 
 
+def is_columnar_file(filename):
+    """
+    Returns 'True' if 'filename' names a file written with
+    '--benchmark_out_format=columnar'. 'False' otherwise.
+    """
+    with open(filename, mode="rb") as f:
+        return f.read(len(_columnar_magic)) == _columnar_magic
+
+
+def load_columnar_results(fname):
+    """
+    Read a file written with '--benchmark_out_format=columnar' and return the
+    same object as loading the JSON output would. See
+    src/columnar_reporter.cc for the layout.
+    """
+    with open(fname, mode="rb") as f:
+        data = f.read()
+
+    pos = len(_columnar_magic)
+
+    def read_u32():
+        nonlocal pos
+        (value,) = struct.unpack_from("<I", data, pos)
+        pos += 4
+        return value
+
+    def read_bytes(size):
+        nonlocal pos
+        if pos + size > len(data):
+            raise ValueError("'%s' is truncated" % fname)
+        value = data[pos : pos + size]
+        pos += size
+        return value
+
+    def read_string():
+        return read_bytes(read_u32()).decode("utf-8")
+
+    version = read_u32()
+    if version != _columnar_version:
+        raise ValueError(
+            "'%s' has unsupported columnar version %d" % (fname, version)
+        )
+    results = {"context": json.loads(read_string()), "benchmarks": []}
+    dictionary = []
+    while True:
+        tag = read_bytes(1)
+        if tag == b"E":
+            break
+        if tag == b"D":
+            dictionary.extend(read_string() for _ in range(read_u32()))
+            continue
+        if tag != b"B":
+            raise ValueError("'%s' has an unknown chunk %r" % (fname, tag))
+        num_rows = read_u32()
+        num_columns = read_u32()
+        rows = [{} for _ in range(num_rows)]
+        for _ in range(num_columns):
+            name = read_string()
+            column_type = read_bytes(1)
+            if column_type not in _columnar_types:
+                raise ValueError(
+                    "'%s' has an unknown column type %r" % (fname, column_type)
+                )
+            typecode, width = _columnar_types[column_type]
+            validity = read_bytes((num_rows + 7) // 8)
+            values = array.array(typecode)
+            assert values.itemsize == width
+            values.frombytes(read_bytes(num_rows * width))
+            if sys.byteorder != "little":
+                values.byteswap()
+            if column_type == b"s":
+                values = [dictionary[v] for v in values]
+            elif column_type == b"b":
+                values = [v != 0 for v in values]
+            for i, value in enumerate(values):
+                if validity[i >> 3] & (1 << (i & 7)):
+                    rows[i][name] = value
+        results["benchmarks"].extend(rows)
+    return results
+
+
 def classify_input_file(filename):
     """
     Return a tuple (type, msg) where 'type' specifies the classified type
@@ -70,12 +164,14 @@ def classify_input_file(filename):
         err_msg = "'%s' does not name a file" % filename
     elif is_executable_file(filename):
         ftype = IT_Executable
+    elif is_columnar_file(filename):
+        ftype = IT_Columnar
     elif is_json_file(filename):
         ftype = IT_JSON
     else:
         err_msg = (
-            "'%s' does not name a valid benchmark executable or JSON file"
-            % filename
+            "'%s' does not name a valid benchmark executable, JSON or"
+            " columnar file" % filename
         )
     return ftype, err_msg
 
@@ -120,7 +216,8 @@ def remove_benchmark_flags(prefix, benchmark_flags):
 
 def load_benchmark_results(fname, benchmark_filter):
     """
-    Read benchmark output from a file and return the JSON object.
+    Read benchmark output from a JSON or columnar file and return the JSON
+    object.
 
     Apply benchmark_filter, a regular expression, with nearly the same
     semantics of the --benchmark_filter argument.  May be None.
@@ -128,7 +225,8 @@ def load_benchmark_results(fname, benchmark_filter):
     one used by the C++ code, which may produce different results
     in complex cases.
 
-    REQUIRES: 'fname' names a file containing JSON benchmark output.
+    REQUIRES: 'fname' names a file containing JSON or columnar benchmark
+    output.
     """
 
     def benchmark_wanted(benchmark):
@@ -137,21 +235,24 @@ def load_benchmark_results(fname, benchmark_filter):
         name = benchmark.get("run_name", None) or benchmark["name"]
         return re.search(benchmark_filter, name) is not None
 
-    with open(fname) as f:
-        results = json.load(f)
-        if "json_schema_version" in results.get("context", {}):
-            json_schema_version = results["context"]["json_schema_version"]
-            if json_schema_version != 1:
-                print(
-                    f"In {fname}, got unsupported JSON schema version:"
-                    f" {json_schema_version}, expected 1"
-                )
-                sys.exit(1)
-        if "benchmarks" in results:
-            results["benchmarks"] = list(
-                filter(benchmark_wanted, results["benchmarks"])
+    if is_columnar_file(fname):
+        results = load_columnar_results(fname)
+    else:
+        with open(fname) as f:
+            results = json.load(f)
+    if "json_schema_version" in results.get("context", {}):
+        json_schema_version = results["context"]["json_schema_version"]
+        if json_schema_version != 1:
+            print(
+                f"In {fname}, got unsupported JSON schema version:"
+                f" {json_schema_version}, expected 1"
             )
-        return results
+            sys.exit(1)
+    if "benchmarks" in results:
+        results["benchmarks"] = list(
+            filter(benchmark_wanted, results["benchmarks"])
+        )
+    return results
 
 
 def sort_benchmark_results(result):
@@ -215,11 +316,11 @@ def run_or_load_benchmark(filename, benchmark_flags):
     """
     Get the results for a specified benchmark. If 'filename' specifies
     an executable benchmark then the results are generated by running the
-    benchmark. Otherwise 'filename' must name a valid JSON output file,
-    which is loaded and the result returned.
+    benchmark. Otherwise 'filename' must name a valid JSON or columnar output
+    file, which is loaded and the result returned.
     """
     ftype = check_input_file(filename)
-    if ftype == IT_JSON:
+    if ftype in (IT_JSON, IT_Columnar):
         benchmark_filter = find_benchmark_flag(
             "--benchmark_filter=", benchmark_flags
         )